@@ -0,0 +1,267 @@
+/**
+ * @file aligned_memory.hpp
+ * @brief 境界を揃えたメモリの確保を定義するヘッダファイル．
+ */
+
+#ifndef FFT_ALIGNED_MEMORY_HPP_
+#define FFT_ALIGNED_MEMORY_HPP_
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/** 64ビット整数型 */
+using ll = long long int;
+
+/**
+ * キャッシュラインの境界に揃えたメモリを確保するクラス．
+ *
+ * 領域の先頭は kAlignment バイトの境界に揃う．kHugePageThreshold 以上の領域は
+ * mmap で kHugePageSize の倍数に切り上げ，kHugePageSize の境界に揃えて確保し，
+ * ヒュージページが有効であれば madvise(MADV_HUGEPAGE) でヒュージページの割り当てを指示する．
+ */
+class AlignedMemory {
+
+public:
+    /** 領域の先頭を揃える境界 (キャッシュラインの大きさ) */
+    static constexpr size_t kAlignment = 64;
+
+    /** ヒュージページの大きさ (2 MiB) */
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+    /**
+     * mmap で確保してヒュージページを用いる領域の下限 (1 MiB)．
+     *
+     * 長さ 2^17 の ll の配列のような 1 MiB 程度の領域も 1 枚のヒュージページに収め，
+     * TLB ミスを減らす．切り上げで増える領域は 1 枚あたり 1 MiB 未満である．
+     */
+    static constexpr size_t kHugePageThreshold = 1024 * 1024;
+
+    /**
+     * 境界を揃えた領域を確保する．
+     *
+     * @param[in] bytes バイト数
+     * @return void* 確保した領域
+     * @throw std::bad_alloc 確保できない場合
+     */
+    static void *Allocate(size_t bytes);
+
+    /**
+     * Allocate で確保した領域を解放する．
+     *
+     * @param[in] p 領域 (nullptr の場合は何もしない)
+     * @param[in] bytes 確保したときのバイト数
+     */
+    static void Deallocate(void *p, size_t bytes);
+
+    /**
+     * kHugePageThreshold 以上の領域にヒュージページを用いるかを設定する．
+     *
+     * 以降に確保する領域にのみ影響する．既定では有効である．
+     *
+     * @param[in] enabled ヒュージページを用いる場合 true
+     */
+    static void SetHugePages(bool enabled);
+
+    /**
+     * kHugePageThreshold 以上の領域にヒュージページを用いるかを返す．
+     *
+     * @return bool ヒュージページを用いる場合 true
+     */
+    static bool HugePages();
+};
+
+/**
+ * AlignedMemory で領域を確保する標準ライブラリ向けのアロケータ．
+ *
+ * @tparam T 要素の型
+ */
+template <typename T>
+class AlignedAllocator {
+
+public:
+    /** 要素の型 */
+    using value_type = T;
+
+    /** コンストラクタ． */
+    AlignedAllocator() = default;
+
+    /**
+     * 別の型のアロケータから構築する．
+     *
+     * @tparam U 要素の型
+     */
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    /**
+     * n 個の要素の領域を確保する．
+     *
+     * @param[in] n 要素数
+     * @return T* 確保した領域
+     */
+    T *allocate(size_t n) { return static_cast<T *>(AlignedMemory::Allocate(n * sizeof(T))); }
+
+    /**
+     * allocate で確保した領域を解放する．
+     *
+     * @param[in] p 領域
+     * @param[in] n 確保したときの要素数
+     */
+    void deallocate(T *p, size_t n) { AlignedMemory::Deallocate(p, n * sizeof(T)); }
+};
+
+/**
+ * アロケータが等しいかを返す．状態をもたないため常に等しい．
+ *
+ * @return bool true
+ */
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+
+/**
+ * アロケータが異なるかを返す．状態をもたないため常に等しい．
+ *
+ * @return bool false
+ */
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+/** 境界を揃えた領域に要素を置く可変長配列 */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * 一時的な配列を境界を揃えて切り出す，スレッドごとのアリーナ．
+ *
+ * kHugePageSize 単位のチャンクから先頭を順に切り出し，ArenaScope の終わりで
+ * まとめて返却する．チャンクは解放せずに再利用するため，同じ大きさの計算を
+ * 繰り返す場合は 2 回目以降にメモリ確保が発生しない．
+ * スレッド間で共有してはならない．
+ */
+class Arena {
+
+public:
+    /** 切り出した位置 */
+    struct Mark {
+        /** チャンクの番号 */
+        size_t chunk;
+
+        /** チャンクの先頭からのバイト数 */
+        size_t offset;
+    };
+
+    /** コンストラクタ． */
+    Arena() = default;
+
+    /** デストラクタ．すべてのチャンクを解放する． */
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * n 個の要素の配列を切り出す．
+     *
+     * 配列の要素は初期化されない．
+     *
+     * @tparam T 要素の型
+     * @param[in] n 要素数
+     * @return T* kAlignment バイトの境界に揃った配列
+     */
+    template <typename T>
+    T *Allocate(ll n) { return static_cast<T *>(AllocateBytes(n * sizeof(T))); }
+
+    /**
+     * 現在の切り出し位置を返す．
+     *
+     * @return Mark 切り出し位置
+     */
+    Mark Position() const { return { chunk_, offset_ }; }
+
+    /**
+     * mark より後に切り出した配列をまとめて返却する．
+     *
+     * @param[in] mark Position で得た切り出し位置
+     */
+    void Release(const Mark& mark) {
+        chunk_ = mark.chunk;
+        offset_ = mark.offset;
+    }
+
+    /**
+     * 確保しているチャンクの合計のバイト数を返す．
+     *
+     * @return size_t バイト数
+     */
+    size_t Capacity() const;
+
+    /**
+     * スレッドごとの既定のアリーナを返す．
+     *
+     * @return Arena& 呼び出したスレッドのアリーナ
+     */
+    static Arena& ThreadLocal();
+
+private:
+    /** 確保した領域 */
+    struct Chunk {
+        /** 領域の先頭 */
+        char *data;
+
+        /** バイト数 */
+        size_t bytes;
+    };
+
+    /**
+     * bytes バイトの領域を切り出す．
+     *
+     * @param[in] bytes バイト数
+     * @return void* kAlignment バイトの境界に揃った領域
+     */
+    void *AllocateBytes(size_t bytes);
+
+    /** 確保したチャンク */
+    std::vector<Chunk> chunks_;
+
+    /** 切り出し中のチャンクの番号 */
+    size_t chunk_ = 0;
+
+    /** 切り出し中のチャンクの先頭からのバイト数 */
+    size_t offset_ = 0;
+};
+
+/**
+ * 生存期間の間にアリーナから切り出した配列を，終わりでまとめて返却するクラス．
+ */
+class ArenaScope {
+
+public:
+    /**
+     * コンストラクタ．
+     *
+     * @param[in, out] arena アリーナ
+     */
+    explicit ArenaScope(Arena& arena) : arena_(arena), mark_(arena.Position()) {}
+
+    /** デストラクタ．切り出した配列を返却する． */
+    ~ArenaScope() { arena_.Release(mark_); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    /** アリーナ */
+    Arena& arena_;
+
+    /** 生存期間の始まりの切り出し位置 */
+    Arena::Mark mark_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_ALIGNED_MEMORY_HPP_
@@ -0,0 +1,120 @@
+/**
+ * @file bigint.hpp
+ * @brief 多倍長整数の乗算を行うクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_BIGINT_HPP_
+#define FFT_BIGINT_HPP_
+
+#include "include/ntt_crt.hpp"
+#include "include/thread_pool.hpp"
+#include <cstdint>
+#include <memory>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * 多倍長整数の乗算を行うクラス．
+ *
+ * 整数はリトルエンディアンの 32 ビットまたは 8 ビットのリムの配列で表す．
+ * 小さな整数は筆算，中程度の整数は Karatsuba 法で乗算し，
+ * 大きな整数は d ビットずつの桁に分けて NttCrt で畳み込み，桁上げして積を求める．
+ * 桁のビット数 d と変換の長さはオペランドの大きさから決める．
+ * a と b に同じ整数を渡した場合は 2 乗として変換を省く．
+ *
+ * 変換のテーブルを内部に保持して再利用するため，スレッド間で共有してはならない．
+ */
+class BigIntMultiplier {
+
+public:
+    /** 筆算から Karatsuba 法に切り替えるリム数の既定値 */
+    static constexpr ll kDefaultKaratsubaThreshold = 48;
+
+    /** Karatsuba 法から NTT に切り替えるリム数の既定値 */
+    static constexpr ll kDefaultNttThreshold = 6144;
+
+    /** コンストラクタ． */
+    BigIntMultiplier();
+
+    /**
+     * 32 ビットのリムで表した整数の積を計算して返す．
+     *
+     * @param[in] a 整数 (リトルエンディアン)
+     * @param[in] len_a a のリム数
+     * @param[in] b 整数 (リトルエンディアン)
+     * @param[in] len_b b のリム数
+     * @param[out] c a と b の積 (len_a + len_b リム)．a, b と重なってはならない．
+     * @throw std::length_error 積が NTT で扱える大きさを超える場合
+     */
+    void Mult(const u32 *a, ll len_a, const u32 *b, ll len_b, u32 *c);
+
+    /**
+     * 8 ビットのリム (バイト列) で表した整数の積を計算して返す．
+     *
+     * @param[in] a 整数 (リトルエンディアン)
+     * @param[in] len_a a のバイト数
+     * @param[in] b 整数 (リトルエンディアン)
+     * @param[in] len_b b のバイト数
+     * @param[out] c a と b の積 (len_a + len_b バイト)．a, b と重なってはならない．
+     * @throw std::length_error 積が NTT で扱える大きさを超える場合
+     */
+    void Mult(const std::uint8_t *a, ll len_a, const std::uint8_t *b, ll len_b,
+              std::uint8_t *c);
+
+    /**
+     * アルゴリズムを切り替えるリム数を設定する．
+     *
+     * 分割の再帰が止まるよう，Karatsuba 法の閾値は 4 以上とする．
+     *
+     * @param[in] karatsuba 短い方のオペランドがこのリム数以上であれば Karatsuba 法を使う
+     * @param[in] ntt 短い方のオペランドがこのリム数以上であれば NTT を使う
+     * @throw std::invalid_argument karatsuba が 4 未満か ntt が 1 未満の場合
+     */
+    void SetThresholds(ll karatsuba, ll ntt);
+
+    /**
+     * NTT の素数ごとの畳み込みを並列に実行するためのスレッドプールを設定する．
+     *
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void SetThreadPool(ThreadPool *pool);
+
+private:
+    /**
+     * NTT による畳み込みで積を計算して返す．
+     *
+     * @param[in] a 整数
+     * @param[in] len_a a のリム数
+     * @param[in] b 整数
+     * @param[in] len_b b のリム数
+     * @param[out] c a と b の積 (len_a + len_b リム)
+     */
+    void MultNtt(const u32 *a, ll len_a, const u32 *b, ll len_b, u32 *c);
+
+    /**
+     * 次数が n 以上の NttCrt を返す．
+     *
+     * @param[in] n 必要な次数 (2 のべき乗)
+     * @return const NttCrt& 次数 n 以上の NttCrt
+     */
+    const NttCrt& Engine(ll n);
+
+    /** 筆算から Karatsuba 法に切り替えるリム数 */
+    ll karatsuba_threshold_;
+
+    /** Karatsuba 法から NTT に切り替えるリム数 */
+    ll ntt_threshold_;
+
+    /** 再利用する NttCrt */
+    std::unique_ptr<NttCrt> engine_;
+
+    /** 素数ごとの畳み込みを並列に実行するためのスレッドプール */
+    ThreadPool *pool_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_BIGINT_HPP_
@@ -0,0 +1,161 @@
+/**
+ * @file bit_reversal.hpp
+ * @brief ビット反転の並び替えを行うクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_BIT_REVERSAL_HPP_
+#define FFT_BIT_REVERSAL_HPP_
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/** 64ビット整数型 */
+using ll = long long int;
+
+/** 32ビット符号なし整数型 */
+using u32 = std::uint32_t;
+
+/**
+ * 長さ 2^log_m (log_m <= log_n) の数列をビット反転の順序に並び替えるクラス．
+ *
+ * log_n の半分のビット数のビット反転のテーブルを保持し，インデックスの
+ * 上位と下位を別々に引いて組み合わせる．短い数列にはテーブルの値を右シフトして用いる．
+ * 大きな数列ではインデックスを上位 q ビット，中位，下位 q ビットに分け，
+ * 2^q x 2^q のタイルを作業領域に集めて転置してから書き戻す (COBRA 法)．
+ * 読み書きがどちらもキャッシュラインの単位で連続するため，
+ * 要素ごとに離れた位置と交換する方法よりキャッシュミスが少ない．
+ */
+class BitReversal {
+
+public:
+    /** 並び替えの方法 */
+    enum class Method {
+        /** 反転したインデックスを 1 ずつ更新しながら交換する */
+        kIncremental,
+        /** テーブルを引いて交換する */
+        kTable,
+        /** タイルごとに転置する (スカラー演算) */
+        kBlocked,
+        /** タイルごとに転置する (実行環境で使える場合は AVX2 によるレジスタ内の転置) */
+        kBlockedSimd
+    };
+
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] log_n 扱う最大の数列の長さが 2 の何乗か (48 以下)
+     */
+    explicit BitReversal(ll log_n);
+
+    /**
+     * 扱う最大の数列の長さが 2 の何乗かを返す．
+     *
+     * @return ll 扱う最大の数列の長さが 2 の何乗か
+     */
+    ll LogN() const { return log_n_; }
+
+    /**
+     * 長さ 2^log_m の数列をビット反転で並び替えて返す．
+     *
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か (LogN() 以下)
+     * @param[in] method 並び替えの方法
+     */
+    void Reverse(ll *a, ll log_m, Method method = Method::kBlockedSimd) const;
+
+    /**
+     * 32 ビットで格納した長さ 2^log_m の数列をビット反転で並び替えて返す．
+     *
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か (LogN() 以下)
+     * @param[in] method 並び替えの方法
+     */
+    void Reverse(u32 *a, ll log_m, Method method = Method::kBlockedSimd) const;
+
+    /**
+     * テーブルを用いずに長さ n の数列をビット反転で並び替えて返す．
+     *
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] n 数列の長さ (2 のべき乗)
+     */
+    static void ReverseIncremental(ll *a, ll n);
+
+    /**
+     * テーブルを用いずに 32 ビットで格納した長さ n の数列をビット反転で並び替えて返す．
+     *
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] n 数列の長さ (2 のべき乗)
+     */
+    static void ReverseIncremental(u32 *a, ll n);
+
+private:
+    /**
+     * 長さ 2^log_m の数列をビット反転で並び替えて返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     * @param[in] method 並び替えの方法
+     */
+    template <typename T>
+    void ReverseImpl(T *a, ll log_m, Method method) const;
+
+    /**
+     * テーブルを引いて長さ 2^log_m の数列をビット反転で並び替えて返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     */
+    template <typename T>
+    void ReverseTable(T *a, ll log_m) const;
+
+    /**
+     * 2^q x 2^q のタイルごとに転置して長さ 2^log_m の数列をビット反転で並び替えて返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か (2q 以上)
+     * @param[in] q タイルの 1 辺の長さが 2 の何乗か
+     * @param[in] simd AVX2 で転置する場合 true
+     */
+    template <typename T>
+    void ReverseBlocked(T *a, ll log_m, ll q, bool simd) const;
+
+    /**
+     * i (bits ビット) のビットを反転した値を返す．
+     *
+     * @param[in] i 値 (2^bits 未満)
+     * @param[in] bits ビット数 (LogN() 以下)
+     * @return ll i のビットを反転した値
+     */
+    ll Rev(ll i, ll bits) const {
+        if (bits <= half_bits_) {
+            return static_cast<ll>(table_[i] >> (half_bits_ - bits));
+        }
+        ll low = i & ((1LL << half_bits_) - 1);
+        return (static_cast<ll>(table_[low]) << (bits - half_bits_)) |
+               Rev(i >> half_bits_, bits - half_bits_);
+    }
+
+    /** タイルの 1 辺の長さが 2 の何乗かの上限 (ll で 8 KiB のタイル) */
+    static constexpr ll kMaxLogTile = 5;
+
+    /** 扱う最大の数列の長さが 2 の何乗か */
+    ll log_n_;
+
+    /** テーブルのビット数 (log_n の半分の切り上げ) */
+    ll half_bits_;
+
+    /** half_bits ビットのビット反転のテーブル */
+    std::vector<u32> table_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_BIT_REVERSAL_HPP_
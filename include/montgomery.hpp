@@ -6,6 +6,8 @@
 #ifndef FFT_MONTGOMERY_HPP_
 #define FFT_MONTGOMERY_HPP_
 
+#include <cstdint>
+
 /*
  * Number theoretic transform 向け名前空間
  */
@@ -43,6 +45,14 @@ public:
      */
     ll Reduction(ll t) const;
 
+    /**
+     * モンゴメリ表現 (aR mod N) に変換して返す．
+     *
+     * @param [in] a 値
+     * @return ll a のモンゴメリ表現
+     */
+    ll ToMontgomery(ll a) const;
+
     /**
      * mod N で積を計算して返す．
      *
@@ -68,6 +78,27 @@ public:
      */
     ll N() const { return n_; }
 
+    /**
+     * R が 2 の何乗かを返す．
+     *
+     * @return ll R が 2 の何乗か
+     */
+    ll Log2R() const { return log2r_; }
+
+    /**
+     * mod N における R の 2 乗を返す．
+     *
+     * @return ll mod N における R の 2 乗
+     */
+    ll R2() const { return r2_; }
+
+    /**
+     * mod R で NN' = -1 を満たす N' を返す．
+     *
+     * @return ll mod R で NN' = -1 を満たす N'
+     */
+    ll Nn() const { return nn_; }
+
 private:
     /** モジュラス N */
     ll n_;
@@ -95,6 +126,100 @@ public:
     MontgomeryMod19529729R25() : Montgomery(19529729, 25) {}
 };
 
+/**
+ * R = 2^64 として 64 ビットのモジュラスに対するモンゴメリ乗算を行うためのクラス．
+ *
+ * 積とリダクションの中間値は 128 ビットで計算する．
+ * 剰余を [0, 2N) に留めた加減算ができるよう，N は 2^62 未満の奇数であるとする．
+ */
+class Montgomery64 {
+
+public:
+    /** 128ビット符号なし整数型 */
+    __extension__ typedef unsigned __int128 u128;
+
+    /**
+     * コンストラクタ．
+     *
+     * @param [in] n モジュラスN (3 以上 2^62 未満の奇数)
+     * @throw std::invalid_argument n が 3 以上 2^62 未満の奇数でない場合
+     */
+    explicit Montgomery64(ll n);
+
+    /**
+     * モンゴメリリダクション tR^-1 mod N を返す．
+     *
+     * @param [in] t リダクションを計算する値 (NR 未満)
+     * @return ll モンゴメリリダクション
+     */
+    ll Reduction(u128 t) const {
+        std::uint64_t m = static_cast<std::uint64_t>(t) * nn_;
+        std::uint64_t u = static_cast<std::uint64_t>((t + static_cast<u128>(m) * n_) >> 64);
+        return static_cast<ll>((u >= n_) ? u - n_ : u);
+    }
+
+    /**
+     * 積のモンゴメリリダクション abR^-1 mod N を返す．
+     *
+     * @param [in] a 値
+     * @param [in] b 値
+     * @return ll a と b の積のモンゴメリリダクション
+     */
+    ll MultReduction(ll a, ll b) const {
+        return Reduction(static_cast<u128>(a) * static_cast<std::uint64_t>(b));
+    }
+
+    /**
+     * モンゴメリ表現 (aR mod N) に変換して返す．
+     *
+     * @param [in] a 値
+     * @return ll a のモンゴメリ表現
+     */
+    ll ToMontgomery(ll a) const { return MultReduction(a, r2_); }
+
+    /**
+     * mod N で積を計算して返す．
+     *
+     * @param [in] a 値
+     * @param [in] b 値
+     * @return ll a と b の積
+     */
+    ll Mult(ll a, ll b) const { return MultReduction(MultReduction(a, b), r2_); }
+
+    /**
+     * mod N でべき乗を計算して返す．
+     *
+     * @param [in] a 基数
+     * @param [in] k 指数
+     * @return ll a の k 乗
+     */
+    ll Pow(ll a, ll k) const;
+
+    /**
+     * モジュラスを返す．
+     *
+     * @return ll モジュラス
+     */
+    ll N() const { return static_cast<ll>(n_); }
+
+    /**
+     * mod N における R の 2 乗を返す．
+     *
+     * @return ll mod N における R の 2 乗
+     */
+    ll R2() const { return static_cast<ll>(r2_); }
+
+private:
+    /** モジュラス N */
+    std::uint64_t n_;
+
+    /** mod R における NN' = -1 を満たす N' */
+    std::uint64_t nn_;
+
+    /** mod N における R の 2 乗 */
+    std::uint64_t r2_;
+};
+
 } // namespace ntt
 
 #endif // #ifndef FFT_MONTGOMERY_HPP_
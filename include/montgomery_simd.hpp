@@ -0,0 +1,226 @@
+/**
+ * @file montgomery_simd.hpp
+ * @brief SIMD 命令を使ったモンゴメリ乗算を実装するためのヘッダファイル．
+ */
+
+#ifndef FFT_MONTGOMERY_SIMD_HPP_
+#define FFT_MONTGOMERY_SIMD_HPP_
+
+#include "include/montgomery.hpp"
+#include <cstdint>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/** 32ビット符号なし整数型 */
+using u32 = std::uint32_t;
+
+/**
+ * SIMD 命令を使ってモンゴメリ乗算とバタフライ演算を行うためのクラス．
+ *
+ * 64 ビットの各レーンの下位 32 ビット同士の積 (vpmuludq) を用いるため，
+ * モジュラスと R は 2^31 未満でなければならない．
+ * 使用する命令セットは実行時に CPUID で判定し，AVX2 (4 レーン) と
+ * AVX-512 (8 レーン) のどちらも使えない場合はスカラー演算を用いる．
+ */
+class MontgomerySimd {
+
+public:
+    /** 命令セット */
+    enum class Isa {
+        /** スカラー演算 */
+        kScalar,
+        /** AVX2 */
+        kAvx2,
+        /** AVX-512 */
+        kAvx512
+    };
+
+    /**
+     * コンストラクタ．実行環境で使える最も幅の広い命令セットを選ぶ．
+     *
+     * @param [in] montgomery モンゴメリ乗算
+     */
+    explicit MontgomerySimd(const Montgomery& montgomery);
+
+    /**
+     * コンストラクタ．
+     *
+     * @param [in] montgomery モンゴメリ乗算
+     * @param [in] isa 命令セット (実行環境で使えるものに限る)
+     * @throw std::invalid_argument isa が実行環境で使えない場合
+     */
+    MontgomerySimd(const Montgomery& montgomery, Isa isa);
+
+    /**
+     * 実行環境で使える最も幅の広い命令セットを返す．
+     *
+     * @return Isa 命令セット
+     */
+    static Isa DetectIsa();
+
+    /**
+     * 命令セットが実行環境で使えるかを返す．
+     *
+     * @param [in] isa 命令セット
+     * @return bool 使える場合 true
+     */
+    static bool Supports(Isa isa);
+
+    /**
+     * 使用する命令セットを返す．
+     *
+     * @return Isa 命令セット
+     */
+    Isa GetIsa() const { return isa_; }
+
+    /**
+     * 1 命令で処理する要素数を返す．
+     *
+     * @return ll レーン数
+     */
+    ll Lanes() const;
+
+    /**
+     * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．
+     *
+     * (a, b) を (a + wb, a - wb) に置き換える．w はモンゴメリ表現，
+     * a と b は通常の表現で [0, N) の範囲にあるとする．
+     * r_end - r_begin が Lanes() で割り切れない場合はスカラー演算を用いる．
+     *
+     * @param [in, out] a 数列．変換後の数列を上書きして返す．
+     * @param [in] l 段
+     * @param [in] q_begin q の開始
+     * @param [in] q_end q の終了
+     * @param [in] r_begin r の開始
+     * @param [in] r_end r の終了
+     * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+     */
+    void ButterflyStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                        const ll *w) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段のバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+     *
+     * 要素は 64 ビットのレーンに拡張して計算し，32 ビットに戻して格納する．
+     *
+     * @param [in, out] a 数列．変換後の数列を上書きして返す．
+     * @param [in] l 段
+     * @param [in] q_begin q の開始
+     * @param [in] q_end q の終了
+     * @param [in] r_begin r の開始
+     * @param [in] r_end r の終了
+     * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+     */
+    void ButterflyStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                        const ll *w) const;
+
+    /**
+     * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．
+     *
+     * (a, b) を (a + b, (a - b) w) に置き換える．w はモンゴメリ表現，
+     * a と b は通常の表現で [0, N) の範囲にあるとする．
+     * r_end - r_begin が Lanes() で割り切れない場合はスカラー演算を用いる．
+     *
+     * @param [in, out] a 数列．変換後の数列を上書きして返す．
+     * @param [in] l 段
+     * @param [in] q_begin q の開始
+     * @param [in] q_end q の終了
+     * @param [in] r_begin r の開始
+     * @param [in] r_end r の終了
+     * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+     */
+    void ButterflyStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                           const ll *w) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param [in, out] a 数列．変換後の数列を上書きして返す．
+     * @param [in] l 段
+     * @param [in] q_begin q の開始
+     * @param [in] q_end q の終了
+     * @param [in] r_begin r の開始
+     * @param [in] r_end r の終了
+     * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+     */
+    void ButterflyStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                           const ll *w) const;
+
+    /**
+     * 数列の要素ごとの積を mod N で計算して返す．
+     *
+     * @param [in] a 数列
+     * @param [in] b 数列
+     * @param [out] c 数列 a と b の要素ごとの積
+     * @param [in] n 数列の長さ
+     */
+    void MultVec(const ll *a, const ll *b, ll *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列の要素ごとの積を mod N で計算して返す．
+     *
+     * @param [in] a 数列
+     * @param [in] b 数列
+     * @param [out] c 数列 a と b の要素ごとの積
+     * @param [in] n 数列の長さ
+     */
+    void MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const;
+
+    /**
+     * 数列の要素ごとの積のモンゴメリリダクションを計算して返す．
+     *
+     * a がモンゴメリ表現であれば，c は通常の表現での積となる．
+     *
+     * @param [in] a 数列
+     * @param [in] b 数列
+     * @param [out] c 数列 a と b の要素ごとの積のリダクション
+     * @param [in] n 数列の長さ
+     */
+    void ReductionVec(const ll *a, const ll *b, ll *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列の要素ごとの積のモンゴメリリダクションを計算して返す．
+     *
+     * @param [in] a 数列
+     * @param [in] b 数列
+     * @param [out] c 数列 a と b の要素ごとの積のリダクション
+     * @param [in] n 数列の長さ
+     */
+    void ReductionVec(const u32 *a, const u32 *b, u32 *c, ll n) const;
+
+    /**
+     * 数列の要素ごとの 2 乗のモンゴメリリダクションをその場で計算して返す．
+     *
+     * 各要素を 1 回だけ読み込むため，ReductionVec(a, a, a, n) よりメモリアクセスが少ない．
+     *
+     * @param [in, out] a 数列．要素ごとの 2 乗のリダクションを上書きして返す．
+     * @param [in] n 数列の長さ
+     */
+    void SquareReductionVec(ll *a, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列の要素ごとの 2 乗のモンゴメリリダクションをその場で計算して返す．
+     *
+     * @param [in, out] a 数列．要素ごとの 2 乗のリダクションを上書きして返す．
+     * @param [in] n 数列の長さ
+     */
+    void SquareReductionVec(u32 *a, ll n) const;
+
+private:
+    /** モンゴメリ乗算 */
+    Montgomery montgomery_;
+
+    /** 命令セット */
+    Isa isa_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_MONTGOMERY_SIMD_HPP_
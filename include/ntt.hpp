@@ -6,7 +6,15 @@
 #ifndef FFT_NTT_HPP_
 #define FFT_NTT_HPP_
 
+#include "include/aligned_memory.hpp"
+#include "include/bit_reversal.hpp"
 #include "include/montgomery.hpp"
+#include "include/montgomery_simd.hpp"
+#include "include/thread_pool.hpp"
+#include "include/workspace.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 /**
  * Number theoretic transform 向け名前空間
@@ -16,6 +24,91 @@ namespace ntt {
 /** 64ビット整数型 */
 using ll = long long int;
 
+/** 32ビット符号なし整数型 */
+using u32 = std::uint32_t;
+
+/**
+ * 離散フーリエ変換済みの数列 (スペクトル) を保持するクラス．
+ *
+ * Ntt::Prepare で作成し，Ntt::Mult で同じ数列との畳み込みを繰り返し計算する．
+ * 要素の表現 (モンゴメリ表現など) は作成した Ntt オブジェクトに依存する．
+ * 作成したときのモジュラスと要素の順序を保持し，Ntt::Mult は一致しなければ受け付けない．
+ */
+class Spectrum {
+
+public:
+    /** 要素の順序 */
+    enum class Order {
+        /** 自然な順序 */
+        kNatural,
+        /** ビット反転した順序 (周波数間引きの変換の出力) */
+        kBitReversed
+    };
+
+    /**
+     * 要素を返す．
+     *
+     * @return ll* 要素
+     */
+    ll *Data() { return data_.data(); }
+
+    /**
+     * 要素を返す．
+     *
+     * @return const ll* 要素
+     */
+    const ll *Data() const { return data_.data(); }
+
+    /**
+     * 要素数を返す．
+     *
+     * @return ll 要素数
+     */
+    ll Size() const { return data_.size(); }
+
+    /**
+     * 要素数を変更する．
+     *
+     * @param[in] n 要素数
+     */
+    void Resize(ll n) { data_.resize(n); }
+
+    /**
+     * 作成したときのモジュラスを返す．
+     *
+     * @return ll モジュラス (作成していなければ 0)
+     */
+    ll Mod() const { return mod_; }
+
+    /**
+     * 要素の順序を返す．
+     *
+     * @return Order 要素の順序
+     */
+    Order Ordering() const { return order_; }
+
+    /**
+     * 作成したときのモジュラスと要素の順序を設定する．
+     *
+     * @param[in] mod モジュラス
+     * @param[in] order 要素の順序
+     */
+    void SetLayout(ll mod, Order order) {
+        mod_ = mod;
+        order_ = order;
+    }
+
+private:
+    /** 要素 */
+    AlignedVector<ll> data_;
+
+    /** 作成したときのモジュラス */
+    ll mod_ = 0;
+
+    /** 要素の順序 */
+    Order order_ = Order::kNatural;
+};
+
 /**
  * Number theoretic transform のための基本クラス．
  */
@@ -50,6 +143,24 @@ public:
      */
     virtual void Idft(ll *a) const = 0;
 
+    /**
+     * 32 ビットで格納した数列の離散フーリエ変換を計算して返す．
+     *
+     * 既定の実装は 64 ビットの作業領域に展開して変換する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Dft(u32 *a) const;
+
+    /**
+     * 32 ビットで格納した数列の逆離散フーリエ変換を計算して返す．
+     *
+     * 既定の実装は 64 ビットの作業領域に展開して変換する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Idft(u32 *a) const;
+
     /**
      * 数列をビット反転で並び替えて返す．
      *
@@ -57,15 +168,53 @@ public:
      */
     virtual void Reverse(ll *a) const;
 
+    /**
+     * 長さ n の数列をビット反転で並び替えて返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ (2 のべき乗)．
+     */
+    virtual void Reverse(ll *a, ll n) const;
+
+    /**
+     * 32 ビットで格納した長さ n の数列をビット反転で並び替えて返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ (2 のべき乗)．
+     */
+    virtual void Reverse(u32 *a, ll n) const;
+
     /**
      * 数列の要素ごとの積を計算して返す．
      *
+     * 既定では長さ N() を指定した MultVec に委譲する．
+     *
      * @param[in] a 数列．
      * @param[in] b 数列．
      * @param[out] c 数列 a と b の要素ごとの積．
      */
     virtual void MultVec(ll *a, ll *b, ll *c) const;
 
+    /**
+     * 長さ n の数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultVec(const ll *a, const ll *b, ll *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した長さ n の数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const;
+
     /**
      * 数列の畳み込みを計算して返す．
      *
@@ -74,6 +223,314 @@ public:
      * @param[out] c 数列 a と b の畳み込み．
      */
     virtual void Mult(ll *a, ll *b, ll *c) const;
+
+    /**
+     * 入力を変更せずに数列の畳み込みを計算して返す．
+     *
+     * c は a または b と同じ領域でもよい．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の畳み込み．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     */
+    virtual void Mult(const ll *a, const ll *b, ll *c, Workspace *work) const;
+
+    /**
+     * 32 ビットで格納した数列の畳み込みを入力を変更せずに計算して返す．
+     *
+     * 積などの中間値のみ 64 ビットで計算するため，モジュラスは 2^31 未満とする．
+     * c は a または b と同じ領域でもよい．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の畳み込み．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     */
+    virtual void Mult(const u32 *a, const u32 *b, u32 *c, Workspace *work) const;
+
+    /**
+     * 先頭 len_a, len_b 個の要素のみが非零である数列の畳み込みを計算して返す．
+     *
+     * 先頭 min(len_a + len_b - 1, N()) 個の要素を c に書き込む．
+     * len_a + len_b - 1 が N() を超える場合は次数 N() の巡回畳み込みとなる．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[in] b 数列 (長さ len_b)．
+     * @param[in] len_b 数列 b の長さ (N() 以下)．
+     * @param[out] c 数列 a と b の畳み込み．
+     * @throw std::invalid_argument len_a または len_b が N() を超える場合
+     */
+    void Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c) const {
+        Mult(a, len_a, b, len_b, c, nullptr);
+    }
+
+    /**
+     * 先頭 len_a, len_b 個の要素のみが非零である数列の畳み込みを計算して返す．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[in] b 数列 (長さ len_b)．
+     * @param[in] len_b 数列 b の長さ (N() 以下)．
+     * @param[out] c 数列 a と b の畳み込み．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     */
+    virtual void Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c,
+                      Workspace *work) const;
+
+    /**
+     * 数列の 2 乗 (自身との畳み込み) を計算して返す．
+     *
+     * 離散フーリエ変換を 1 回だけ行い，要素ごとに 2 乗して逆変換する．
+     * c は a と同じ領域でもよい．
+     *
+     * @param[in] a 数列．
+     * @param[out] c 数列 a と a の畳み込み．
+     */
+    virtual void Square(const ll *a, ll *c) const;
+
+    /**
+     * 32 ビットで格納した数列の 2 乗を計算して返す．
+     *
+     * c は a と同じ領域でもよい．
+     *
+     * @param[in] a 数列．
+     * @param[out] c 数列 a と a の畳み込み．
+     */
+    virtual void Square(const u32 *a, u32 *c) const;
+
+    /**
+     * 先頭 len_a 個の要素のみが非零である数列の 2 乗を計算して返す．
+     *
+     * 先頭 min(2 len_a - 1, N()) 個の要素を c に書き込む．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[out] c 数列 a と a の畳み込み．
+     * @throw std::invalid_argument len_a が N() を超える場合
+     */
+    void Square(const ll *a, ll len_a, ll *c) const {
+        Square(a, len_a, c, nullptr);
+    }
+
+    /**
+     * 先頭 len_a 個の要素のみが非零である数列の 2 乗を計算して返す．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[out] c 数列 a と a の畳み込み．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     */
+    virtual void Square(const ll *a, ll len_a, ll *c, Workspace *work) const;
+
+    /**
+     * 畳み込みで繰り返し用いる数列の離散フーリエ変換を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[out] spectrum 数列 a の離散フーリエ変換．
+     */
+    virtual void Prepare(const ll *a, Spectrum *spectrum) const;
+
+    /**
+     * 変換済みの数列と数列の畳み込みを計算して返す．
+     *
+     * 変換済みの数列の離散フーリエ変換は再計算しない．
+     * c は x と同じ領域でもよい．
+     *
+     * @param[in] spectrum Prepare で変換した数列．
+     * @param[in] x 数列．
+     * @param[out] c 数列 spectrum と x の畳み込み．
+     * @throw std::invalid_argument spectrum の要素数，モジュラス，要素の順序が
+     *                              この変換と異なる場合
+     */
+    virtual void Mult(const Spectrum& spectrum, const ll *x, ll *c) const;
+
+    /**
+     * Mult(spectrum, x, c) の前半として数列を変換する．
+     *
+     * 変換後の要素の順序と表現はクラスごとに異なり，MultTransformed にのみ渡せる．
+     * 2 つを続けて呼ぶと Mult(spectrum, x, c) と同じ結果となるため，
+     * 別の数列の変換と逆変換を並行して実行できる．c は x と同じ領域でもよい．
+     *
+     * @param[in] x 数列．
+     * @param[out] c 変換した数列．
+     */
+    void TransformInput(const ll *x, ll *c) const;
+
+    /**
+     * TransformInput で変換した数列と変換済みの数列の畳み込みを計算して返す．
+     *
+     * @param[in] spectrum Prepare で変換した数列．
+     * @param[in, out] c TransformInput で変換した数列．畳み込みを上書きして返す．
+     * @throw std::invalid_argument spectrum の要素数，モジュラス，要素の順序が
+     *                              この変換と異なる場合
+     */
+    void MultTransformed(const Spectrum& spectrum, ll *c) const;
+
+    /**
+     * 独立した複数の畳み込みを計算して返す．
+     *
+     * 各畳み込みは入力を変更しない Mult で計算し，スレッドプールの
+     * 空いているスレッドが順に取り出して実行する．回転因子のテーブルは
+     * すべての畳み込みで共有され，作業領域はスレッドごとに再利用される．
+     *
+     * @param[in] a 数列へのポインタの配列 (要素数 count)．
+     * @param[in] b 数列へのポインタの配列 (要素数 count)．
+     * @param[out] c 畳み込みを格納する数列へのポインタの配列 (要素数 count)．
+     * @param[in] count 畳み込みの数．
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void MultBatch(const ll *const *a, const ll *const *b, ll *const *c, ll count,
+                   ThreadPool *pool) const;
+
+    /**
+     * 一定の間隔で並んだ独立した複数の畳み込みを計算して返す．
+     *
+     * i 番目の数列は a + i * stride から始まる N() 個の要素である．
+     *
+     * @param[in] a 数列を並べた領域．
+     * @param[in] b 数列を並べた領域．
+     * @param[out] c 畳み込みを格納する領域．
+     * @param[in] count 畳み込みの数．
+     * @param[in] stride 数列の間隔 (N() 以上)．
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     * @throw std::invalid_argument stride が N() 未満の場合
+     */
+    void MultBatch(const ll *a, const ll *b, ll *c, ll count, ll stride,
+                   ThreadPool *pool) const;
+
+protected:
+    /**
+     * 入力の長さが次数以下であることを確認する．
+     *
+     * @param[in] len_a 数列 a の長さ．
+     * @param[in] len_b 数列 b の長さ．
+     * @throw std::invalid_argument len_a または len_b が N() を超える場合
+     */
+    void CheckLength(ll len_a, ll len_b) const;
+
+    /**
+     * 離散フーリエ変換した数列をスペクトルとして保持する表現に変換する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void ToSpectrum(ll *a, ll n) const {
+        (void)a;
+        (void)n;
+    }
+
+    /**
+     * スペクトルと離散フーリエ変換した数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] s スペクトル．
+     * @param[in] x 数列．
+     * @param[out] c 数列 s と x の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultSpectrum(const ll *s, const ll *x, ll *c, ll n) const {
+        MultVec(s, x, c, n);
+    }
+
+    /**
+     * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの積を計算して返す．
+     *
+     * 結果は IdftPointwise で逆変換する前提で，定数倍された表現のままでもよい．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultPointwise(const ll *a, const ll *b, ll *c, ll n) const {
+        MultVec(a, b, c, n);
+    }
+
+    /**
+     * 32 ビットで格納した数列に対して，畳み込みの途中の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultPointwise(const u32 *a, const u32 *b, u32 *c, ll n) const {
+        MultVec(a, b, c, n);
+    }
+
+    /**
+     * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの 2 乗をその場で計算して返す．
+     *
+     * 結果の扱いは MultPointwise(a, a, a, n) と同じである．
+     *
+     * @param[in, out] a 数列．要素ごとの 2 乗を上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void SquarePointwise(ll *a, ll n) const { MultPointwise(a, a, a, n); }
+
+    /**
+     * 32 ビットで格納した数列に対して，畳み込みの途中の要素ごとの 2 乗をその場で計算して返す．
+     *
+     * @param[in, out] a 数列．要素ごとの 2 乗を上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void SquarePointwise(u32 *a, ll n) const { MultPointwise(a, a, a, n); }
+
+    /**
+     * 畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * 要素の順序は MultPointwise の後に IdftPointwise で，MultSpectrum の後に
+     * IdftSpectrum で戻せるものであればよく，自然な順序である必要はない．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void DftPointwise(ll *a) const { Dft(a); }
+
+    /**
+     * 32 ビットで格納した数列に対して，畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void DftPointwise(u32 *a) const { Dft(a); }
+
+    /**
+     * MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftPointwise(ll *a) const { Idft(a); }
+
+    /**
+     * 32 ビットで格納した MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftPointwise(u32 *a) const { Idft(a); }
+
+    /**
+     * MultSpectrum の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftSpectrum(ll *a) const { Idft(a); }
+
+    /**
+     * DftPointwise の出力の要素の順序を返す．
+     *
+     * @return Spectrum::Order 要素の順序 (既定では自然な順序)
+     */
+    virtual Spectrum::Order SpectrumOrder() const { return Spectrum::Order::kNatural; }
+
+private:
+    /**
+     * 変換済みの数列がこの変換で作成したものと同じ形であることを確認する．
+     *
+     * @param[in] spectrum Prepare で変換した数列．
+     * @throw std::invalid_argument spectrum の要素数，モジュラス，要素の順序が
+     *                              この変換と異なる場合
+     */
+    void CheckSpectrum(const Spectrum& spectrum) const;
 };
 
 /**
@@ -93,6 +550,9 @@ public:
      */
     NttNaive(ll mod, ll omega, ll phi, ll n, ll n_inv);
 
+    using Ntt::Dft;
+    using Ntt::Idft;
+
     /**
      * 次数を返す．
      *
@@ -153,6 +613,28 @@ private:
 class NttBase : public Ntt {
 
 public:
+    /** 変換の各段を実行する順序 */
+    enum class Schedule {
+        /** 段ごとに数列全体を走査する (基数 2) */
+        kBreadthFirst,
+        /** キャッシュに収まるブロックごとに前半の段を済ませ，残りの段を 2 段ずつ (基数 4) 走査する */
+        kBlocked
+    };
+
+    /** 変換のスケジュールが数列全体を走査する回数と転送量の見積もり */
+    struct ScheduleReport {
+        /** 段数 */
+        ll stages;
+        /** キャッシュ内のブロックごとに実行する段数 */
+        ll blocked_stages;
+        /** 数列全体を走査する回数 */
+        ll passes;
+        /** 2 段のバタフライ演算を 1 回の走査で実行するか (kBlocked のみ) */
+        bool fused_pairs;
+        /** 主記憶との転送量 (読み込みと書き込み, バイト) */
+        ll bytes;
+    };
+
     /**
      * コンストラクタ．
      *
@@ -165,6 +647,10 @@ public:
      */
     NttBase(ll mod, ll omega, ll phi, ll n, ll n_inv, ll log_n);
 
+    using Ntt::Mult;
+    using Ntt::Reverse;
+    using Ntt::Square;
+
     /**
      * 次数を返す．
      *
@@ -194,76 +680,725 @@ public:
     virtual void Idft(ll *a) const;
 
     /**
-     * バタフライ演算を実行して結果を返す．
+     * 32 ビットで格納した数列の離散フーリエ変換を計算して返す．
      *
-     * @param[in, out] a 要素
-     * @param[in, out] b 要素
-     * @param[in] k 指数
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
      */
-    virtual void Butterfly(ll& a, ll& b, ll k) const;
+    virtual void Dft(u32 *a) const;
 
     /**
-     * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+     * 32 ビットで格納した数列の逆離散フーリエ変換を計算して返す．
      *
-     * @param[in, out] a 要素
-     * @param[in, out] b 要素
-     * @param[in] k 指数
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
      */
-    virtual void ButterflyInv(ll& a, ll& b, ll k) const;
+    virtual void Idft(u32 *a) const;
 
     /**
-     * べき乗を計算して返す．
+     * 長さ 2^log_m (log_m <= log_n) の数列の離散フーリエ変換を計算して返す．
      *
-     * @param[in] x 基数
-     * @param[in] k 指数
-     * @return ll x の k 乗
+     * 1 の 2^log_m 乗根として 1 の n 乗根の n / 2^log_m 乗を用いる．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
      */
-    virtual ll Pow(ll x, ll k) const;
+    void DftSized(ll *a, ll log_m) const;
 
     /**
-     * 1 の n 乗根のべき乗を計算して返す．
+     * 長さ 2^log_m (log_m <= log_n) の数列の逆離散フーリエ変換を計算して返す．
      *
-     * @param[in] k 指数
-     * @return ll 1 の n 乗根の k 乗
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
      */
-    virtual ll PowOmega(ll k) const = 0;
+    void IdftSized(ll *a, ll log_m) const;
 
     /**
-     * 1 の n 乗根の逆元のべき乗を計算して返す．
+     * 32 ビットで格納した長さ 2^log_m の数列の離散フーリエ変換を計算して返す．
      *
-     * @param[in] k 指数
-     * @return ll 1 の n 乗根の逆数の k 乗
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
      */
-    virtual ll PowPhi(ll k) const = 0;
+    void DftSized(u32 *a, ll log_m) const;
 
-protected:
-    /** モジュラス */
+    /**
+     * 32 ビットで格納した長さ 2^log_m の数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     */
+    void IdftSized(u32 *a, ll log_m) const;
+
+    /**
+     * 変換を並列に実行するためのスレッドプールを設定する．
+     *
+     * 前半の段は独立したブロックごとに，後半の段は r の範囲ごとに
+     * スレッドに分割する．スレッドプールはこのオブジェクトより長く
+     * 存在しなければならない．
+     *
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void SetThreadPool(ThreadPool *pool) { pool_ = pool; }
+
+    /**
+     * 変換の各段を実行する順序を設定する．
+     *
+     * kBlocked では長さ 2^log_block のブロックごとに第 1 段から第 log_block 段までを
+     * 実行し，残りの段は 2 段ずつまとめて実行する．
+     *
+     * @param[in] schedule 順序
+     * @param[in] log_block キャッシュに収まるブロックの長さが 2 の何乗か (1 以上)
+     */
+    void SetSchedule(Schedule schedule, ll log_block = kDefaultLogBlock) {
+        schedule_ = schedule;
+        log_block_ = std::max<ll>(log_block, 1);
+    }
+
+    /**
+     * 畳み込みでビット反転の並び替えを省くかどうかを設定する．
+     *
+     * true の場合，畳み込みの順変換は周波数間引き (自然な順序の入力,
+     * ビット反転した順序の出力)，逆変換は時間間引き (ビット反転した順序の入力,
+     * 自然な順序の出力) で行い，Reverse を呼ばない．Dft, Idft の結果は変わらない．
+     * 切り替える前に Prepare で作成した変換済みの数列は要素の順序が異なるため，
+     * Mult に渡すと例外が送出される．
+     *
+     * @param[in] enabled 並び替えを省く場合 true (既定値)
+     */
+    void SetBitReversalFree(bool enabled) { bit_reversal_free_ = enabled; }
+
+    /**
+     * ビット反転の並び替えの方法を設定する．
+     *
+     * @param[in] method 並び替えの方法 (既定値は BitReversal::Method::kBlockedSimd)
+     */
+    void SetReverseMethod(BitReversal::Method method) { reverse_method_ = method; }
+
+    /**
+     * 長さ n の数列をビット反転で並び替えて返す．
+     *
+     * SetReverseMethod で設定した方法で並び替える．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ (2 のべき乗，次数以下)．
+     */
+    void Reverse(ll *a, ll n) const override;
+
+    /**
+     * 32 ビットで格納した長さ n の数列をビット反転で並び替えて返す．
+     *
+     * SetReverseMethod で設定した方法で並び替える．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ (2 のべき乗，次数以下)．
+     */
+    void Reverse(u32 *a, ll n) const override;
+
+    /**
+     * 長さ 2^log_m の変換で数列全体を走査する回数と転送量の見積もりを返す．
+     *
+     * キャッシュに収まらない数列について，現在の順序で各走査が数列全体を
+     * 1 回ずつ読み書きするものとして見積もる．
+     * 2 段ずつの実行は FusesStagePair() が false のエンジンでは段ごとの走査として数える．
+     * 周波数間引きの変換 (TransformDif) も同じ回数となる．
+     *
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     * @param[in] element_size 要素のバイト数
+     * @return ScheduleReport 見積もり
+     */
+    ScheduleReport Report(ll log_m, ll element_size = sizeof(ll)) const;
+
+    /**
+     * 先頭 len_a, len_b 個の要素のみが非零である数列の畳み込みを計算して返す．
+     *
+     * 畳み込みが収まる最小の 2 のべき乗の長さで変換を行う．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[in] b 数列 (長さ len_b)．
+     * @param[in] len_b 数列 b の長さ (N() 以下)．
+     * @param[out] c 数列 a と b の畳み込み．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     */
+    virtual void Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c,
+                      Workspace *work) const;
+
+    /**
+     * 先頭 len_a 個の要素のみが非零である数列の 2 乗を計算して返す．
+     *
+     * 2 乗が収まる最小の 2 のべき乗の長さで変換を行う．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[out] c 数列 a と a の畳み込み．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     */
+    virtual void Square(const ll *a, ll len_a, ll *c, Workspace *work) const;
+
+    /**
+     * バタフライ演算を実行して結果を返す．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子
+     */
+    virtual void Butterfly(ll& a, ll& b, ll w) const;
+
+    /**
+     * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子
+     */
+    virtual void ButterflyInv(ll& a, ll& b, ll w) const;
+
+    /**
+     * 周波数間引きのバタフライ演算を実行して結果を返す．
+     *
+     * (a, b) を (a + b, (a - b) w) に置き換える．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子
+     */
+    virtual void ButterflyDif(ll& a, ll& b, ll w) const;
+
+    /**
+     * べき乗を計算して返す．
+     *
+     * @param[in] x 基数
+     * @param[in] k 指数
+     * @return ll x の k 乗
+     */
+    virtual ll Pow(ll x, ll k) const;
+
+    /**
+     * 1 の n 乗根のべき乗を計算して返す．
+     *
+     * @param[in] k 指数
+     * @return ll 1 の n 乗根の k 乗
+     */
+    virtual ll PowOmega(ll k) const;
+
+    /**
+     * 1 の n 乗根の逆元のべき乗を計算して返す．
+     *
+     * @param[in] k 指数
+     * @return ll 1 の n 乗根の逆数の k 乗
+     */
+    virtual ll PowPhi(ll k) const;
+
+protected:
+    /**
+     * 畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * SetBitReversalFree(true) の場合はビット反転した順序のまま返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void DftPointwise(ll *a) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void DftPointwise(u32 *a) const;
+
+    /**
+     * DftPointwise の出力の要素の順序を返す．
+     *
+     * @return Spectrum::Order SetBitReversalFree(true) の場合はビット反転した順序
+     */
+    virtual Spectrum::Order SpectrumOrder() const {
+        return bit_reversal_free_ ? Spectrum::Order::kBitReversed : Spectrum::Order::kNatural;
+    }
+
+    /**
+     * MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftPointwise(ll *a) const;
+
+    /**
+     * 32 ビットで格納した MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftPointwise(u32 *a) const;
+
+    /**
+     * MultSpectrum の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftSpectrum(ll *a) const;
+
+    /**
+     * MultPointwise の結果を通常の積に戻すために掛ける係数を返す．
+     *
+     * 逆変換のスケーリング n^-1 にまとめて掛けるため，追加の乗算は発生しない．
+     *
+     * @return ll MultPointwise の結果に掛ける係数
+     */
+    virtual ll PointwiseFactor() const { return 1; }
+
+    /**
+     * 数列の各要素にスカラーを掛けて返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
+     */
+    virtual void MultScalar(ll *a, ll m, ll s) const;
+
+    /**
+     * 32 ビットで格納した数列の各要素にスカラーを掛けて返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
+     */
+    virtual void MultScalar(u32 *a, ll m, ll s) const;
+
+    /**
+     * 長さ 2^log_m の数列に対して，畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     */
+    template <typename T>
+    void DftPointwiseSized(T *a, ll log_m) const;
+
+    /**
+     * 長さ 2^log_m の数列の逆変換を計算し，2^-log_m と factor を掛けて返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     * @param[in] factor 追加で掛ける係数
+     * @param[in] bit_reversed 入力がビット反転した順序であれば true (並び替えを省く)
+     */
+    template <typename T>
+    void IdftScaled(T *a, ll log_m, ll factor, bool bit_reversed = false) const;
+
+    /**
+     * 長さ 2^log_m の数列の変換の各段を実行する．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列 (ビット反転で並び替え済み)．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     * @param[in] inverse 逆変換の場合 true
+     */
+    template <typename T>
+    void Transform(T *a, ll log_m, bool inverse) const;
+
+    /**
+     * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段のバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
+
+    /**
+     * 長さ 2^log_m の数列の周波数間引きの変換を実行する．
+     *
+     * 自然な順序の数列を受け取り，ビット反転した順序の離散フーリエ変換を返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     */
+    template <typename T>
+    void TransformDif(T *a, ll log_m) const;
+
+    /**
+     * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
+
+    /**
+     * 第 l 段と第 l + 1 段のバタフライ演算を 1 回の走査で (基数 4 で) 実行する．
+     *
+     * q は長さ 2^(l+1) のブロック，r は 0 <= r < 2^(l-1) の範囲である．
+     * 各 (q, r) について 4 要素を読み込み，2 段分のバタフライ演算を行ってから書き戻す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段と第 l + 1 段のバタフライ演算を
+     * 1 回の走査で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
+
+    /**
+     * 第 l 段と第 l + 1 段のバタフライ演算を Butterfly, ButterflyInv で 1 回の走査で実行する．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     */
+    template <typename T>
+    void TransformStagePairGeneric(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                   bool inverse) const;
+
+    /**
+     * 長さ 2^log_m の数列の第 l_first 段から第 l_last 段までを 2 段ずつ実行する．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     * @param[in] l_first 最初の段
+     * @param[in] l_last 最後の段
+     * @param[in] inverse 逆変換の場合 true
+     */
+    template <typename T>
+    void TransformStagesRadix4(T *a, ll log_m, ll l_first, ll l_last, bool inverse) const;
+
+    /**
+     * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を 1 回の走査で (基数 4 で) 実行する．
+     *
+     * TransformStagePair と同じく q は長さ 2^(l+1) のブロック，r は 0 <= r < 2^(l-1) の
+     * 範囲であり，段は第 l + 1 段，第 l 段の順に実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l + 1 段と第 l 段の周波数間引きの
+     * バタフライ演算を 1 回の走査で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDifPair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
+
+    /**
+     * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を ButterflyDif で 1 回の走査で実行する．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     */
+    template <typename T>
+    void TransformStageDifPairGeneric(T *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                      ll r_end) const;
+
+    /**
+     * TransformStagePair と TransformStageDifPair が 2 段を 1 回の走査で実行するかを返す．
+     *
+     * 段ごとの実行に分ける派生クラスは false を返し，Report の走査回数に反映する．
+     *
+     * @return bool 1 回の走査で実行する場合 true (既定値)
+     */
+    virtual bool FusesStagePair() const { return true; }
+
+    /**
+     * 長さ 2^log_m の数列の周波数間引きの変換の第 l_last 段から第 l_first 段までを 2 段ずつ実行する．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] log_m 数列の長さが 2 の何乗か
+     * @param[in] l_first 最後に実行する段
+     * @param[in] l_last 最初に実行する段
+     */
+    template <typename T>
+    void TransformStagesDifRadix4(T *a, ll log_m, ll l_first, ll l_last) const;
+
+    /**
+     * 変換の各段を実行した後の数列を [0, mod) に正規化する．
+     *
+     * バタフライ演算で値を冗長な範囲に残す派生クラスが上書きする．既定では何もしない．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     */
+    virtual void Normalize(ll *a, ll m) const;
+
+    /**
+     * 32 ビットで格納した数列を [0, mod) に正規化する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     */
+    virtual void Normalize(u32 *a, ll m) const;
+
+    /**
+     * 回転因子のテーブルを作成する．
+     *
+     * 第 l 段 (1 <= l <= log_n) で用いる回転因子 (1 の 2^l 乗根の r 乗,
+     * 0 <= r < 2^(l-1)) を添字 2^(l-1) + r に格納する．
+     * 各段のバタフライ演算が連続した領域を参照するようにするためである．
+     */
+    void MakePowTables();
+
+    /** モジュラス */
     ll mod_;
 
     /** 1 の n 乗根 */
-    ll omega_;
+    ll omega_;
+
+    /** 1 の n 乗根の逆元 */
+    ll phi_;
+
+    /** 次数 */
+    ll n_;
+
+    /** 次数の逆元 */
+    ll n_inv_;
+
+    /** 次数が 2 の何乗か */
+    ll log_n_;
+
+    /** 1 の n 乗根のべき乗リスト (段ごとに連続した配置) */
+    AlignedVector<ll> omega_pows_;
+
+    /** 1 の n 乗根の逆数のべき乗リスト (段ごとに連続した配置) */
+    AlignedVector<ll> phi_pows_;
+
+    /** 変換を並列に実行するためのスレッドプール */
+    ThreadPool *pool_ = nullptr;
+
+    /** 並列に実行する最小の変換の長さが 2 の何乗か */
+    static constexpr ll kLogParallelMin = 12;
+
+    /** キャッシュに収まるブロックの長さが 2 の何乗かの既定値 (ll で 128 KiB) */
+    static constexpr ll kDefaultLogBlock = 14;
+
+    /** 変換の各段を実行する順序 */
+    Schedule schedule_ = Schedule::kBreadthFirst;
+
+    /** キャッシュに収まるブロックの長さが 2 の何乗か */
+    ll log_block_ = kDefaultLogBlock;
+
+    /** 畳み込みでビット反転の並び替えを省く場合 true */
+    bool bit_reversal_free_ = true;
+
+    /** 次数までのビット反転の並び替え */
+    BitReversal bit_reversal_;
+
+    /** ビット反転の並び替えの方法 */
+    BitReversal::Method reverse_method_ = BitReversal::Method::kBlockedSimd;
+};
+
+/**
+ * モジュラス 337, 次数 8 のNumber theoretic transform のためのクラス．
+ */
+class NttMod337Deg8 : public NttBase {
+
+public:
+    /** コンストラクタ */
+    NttMod337Deg8();
+
+private:
+    /** モジュラス */
+    static constexpr ll kMod = 337;
+
+    /** 1 の n 乗根 */
+    static constexpr ll kOmega = 85;
+
+    /** 1 の n 乗根の逆元 */
+    static constexpr ll kPhi = 226;
+
+    /** 次数 */
+    static constexpr ll kN = 8;
+
+    /** 次数の逆元 */
+    static constexpr ll kNInv = 295;
+
+    /** 次数が 2 の何乗か */
+    static constexpr ll kLogN = 3;
+};
+
+/**
+ * モジュラス 337, 次数 8 のNumber theoretic transform の素朴な実装のためのクラス．
+ */
+class NttNaiveMod337Deg8 : public NttNaive {
+
+public:
+    /** コンストラクタ */
+    NttNaiveMod337Deg8();
+
+private:
+    /** モジュラス */
+    static constexpr ll kMod = 337;
+
+    /** 1 の n 乗根 */
+    static constexpr ll kOmega = 85;
 
     /** 1 の n 乗根の逆元 */
-    ll phi_;
+    static constexpr ll kPhi = 226;
 
     /** 次数 */
-    ll n_;
+    static constexpr ll kN = 8;
 
     /** 次数の逆元 */
-    ll n_inv_;
+    static constexpr ll kNInv = 295;
+};
+
+/**
+ * モジュラス 19529729, 次数 131072 の Number theoretic transform のためのクラス．
+ */
+class NttMod19529729Deg131072 : public NttBase {
+
+public:
+    /* コンストラクタ */
+    NttMod19529729Deg131072();
+
+private:
+    /** モジュラス */
+    static constexpr ll kMod = 19529729;
+
+    /** 1 の n 乗根 */
+    static constexpr ll kOmega = 770;
+
+    /** 1 の n 乗根の逆元 */
+    static constexpr ll kPhi = 16765131;
+
+    /** 次数 */
+    static constexpr ll kN = 131072;
+
+    /** 次数の逆元 */
+    static constexpr ll kNInv = 19529580;
 
     /** 次数が 2 の何乗か */
-    ll log_n_;
+    static constexpr ll kLogN = 17;
 };
 
 /**
- * モジュラス 337, 次数 8 のNumber theoretic transform のためのクラス．
+ * モジュラス 19529729, 次数 131072 の Montgomery 乗算を使った
+ * Number theoretic transform のためのクラス．
+ *
+ * 回転因子のテーブルはモンゴメリ表現で保持する．
+ * バタフライ演算と要素ごとの積は，実行環境で使える SIMD 命令で計算する．
  */
-class NttMod337Deg8 : public NttBase {
+class NttMod19529729Deg131072M : public NttBase {
 
 public:
-    /** コンストラクタ */
-    NttMod337Deg8();
+    /* コンストラクタ */
+    NttMod19529729Deg131072M();
+
+    /**
+     * バタフライ演算を実行して結果を返す．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子
+     */
+    virtual void Butterfly(ll& a, ll& b, ll w) const;
+
+    /**
+     * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子
+     */
+    virtual void ButterflyInv(ll& a, ll& b, ll w) const;
+
+    /**
+     * 周波数間引きのバタフライ演算を実行して結果を返す．
+     *
+     * (a, b) を (a + b, (a - b) w) に置き換える．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子 (モンゴメリ表現)
+     */
+    virtual void ButterflyDif(ll& a, ll& b, ll w) const;
+
+    using Ntt::MultVec;
+
+    /**
+     * 長さ n の数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultVec(const ll *a, const ll *b, ll *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した長さ n の数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const;
 
     /**
      * 1 の n 乗根のべき乗を計算して返す．
@@ -281,139 +1416,645 @@ public:
      */
     virtual ll PowPhi(ll k) const;
 
+    /**
+     * 使用する SIMD 命令セットを設定する．
+     *
+     * @param[in] isa 命令セット (実行環境で使えるものに限る)
+     * @throw std::invalid_argument isa が実行環境で使えない場合
+     */
+    void SetSimdIsa(MontgomerySimd::Isa isa) { simd_ = MontgomerySimd(montgomery_, isa); }
+
+protected:
+    /**
+     * 数列の各要素にスカラーを掛けて返す．
+     *
+     * スカラーを一度だけモンゴメリ表現に変換し，各要素は 1 回のリダクションで計算する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
+     */
+    virtual void MultScalar(ll *a, ll m, ll s) const;
+
+    /**
+     * 32 ビットで格納した数列の各要素にスカラーを掛けて返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
+     */
+    virtual void MultScalar(u32 *a, ll m, ll s) const;
+
+    /**
+     * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの積を計算して返す．
+     *
+     * リダクションを 1 回だけ行い，abR^-1 を返す．R 倍は逆変換のスケーリングで補正する．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積に R^-1 を掛けたもの．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultPointwise(const ll *a, const ll *b, ll *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，畳み込みの途中の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積に R^-1 を掛けたもの．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultPointwise(const u32 *a, const u32 *b, u32 *c, ll n) const;
+
+    /**
+     * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの 2 乗を
+     * モンゴメリ乗算で計算して返す．
+     *
+     * @param[in, out] a 数列．要素ごとの 2 乗に R^-1 を掛けたものを上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void SquarePointwise(ll *a, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，畳み込みの途中の要素ごとの 2 乗を
+     * モンゴメリ乗算で計算して返す．
+     *
+     * @param[in, out] a 数列．要素ごとの 2 乗に R^-1 を掛けたものを上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void SquarePointwise(u32 *a, ll n) const;
+
+    /**
+     * MultPointwise の結果を通常の積に戻すために掛ける係数 R mod N を返す．
+     *
+     * @return ll R mod N
+     */
+    virtual ll PointwiseFactor() const;
+
+    /**
+     * 離散フーリエ変換した数列をモンゴメリ表現のスペクトルに変換する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void ToSpectrum(ll *a, ll n) const;
+
+    /**
+     * モンゴメリ表現のスペクトルと数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] s スペクトル (モンゴメリ表現)．
+     * @param[in] x 数列．
+     * @param[out] c 数列 s と x の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultSpectrum(const ll *s, const ll *x, ll *c, ll n) const;
+
+    /**
+     * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段のバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
+
+    /**
+     * 第 l 段と第 l + 1 段のバタフライ演算を SIMD 命令の段ごとの実行で順に行う．
+     *
+     * 2 段分をまとめたベクトル化は行わず，ブロック単位の実行によるキャッシュの局所性のみを得る．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段と第 l + 1 段のバタフライ演算を
+     * SIMD 命令の段ごとの実行で順に行う．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
+
+    /**
+     * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
+
+    /**
+     * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を SIMD 命令の段ごとの実行で順に行う．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
+
+    /**
+     * 32 ビットで格納した数列に対して，第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を
+     * SIMD 命令の段ごとの実行で順に行う．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDifPair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
+
+    /**
+     * 2 段の組を SIMD 命令の段ごとの実行に分けるため false を返す．
+     *
+     * @return bool false
+     */
+    virtual bool FusesStagePair() const { return false; }
+
 private:
     /** モジュラス */
-    static constexpr ll kMod = 337;
+    static constexpr ll kMod = 19529729;
 
     /** 1 の n 乗根 */
-    static constexpr ll kOmega = 85;
+    static constexpr ll kOmega = 770;
 
     /** 1 の n 乗根の逆元 */
-    static constexpr ll kPhi = 226;
+    static constexpr ll kPhi = 16765131;
 
     /** 次数 */
-    static constexpr ll kN = 8;
+    static constexpr ll kN = 131072;
 
     /** 次数の逆元 */
-    static constexpr ll kNInv = 295;
+    static constexpr ll kNInv = 19529580;
+
+    /** 次数が 2 の何乗か */
+    static constexpr ll kLogN = 17;
+
+    /** モンゴメリ乗算 */
+    MontgomeryMod19529729R25 montgomery_;
+
+    /** SIMD 命令を使ったモンゴメリ乗算 */
+    MontgomerySimd simd_;
+};
+
+/**
+ * モジュラス 19529729, 次数 131072 のNumber theoretic transform の素朴な実装のためのクラス．
+ */
+class NttNaiveMod19529729Deg131072 : public NttNaive {
+
+public:
+    /* コンストラクタ */
+    NttNaiveMod19529729Deg131072();
+
+private:
+    /** モジュラス */
+    static constexpr ll kMod = 19529729;
+
+    /** 1 の n 乗根 */
+    static constexpr ll kOmega = 770;
+
+    /** 1 の n 乗根の逆元 */
+    static constexpr ll kPhi = 16765131;
+
+    /** 次数 */
+    static constexpr ll kN = 131072;
+
+    /** 次数の逆元 */
+    static constexpr ll kNInv = 19529580;
+
+    /** 次数が 2 の何乗か */
+    static constexpr ll kLogN = 17;
+};
+
+/**
+ * 任意のモジュラスと次数に対する Number theoretic transform のためのクラス．
+ *
+ * モジュラス p = c 2^k + 1 (素数) と次数 n (2 のべき乗で 2^k 以下) から，
+ * 原始根を探して 1 の n 乗根とその逆元，次数の逆元を求める．
+ * 積が ll に収まるよう，p は 2^31 未満であるとする．
+ */
+class NttGeneric : public NttBase {
+
+public:
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス．
+     * @param[in] n 次数．
+     * @throw std::invalid_argument mod が 2^31 未満の素数でないか，
+     *                              n が 2 以上の 2 のべき乗でないか，
+     *                              mod - 1 が n で割り切れない場合
+     */
+    NttGeneric(ll mod, ll n);
 
-    /** 次数が 2 の何乗か */
-    static constexpr ll kLogN = 3;
+protected:
+    /**
+     * コンストラクタ．
+     *
+     * モジュラスを確認しないため，派生クラスが扱える範囲を確認してから呼び出す．
+     *
+     * @param[in] mod モジュラス．
+     * @param[in] n 次数．
+     * @param[in] omega 1 の n 乗根．
+     */
+    NttGeneric(ll mod, ll n, ll omega);
 
-    /** 1 の n 乗根のべき乗リスト */
-    ll omega_pows_[kN];
+    /**
+     * 1 の n 乗根を求めて返す．
+     *
+     * @param[in] mod モジュラス．
+     * @param[in] n 次数．
+     * @return ll 1 の n 乗根
+     * @throw std::invalid_argument n が 2 以上の 2 のべき乗でないか，
+     *                              mod - 1 が n で割り切れない場合
+     */
+    static ll ComputeOmega(ll mod, ll n);
 
-    /** 1 の n 乗根の逆数のべき乗リスト */
-    ll phi_pows_[kN];
+private:
+    /**
+     * モジュラスが積を ll で扱える素数であることを確認して返す．
+     *
+     * @param[in] mod モジュラス．
+     * @return ll モジュラス
+     * @throw std::invalid_argument mod が 2^31 未満の素数でない場合
+     */
+    static ll CheckMod(ll mod);
 };
 
 /**
- * モジュラス 337, 次数 8 のNumber theoretic transform の素朴な実装のためのクラス．
+ * 遅延リダクション (Harvey のバタフライ演算) を用いた Number theoretic transform のためのクラス．
+ *
+ * 回転因子 w ごとに Shoup の商 floor(w 2^32 / p) を前計算し，
+ * 剰余演算を使わずに w b mod p を [0, 2p) の範囲で求める．
+ * 変換の途中の値は [0, 4p) に留め，順変換の最後と逆変換のスケーリングで
+ * 一度だけ [0, p) に正規化する．4p が 32 ビットに収まるよう，p は 2^30 未満であるとする．
+ * 既定では Schedule::kBlocked の順序で変換する．
  */
-class NttNaiveMod337Deg8 : public NttNaive {
+class NttHarvey : public NttGeneric {
 
 public:
-    /** コンストラクタ */
-    NttNaiveMod337Deg8();
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス．
+     * @param[in] n 次数．
+     * @throw std::invalid_argument mod が 2^30 以上であるか，
+     *                              n が 2 以上の 2 のべき乗でないか，
+     *                              mod - 1 が n で割り切れない場合
+     */
+    NttHarvey(ll mod, ll n);
 
-private:
-    /** モジュラス */
-    static constexpr ll kMod = 337;
+protected:
+    /**
+     * 数列の各要素にスカラーを掛けて [0, mod) に正規化して返す．
+     *
+     * @param[in, out] a 数列 (各要素は [0, 4 mod))．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
+     */
+    virtual void MultScalar(ll *a, ll m, ll s) const;
 
-    /** 1 の n 乗根 */
-    static constexpr ll kOmega = 85;
+    /**
+     * 32 ビットで格納した数列の各要素にスカラーを掛けて [0, mod) に正規化して返す．
+     *
+     * @param[in, out] a 数列 (各要素は [0, 4 mod))．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
+     */
+    virtual void MultScalar(u32 *a, ll m, ll s) const;
 
-    /** 1 の n 乗根の逆元 */
-    static constexpr ll kPhi = 226;
+    /**
+     * 第 l 段の遅延リダクションのバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．入出力の各要素は [0, 4 mod) である．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
 
-    /** 次数 */
-    static constexpr ll kN = 8;
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段の遅延リダクションのバタフライ演算のうち
+     * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
 
-    /** 次数の逆元 */
-    static constexpr ll kNInv = 295;
-};
+    /**
+     * 第 l 段と第 l + 1 段の遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
 
-/**
- * モジュラス 19529729, 次数 131072 の Number theoretic transform のためのクラス．
- */
-class NttMod19529729Deg131072 : public NttBase {
+    /**
+     * 32 ビットで格納した数列に対して，第 l 段と第 l + 1 段の遅延リダクションの
+     * バタフライ演算を 1 回の走査で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
 
-public:
-    /* コンストラクタ */
-    NttMod19529729Deg131072();
+    /**
+     * 第 l 段の周波数間引きのバタフライ演算を遅延リダクションで実行する．
+     *
+     * 入力と出力は [0, 2 mod) の範囲である．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
 
     /**
-     * 1 の n 乗根のべき乗を計算して返す．
+     * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算を
+     * 遅延リダクションで実行する．
      *
-     * @param[in] k 指数
-     * @return ll 1 の n 乗根の k 乗
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
      */
-    virtual ll PowOmega(ll k) const;
+    virtual void TransformStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
 
     /**
-     * 1 の n 乗根の逆元のべき乗を計算して返す．
+     * 第 l + 1 段と第 l 段の周波数間引きの遅延リダクションのバタフライ演算を
+     * 1 回の走査で実行する．
      *
-     * @param[in] k 指数
-     * @return ll 1 の n 乗根の逆数の k 乗
+     * 入力と出力は [0, 2 mod) の範囲である．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
      */
-    virtual ll PowPhi(ll k) const;
+    virtual void TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
 
-private:
-    /** モジュラス */
-    static constexpr ll kMod = 19529729;
+    /**
+     * 32 ビットで格納した数列に対して，第 l + 1 段と第 l 段の周波数間引きの
+     * 遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDifPair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
 
-    /** 1 の n 乗根 */
-    static constexpr ll kOmega = 770;
+    /**
+     * [0, 4 mod) の数列を [0, mod) に正規化する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     */
+    virtual void Normalize(ll *a, ll m) const;
 
-    /** 1 の n 乗根の逆元 */
-    static constexpr ll kPhi = 16765131;
+    /**
+     * 32 ビットで格納した [0, 4 mod) の数列を [0, mod) に正規化する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     */
+    virtual void Normalize(u32 *a, ll m) const;
 
-    /** 次数 */
-    static constexpr ll kN = 131072;
+private:
+    /**
+     * モジュラスが遅延リダクションで扱える範囲であることを確認して返す．
+     *
+     * @param[in] mod モジュラス．
+     * @return ll モジュラス
+     * @throw std::invalid_argument mod が 2^30 以上の場合
+     */
+    static ll CheckMod(ll mod);
 
-    /** 次数の逆元 */
-    static constexpr ll kNInv = 19529580;
+    /** 回転因子 omega_pows_ に対する Shoup の商 */
+    AlignedVector<ll> omega_shoup_;
 
-    /** 次数が 2 の何乗か */
-    static constexpr ll kLogN = 17;
+    /** 回転因子 phi_pows_ に対する Shoup の商 */
+    AlignedVector<ll> phi_shoup_;
 };
 
 /**
- * モジュラス 19529729, 次数 131072 の Montgomery 乗算を使った
+ * 64 ビットのモジュラスに対してモンゴメリ乗算 (R = 2^64) を利用する
  * Number theoretic transform のためのクラス．
+ *
+ * 4179340454199820289 = 29 * 2^57 + 1 のように 2^62 未満の素数を扱えるため，
+ * 係数の大きな畳み込みを CRT を使わずに計算できる．
+ * 回転因子のテーブルはモンゴメリ表現で保持し，バタフライ演算ごとのリダクションは 1 回である．
+ * 32 ビットで格納した数列は扱えず，u32 の数列を受け取る関数は std::invalid_argument を送出する．
  */
-class NttMod19529729Deg131072M : public NttBase {
+class NttMontgomery64 : public NttGeneric {
 
 public:
-    /* コンストラクタ */
-    NttMod19529729Deg131072M();
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス (2^62 未満の素数)．
+     * @param[in] n 次数．
+     * @throw std::invalid_argument mod が 2^62 未満の素数でないか，
+     *                              n が 2 以上の 2 のべき乗でないか，
+     *                              mod - 1 が n で割り切れない場合
+     */
+    NttMontgomery64(ll mod, ll n);
 
     /**
-     * バタフライ演算を実行して結果を返す．
+     * 離散フーリエ変換でのバタフライ演算を実行して結果を返す．
      *
      * @param[in, out] a 要素
      * @param[in, out] b 要素
-     * @param[in] k 指数
+     * @param[in] w 回転因子 (モンゴメリ表現)
      */
-    virtual void Butterfly(ll& a, ll& b, ll k) const;
+    virtual void Butterfly(ll& a, ll& b, ll w) const;
 
     /**
      * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
      *
      * @param[in, out] a 要素
      * @param[in, out] b 要素
-     * @param[in] k 指数
+     * @param[in] w 回転因子 (モンゴメリ表現)
      */
-    virtual void ButterflyInv(ll& a, ll& b, ll k) const;
+    virtual void ButterflyInv(ll& a, ll& b, ll w) const;
 
     /**
-     * 数列の要素ごとの積を計算して返す．
+     * 周波数間引きのバタフライ演算を実行して結果を返す．
+     *
+     * (a, b) を (a + b, (a - b) w) に置き換える．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子 (モンゴメリ表現)
+     */
+    virtual void ButterflyDif(ll& a, ll& b, ll w) const;
+
+    using NttBase::Dft;
+    using NttBase::Idft;
+    using NttBase::Mult;
+    using NttBase::Square;
+    using Ntt::MultVec;
+
+    /**
+     * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
+     *
+     * @param[in, out] a 数列．
+     * @throw std::invalid_argument 常に送出する
+     */
+    virtual void Dft(u32 *a) const;
+
+    /**
+     * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
+     *
+     * @param[in, out] a 数列．
+     * @throw std::invalid_argument 常に送出する
+     */
+    virtual void Idft(u32 *a) const;
+
+    /**
+     * 長さ n の数列の要素ごとの積を計算して返す．
      *
      * @param[in] a 数列．
      * @param[in] b 数列．
      * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
      */
-    virtual void MultVec(ll *a, ll *b, ll *c) const;
+    virtual void MultVec(const ll *a, const ll *b, ll *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列．
+     * @param[in] n 数列の長さ．
+     * @throw std::invalid_argument 常に送出する
+     */
+    virtual void MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const;
+
+    /**
+     * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列．
+     * @param[in, out] work 作業領域．
+     * @throw std::invalid_argument 常に送出する
+     */
+    virtual void Mult(const u32 *a, const u32 *b, u32 *c, Workspace *work) const;
+
+    /**
+     * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
+     *
+     * @param[in] a 数列．
+     * @param[out] c 数列．
+     * @throw std::invalid_argument 常に送出する
+     */
+    virtual void Square(const u32 *a, u32 *c) const;
+
+    /**
+     * mod でべき乗を計算して返す．
+     *
+     * @param[in] x 基数
+     * @param[in] k 指数
+     * @return ll x の k 乗
+     */
+    virtual ll Pow(ll x, ll k) const;
 
     /**
      * 1 の n 乗根のべき乗を計算して返す．
@@ -431,63 +2072,133 @@ public:
      */
     virtual ll PowPhi(ll k) const;
 
+protected:
     /**
-     * 数列の逆離散フーリエ変換を計算して返す．
+     * 数列の各要素にスカラーを掛けて返す．
      *
      * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] m 数列の長さ．
+     * @param[in] s スカラー．
      */
-    virtual void Idft(ll *a) const;
+    virtual void MultScalar(ll *a, ll m, ll s) const;
 
-private:
-    /** モジュラス */
-    static constexpr ll kMod = 19529729;
+    /**
+     * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの積を 1 回のリダクションで計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積に R^-1 を掛けたもの．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultPointwise(const ll *a, const ll *b, ll *c, ll n) const;
 
-    /** 1 の n 乗根 */
-    static constexpr ll kOmega = 770;
+    /**
+     * MultPointwise の結果を通常の積に戻すために掛ける係数 R mod N を返す．
+     *
+     * @return ll R mod N
+     */
+    virtual ll PointwiseFactor() const;
 
-    /** 1 の n 乗根の逆元 */
-    static constexpr ll kPhi = 16765131;
+    /**
+     * 離散フーリエ変換した数列をモンゴメリ表現のスペクトルに変換する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void ToSpectrum(ll *a, ll n) const;
 
-    /** 次数 */
-    static constexpr ll kN = 131072;
+    /**
+     * モンゴメリ表現のスペクトルと数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] s スペクトル (モンゴメリ表現)．
+     * @param[in] x 数列．
+     * @param[out] c 数列 s と x の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultSpectrum(const ll *s, const ll *x, ll *c, ll n) const;
 
-    /** 次数の逆元 */
-    static constexpr ll kNInv = 19529580;
+    /**
+     * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                bool inverse) const;
 
-    /** 次数が 2 の何乗か */
-    static constexpr ll kLogN = 17;
+    using NttBase::TransformStage;
 
-    /** モンゴメリ乗算 */
-    MontgomeryMod19529729R25 montgomery_;
-};
+    /**
+     * 第 l 段と第 l + 1 段のバタフライ演算を段ごとに順に実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 前半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     * @param[in] inverse 逆変換の場合 true
+     */
+    virtual void TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    bool inverse) const;
 
-/**
- * モジュラス 19529729, 次数 131072 のNumber theoretic transform の素朴な実装のためのクラス．
- */
-class NttNaiveMod19529729Deg131072 : public NttNaive {
+    using NttBase::TransformStagePair;
 
-public:
-    /* コンストラクタ */
-    NttNaiveMod19529729Deg131072();
+    /**
+     * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+     * r_begin <= r < r_end の範囲を実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const;
 
-private:
-    /** モジュラス */
-    static constexpr ll kMod = 19529729;
+    using NttBase::TransformStageDif;
 
-    /** 1 の n 乗根 */
-    static constexpr ll kOmega = 770;
+    /**
+     * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を段ごとに順に実行する．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @param[in] l 後半の段
+     * @param[in] q_begin q の開始
+     * @param[in] q_end q の終了
+     * @param[in] r_begin r の開始
+     * @param[in] r_end r の終了
+     */
+    virtual void TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                       ll r_end) const;
 
-    /** 1 の n 乗根の逆元 */
-    static constexpr ll kPhi = 16765131;
+    using NttBase::TransformStageDifPair;
 
-    /** 次数 */
-    static constexpr ll kN = 131072;
+    /**
+     * 2 段の組を段ごとの実行に分けるため false を返す．
+     *
+     * @return bool false
+     */
+    virtual bool FusesStagePair() const { return false; }
 
-    /** 次数の逆元 */
-    static constexpr ll kNInv = 19529580;
+private:
+    /**
+     * モジュラスが 64 ビットのモンゴメリ乗算で扱える範囲であることを確認して返す．
+     *
+     * @param[in] mod モジュラス．
+     * @return ll モジュラス
+     * @throw std::invalid_argument mod が 2^62 未満の素数でない場合
+     */
+    static ll CheckMod(ll mod);
 
-    /** 次数が 2 の何乗か */
-    static constexpr ll kLogN = 17;
+    /** モンゴメリ乗算 (R = 2^64) */
+    Montgomery64 montgomery_;
 };
 
 } // namespace ntt
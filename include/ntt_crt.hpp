@@ -0,0 +1,142 @@
+/**
+ * @file ntt_crt.hpp
+ * @brief 複数のモジュラスによる畳み込みを中国剰余定理で復元するクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_NTT_CRT_HPP_
+#define FFT_NTT_CRT_HPP_
+
+#include "include/ntt.hpp"
+#include "include/thread_pool.hpp"
+#include "include/workspace.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * 複数の素数を法とする畳み込みから，整数の畳み込みを正確に計算するクラス．
+ *
+ * 素数ごとの畳み込みは遅延リダクションの NttHarvey で計算し，
+ * スレッドプールが設定されていれば素数ごとに別のスレッドで実行する．
+ * 結果は Garner のアルゴリズムで復元する．
+ * 既定の素数 998244353, 167772161, 469762049 の積は約 2^86 であり，
+ * 各係数がそれ未満であれば正確な値が得られる．
+ */
+class NttCrt {
+
+public:
+    /**
+     * 既定の素数 998244353, 167772161, 469762049 を使うコンストラクタ．
+     *
+     * @param[in] n 次数 (2^23 以下の 2 のべき乗)．
+     * @throw std::invalid_argument n がいずれかの素数で扱えない場合
+     */
+    explicit NttCrt(ll n);
+
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] n 次数．
+     * @param[in] mods 互いに異なる素数 (2^30 未満で mod - 1 が n で割り切れる)．
+     * @throw std::invalid_argument mods が空であるか，同じ素数を含むか，n がいずれかの素数で扱えない場合
+     */
+    NttCrt(ll n, const std::vector<ll>& mods);
+
+    /**
+     * 次数を返す．
+     *
+     * @return ll 次数
+     */
+    ll N() const { return n_; }
+
+    /**
+     * 用いる素数を返す．
+     *
+     * @return const std::vector<ll>& 素数
+     */
+    const std::vector<ll>& Mods() const { return mods_; }
+
+    /**
+     * 素数ごとの畳み込みを並列に実行するためのスレッドプールを設定する．
+     *
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void SetThreadPool(ThreadPool *pool) { pool_ = pool; }
+
+    /**
+     * 非負整数の数列の畳み込みを計算して返す．
+     *
+     * 各係数は 2^64 を法として復元するため，2^63 未満であれば正確な値となる．
+     * len_a + len_b - 1 が N() を超える場合は巡回畳み込みとなる．
+     * a と b が同じ領域で長さも等しい場合は 2 乗として素数ごとの変換を 1 回で済ませる．
+     *
+     * @param[in] a 数列 (長さ len_a, 各要素は非負)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[in] b 数列 (長さ len_b, 各要素は非負)．
+     * @param[in] len_b 数列 b の長さ (N() 以下)．
+     * @param[out] c 数列 a と b の畳み込み (長さ min(len_a + len_b - 1, N()))．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     * @throw std::invalid_argument len_a または len_b が N() を超える場合
+     */
+    void Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c,
+              Workspace *work = nullptr) const;
+
+    /**
+     * 非負整数の数列の畳み込みを任意のモジュラスで計算して返す．
+     *
+     * 各係数が素数の積未満であれば，その値を mod で割った余りとなる．
+     *
+     * @param[in] a 数列 (長さ len_a, 各要素は非負)．
+     * @param[in] len_a 数列 a の長さ (N() 以下)．
+     * @param[in] b 数列 (長さ len_b, 各要素は非負)．
+     * @param[in] len_b 数列 b の長さ (N() 以下)．
+     * @param[out] c 数列 a と b の畳み込みを mod で割った余り．
+     * @param[in] mod モジュラス (1 以上 2^62 未満)．
+     * @param[in, out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+     * @throw std::invalid_argument len_a または len_b が N() を超えるか，mod が範囲外の場合
+     */
+    void MultMod(const ll *a, ll len_a, const ll *b, ll len_b, ll *c, ll mod,
+                 Workspace *work = nullptr) const;
+
+private:
+    /**
+     * 素数ごとの畳み込みを計算し，各係数の Garner の混合基数表現を返す．
+     *
+     * 係数 x は x = v_0 + v_1 m_0 + v_2 m_0 m_1 + ... と表される．
+     * v_i は work の i 番目の作業領域に格納する．
+     *
+     * @param[in] a 数列 (長さ len_a)．
+     * @param[in] len_a 数列 a の長さ．
+     * @param[in] b 数列 (長さ len_b)．
+     * @param[in] len_b 数列 b の長さ．
+     * @param[in, out] work 作業領域．
+     * @return ll 畳み込みの長さ
+     */
+    ll MultDigits(const ll *a, ll len_a, const ll *b, ll len_b, Workspace *work) const;
+
+    /** 次数 */
+    ll n_;
+
+    /** 素数 */
+    std::vector<ll> mods_;
+
+    /** 素数ごとの Number theoretic transform */
+    std::vector<NttHarvey> engines_;
+
+    /** prefixes_[i][j] = m_0 m_1 ... m_(j-1) mod m_i (j < i) */
+    std::vector<AlignedVector<ll>> prefixes_;
+
+    /** prefix_invs_[i] = (m_0 m_1 ... m_(i-1))^-1 mod m_i */
+    AlignedVector<ll> prefix_invs_;
+
+    /** 素数ごとの畳み込みを並列に実行するためのスレッドプール */
+    ThreadPool *pool_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_NTT_CRT_HPP_
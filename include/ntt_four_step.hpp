@@ -0,0 +1,238 @@
+/**
+ * @file ntt_four_step.hpp
+ * @brief 4 段階法による大きな次数の Number theoretic transform のクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_NTT_FOUR_STEP_HPP_
+#define FFT_NTT_FOUR_STEP_HPP_
+
+#include "include/aligned_memory.hpp"
+#include "include/ntt.hpp"
+#include "include/thread_pool.hpp"
+#include <functional>
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * 4 段階法 (four-step) で大きな次数の変換を行う Number theoretic transform のクラス．
+ *
+ * 長さ n = n1 n2 の数列を n1 行 n2 列の行列 A[j1][j2] = a[j1 n2 + j2] とみなし，
+ * 1. 各列の長さ n1 の変換，2. 回転因子 w^(j2 k1) の乗算，3. 各行の長さ n2 の変換，
+ * 4. 転置 の順に計算する．列の変換は 16 列ずつ作業領域に集めてから行うため，
+ * 部分変換はいずれもキャッシュに収まり，数列全体の走査は数回で済む．
+ * 部分変換は NttHarvey で行うため，p は 2^30 未満であるとする．
+ * スレッドプールが設定されていれば，列のまとまりと行ごとに並列に実行する．
+ *
+ * 部分変換は周波数間引きでビット反転した順序のまま出力するため，(r1, r2) 要素は
+ * X[rev(r1) + n1 rev(r2)] = X[rev(r1 n2 + r2)] となる．したがって 4. の転置と
+ * 部分変換の並び替えは全体のビット反転 1 回にまとまり，畳み込みではこれも省く．
+ */
+class NttFourStep : public Ntt {
+
+public:
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス (2^30 未満の素数)．
+     * @param[in] n 次数 (4 以上の 2 のべき乗で mod - 1 を割り切る)．
+     * @throw std::invalid_argument mod または n が扱えない場合
+     */
+    NttFourStep(ll mod, ll n);
+
+    using Ntt::Dft;
+    using Ntt::Idft;
+
+    /**
+     * 次数を返す．
+     *
+     * @return ll 次数
+     */
+    virtual ll N() const { return n_; }
+
+    /**
+     * モジュラスを返す．
+     *
+     * @return ll モジュラス
+     */
+    virtual ll Mod() const { return mod_; }
+
+    /**
+     * 行列とみなしたときの行数 (列の変換の長さ) を返す．
+     *
+     * @return ll 行数
+     */
+    ll Rows() const { return rows_; }
+
+    /**
+     * 行列とみなしたときの列数 (行の変換の長さ) を返す．
+     *
+     * @return ll 列数
+     */
+    ll Columns() const { return columns_; }
+
+    /**
+     * 数列の離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Dft(ll *a) const;
+
+    /**
+     * 数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Idft(ll *a) const;
+
+    /**
+     * 列と行の変換を並列に実行するためのスレッドプールを設定する．
+     *
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void SetThreadPool(ThreadPool *pool) { pool_ = pool; }
+
+protected:
+    /**
+     * 畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * 最後のビット反転を省き，ビット反転した順序のまま返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void DftPointwise(ll *a) const;
+
+    /**
+     * ビット反転した順序の数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftPointwise(ll *a) const;
+
+    /**
+     * ビット反転した順序の数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftSpectrum(ll *a) const { IdftPointwise(a); }
+
+    /**
+     * DftPointwise の出力の要素の順序を返す．
+     *
+     * @return Spectrum::Order ビット反転した順序
+     */
+    virtual Spectrum::Order SpectrumOrder() const { return Spectrum::Order::kBitReversed; }
+
+private:
+    /**
+     * 部分変換のクラス．
+     *
+     * 畳み込みのための変換 (ビット反転の並び替えを省いた変換) を外から呼べるようにする．
+     */
+    class SubNtt : public NttHarvey {
+
+    public:
+        using NttHarvey::NttHarvey;
+        using NttHarvey::DftPointwise;
+        using NttHarvey::IdftPointwise;
+    };
+
+    /**
+     * 各列の変換と回転因子の乗算を行う．
+     *
+     * 順変換では列を変換してから回転因子を掛け，逆変換では回転因子の逆数を
+     * 掛けてから列を逆変換する．列の k1 番目の要素は rev(k1) 番目に置かれる．
+     *
+     * @param[in, out] a 数列 (rows_ 行 columns_ 列)．変換後の数列を上書きして返す．
+     * @param[in] inverse 逆変換の場合 true
+     */
+    void ColumnPass(ll *a, bool inverse) const;
+
+    /**
+     * 各行の変換を行う．
+     *
+     * 行の要素はビット反転した順序で置かれる．
+     *
+     * @param[in, out] a 数列 (rows_ 行 columns_ 列)．変換後の数列を上書きして返す．
+     * @param[in] inverse 逆変換の場合 true
+     */
+    void RowPass(ll *a, bool inverse) const;
+
+    /**
+     * panel 番目の列のまとまりに共通する回転因子の部分 w^(±W panel rev(r)) を返す．
+     *
+     * W = min(kPanelWidth, 列数) であり，列 j2 = W panel + c の回転因子は
+     * w^(±c rev(r)) (テーブル) とこの値の積となる．
+     *
+     * @param[in] panel 列のまとまりの番号
+     * @param[in] inverse 逆変換の場合 true (w の代わりに w^-1 を用いる)
+     * @param[out] factors 行ごとの回転因子 (長さ rows_)
+     * @param[out] factors_shoup factors に対する Shoup の商 (長さ rows_)
+     */
+    void PanelFactors(ll panel, bool inverse, ll *factors, ll *factors_shoup) const;
+
+    /**
+     * 0 以上 num_tasks 未満の各 i について task(i) を実行する．
+     *
+     * スレッドプールが設定されていればスレッドプールで並列に実行する．
+     *
+     * @param[in] num_tasks タスクの数
+     * @param[in] task タスク
+     */
+    void Run(ll num_tasks, const std::function<void(ll)>& task) const;
+
+    /** 列の変換でまとめて扱う列の数 */
+    static constexpr ll kPanelWidth = 16;
+
+    /** モジュラス */
+    ll mod_;
+
+    /** 次数 */
+    ll n_;
+
+    /** 行数 (列の変換の長さ) */
+    ll rows_;
+
+    /** 列数 (行の変換の長さ) */
+    ll columns_;
+
+    /** 1 の n 乗根 */
+    ll omega_;
+
+    /** 1 の n 乗根の逆元 */
+    ll omega_inv_;
+
+    /** 長さ rows_ の変換 */
+    SubNtt column_ntt_;
+
+    /** 長さ columns_ の変換 */
+    SubNtt row_ntt_;
+
+    /** 数列全体のビット反転の並び替え */
+    BitReversal bit_reversal_;
+
+    /** 行数のビット数のビット反転のテーブル */
+    std::vector<ll> row_reversal_;
+
+    /** まとまり内の c 列目の回転因子 w^(c rev(r)) (c rows_ + r 番目) */
+    AlignedVector<ll> panel_twiddles_;
+
+    /** panel_twiddles_ に対する Shoup の商 */
+    AlignedVector<ll> panel_twiddles_shoup_;
+
+    /** まとまり内の c 列目の逆変換の回転因子 w^(-c rev(r)) (c rows_ + r 番目) */
+    AlignedVector<ll> panel_twiddles_inv_;
+
+    /** panel_twiddles_inv_ に対する Shoup の商 */
+    AlignedVector<ll> panel_twiddles_inv_shoup_;
+
+    /** 列と行の変換を並列に実行するためのスレッドプール */
+    ThreadPool *pool_ = nullptr;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_NTT_FOUR_STEP_HPP_
@@ -0,0 +1,168 @@
+/**
+ * @file ntt_negacyclic.hpp
+ * @brief x^n + 1 を法とする畳み込み (負巡回畳み込み) のためのクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_NTT_NEGACYCLIC_HPP_
+#define FFT_NTT_NEGACYCLIC_HPP_
+
+#include "include/aligned_memory.hpp"
+#include "include/bit_reversal.hpp"
+#include "include/ntt.hpp"
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * Z_p[x] / (x^n + 1) での積 (負巡回畳み込み) を計算する Number theoretic transform のクラス．
+ *
+ * 1 の 2n 乗根 ψ を用い，変換は X[k] = Σ a[j] ψ^((2k + 1) j) とする．
+ * ψ^j を掛けてから巡回の変換を行う代わりに，ψ のべき乗をビット反転した順序で並べた
+ * テーブルを回転因子とする Cooley-Tukey (順変換) と Gentleman-Sande (逆変換) の
+ * バタフライ演算を用いるため，ψ の乗算は全段の回転因子に含まれ追加の走査は発生しない．
+ * 順変換は最終段で [0, p) に正規化し，逆変換は最終段で n^-1 を掛ける．
+ * これにより負巡回畳み込みは長さ n の巡回畳み込みと同じ手間で計算できる．
+ *
+ * Mult, Square, Prepare などの Ntt の畳み込みはすべて x^n + 1 を法とする積となる．
+ * 途中の値は遅延リダクションで [0, 4p) に留めるため，p は 2^30 未満であるとする．
+ */
+class NttNegacyclic : public Ntt {
+
+public:
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス (2^30 未満の奇素数)．
+     * @param[in] n 次数 (2 以上の 2 のべき乗で，2n が mod - 1 を割り切る)．
+     * @throw std::invalid_argument mod または n が扱えない場合
+     */
+    NttNegacyclic(ll mod, ll n);
+
+    using Ntt::Dft;
+    using Ntt::Idft;
+
+    /**
+     * 次数を返す．
+     *
+     * @return ll 次数
+     */
+    virtual ll N() const { return n_; }
+
+    /**
+     * モジュラスを返す．
+     *
+     * @return ll モジュラス
+     */
+    virtual ll Mod() const { return mod_; }
+
+    /**
+     * 1 の 2n 乗根 ψ を返す．
+     *
+     * @return ll 1 の 2n 乗根
+     */
+    ll Psi() const { return psi_; }
+
+    /**
+     * 数列の離散フーリエ変換 X[k] = Σ a[j] ψ^((2k + 1) j) を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Dft(ll *a) const;
+
+    /**
+     * 数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Idft(ll *a) const;
+
+    /**
+     * 環の元を要素ごとの積で乗算できる表現 (ビット反転した順序の変換) に変換する．
+     *
+     * 変換した元どうしは MultVec で乗算し，加減算は要素ごとに行える．
+     * FromPointwise で環の元に戻す．
+     *
+     * @param[in, out] a 数列 (各要素は [0, p))．変換後の数列を上書きして返す．
+     */
+    void ToPointwise(ll *a) const;
+
+    /**
+     * ToPointwise で変換した表現を環の元に戻す．
+     *
+     * @param[in, out] a 数列 (各要素は [0, p))．変換後の数列を上書きして返す．
+     */
+    void FromPointwise(ll *a) const;
+
+protected:
+    /**
+     * 畳み込みのための離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void DftPointwise(ll *a) const { ToPointwise(a); }
+
+    /**
+     * MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftPointwise(ll *a) const { FromPointwise(a); }
+
+    /**
+     * DftPointwise の出力の要素の順序を返す．
+     *
+     * @return Spectrum::Order ビット反転した順序
+     */
+    virtual Spectrum::Order SpectrumOrder() const { return Spectrum::Order::kBitReversed; }
+
+    /**
+     * MultSpectrum の結果の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void IdftSpectrum(ll *a) const { FromPointwise(a); }
+
+private:
+    /** モジュラス */
+    ll mod_;
+
+    /** 次数 */
+    ll n_;
+
+    /** 1 の 2n 乗根 */
+    ll psi_;
+
+    /** ψ^rev(i) (rev は log n ビットのビット反転) */
+    AlignedVector<ll> psi_rev_;
+
+    /** psi_rev_ に対する Shoup の商 */
+    AlignedVector<ll> psi_rev_shoup_;
+
+    /** ψ^-rev(i) */
+    AlignedVector<ll> psi_inv_rev_;
+
+    /** psi_inv_rev_ に対する Shoup の商 */
+    AlignedVector<ll> psi_inv_rev_shoup_;
+
+    /** 逆変換の最終段で掛ける n^-1 */
+    ll n_inv_;
+
+    /** n_inv_ に対する Shoup の商 */
+    ll n_inv_shoup_;
+
+    /** 逆変換の最終段で掛ける n^-1 ψ^-rev(1) */
+    ll last_twiddle_;
+
+    /** last_twiddle_ に対する Shoup の商 */
+    ll last_twiddle_shoup_;
+
+    /** 自然な順序との並び替え */
+    BitReversal bit_reversal_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_NTT_NEGACYCLIC_HPP_
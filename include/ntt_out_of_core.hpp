@@ -0,0 +1,229 @@
+/**
+ * @file ntt_out_of_core.hpp
+ * @brief ファイルに置いた数列の Number theoretic transform を行うクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_NTT_OUT_OF_CORE_HPP_
+#define FFT_NTT_OUT_OF_CORE_HPP_
+
+#include "include/ntt.hpp"
+#include "include/thread_pool.hpp"
+#include <functional>
+#include <string>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * メモリに収まらない長さの数列の Number theoretic transform を，
+ * メモリマップしたファイル上で 4 段階法により行うクラス．
+ *
+ * ファイルは N() 個の ll をそのまま並べたものとし，各要素は [0, p) とする．
+ * 数列を Rows() 行 Columns() 列の行列とみなし，次の走査で変換する．
+ *   1. 列の変換と回転因子の乗算 (PanelColumns() 列ずつ読み書き)
+ *   2. 行の変換 (PanelRows() 行ずつ連続して読み書き)
+ *   3. 転置 (Dft, Idft のみ．2. の書き出しと同時に一時ファイルに行う)
+ * 作業領域は 2 つのパネル分のみで，各走査はファイルを先頭から順に進む．
+ * 次のパネルは連続した領域であれば madvise で先読みを指示し，スレッドプールが
+ * 設定されていれば現在のパネルの変換と並行して別のスレッドで読み込む．
+ *
+ * Dft と Idft は同じディレクトリに同じ大きさの一時ファイルを mkstemp で一意な名前で作成し，
+ * 完了後に元のファイルと置き換える．途中で例外が送出された場合，一時ファイルは削除される．Mult は転置を省き，列と行の変換を
+ * 済ませた順序のまま要素ごとの積をとって逆変換する．
+ * 部分変換は NttMontgomery64 で，回転因子の乗算は Montgomery64 で行うため，
+ * p は 2^62 未満の素数とする．n は p - 1 を割り切る必要があり，例えば
+ * 4179340454199820289 = 29 * 2^57 + 1 であれば 2^30 点を超える変換を扱える．
+ */
+class NttOutOfCore {
+
+public:
+    /** パネルの要素数の既定値 (8 MiB) */
+    static constexpr ll kDefaultPanelElements = 1LL << 20;
+
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス (2^62 未満の素数)．
+     * @param[in] n 次数 (4 以上の 2 のべき乗で mod - 1 を割り切る)．
+     * @throw std::invalid_argument mod が 2^62 未満の素数でないか，n が扱えない場合
+     */
+    NttOutOfCore(ll mod, ll n);
+
+    /**
+     * 次数を返す．
+     *
+     * @return ll 次数
+     */
+    ll N() const { return n_; }
+
+    /**
+     * モジュラスを返す．
+     *
+     * @return ll モジュラス
+     */
+    ll Mod() const { return mod_; }
+
+    /**
+     * 行列とみなしたときの行数 (列の変換の長さ) を返す．
+     *
+     * @return ll 行数
+     */
+    ll Rows() const { return rows_; }
+
+    /**
+     * 行列とみなしたときの列数 (行の変換の長さ) を返す．
+     *
+     * @return ll 列数
+     */
+    ll Columns() const { return columns_; }
+
+    /**
+     * 列の変換で一度に読み込む列数を返す．
+     *
+     * @return ll 列数
+     */
+    ll PanelColumns() const { return panel_columns_; }
+
+    /**
+     * 行の変換で一度に読み込む行数を返す．
+     *
+     * @return ll 行数
+     */
+    ll PanelRows() const { return panel_rows_; }
+
+    /**
+     * メモリに読み込むパネルの大きさを設定する．
+     *
+     * パネルは 2 つ分確保するため，作業領域は
+     * 2 max(columns Rows(), rows Columns()) 要素となる．
+     * 列数を大きくすると列の変換で連続して読む長さが増える．
+     *
+     * @param[in] columns 列の変換で一度に読み込む列数 (Columns() 以下の 2 のべき乗)．
+     * @param[in] rows 行の変換で一度に読み込む行数 (Rows() 以下の 2 のべき乗)．
+     * @throw std::invalid_argument columns または rows が扱えない場合
+     */
+    void SetPanelSize(ll columns, ll rows);
+
+    /**
+     * パネルの読み込みと変換を並行に実行するためのスレッドプールを設定する．
+     *
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void SetThreadPool(ThreadPool *pool) { pool_ = pool; }
+
+    /**
+     * ファイルに置いた数列の離散フーリエ変換を計算して上書きする．
+     *
+     * @param[in] path N() 個の ll を並べたファイル．
+     * @throw std::invalid_argument ファイルの大きさが N() 個の ll と異なる場合
+     * @throw std::system_error ファイルを開けない場合
+     */
+    void Dft(const std::string& path) const;
+
+    /**
+     * ファイルに置いた数列の逆離散フーリエ変換を計算して上書きする．
+     *
+     * @param[in] path N() 個の ll を並べたファイル．
+     * @throw std::invalid_argument ファイルの大きさが N() 個の ll と異なる場合
+     * @throw std::system_error ファイルを開けない場合
+     */
+    void Idft(const std::string& path) const;
+
+    /**
+     * ファイルに置いた数列の畳み込み (長さ N() の巡回畳み込み) を計算してファイルに書き出す．
+     *
+     * a と b が同じファイルであれば 2 乗として変換を 1 回で済ませる．
+     * c は a または b と同じファイルでもよい．b の変換は c と同じディレクトリに
+     * 一意な名前で作成する一時ファイルで行い，終了時に削除する．
+     *
+     * @param[in] a 数列 a のファイル．
+     * @param[in] b 数列 b のファイル．
+     * @param[in] c 畳み込みを書き出すファイル (存在しなければ作成する)．
+     * @throw std::invalid_argument ファイルの大きさが N() 個の ll と異なる場合
+     * @throw std::system_error ファイルを開けない場合
+     */
+    void Mult(const std::string& a, const std::string& b, const std::string& c) const;
+
+private:
+    /**
+     * 列の変換と回転因子の乗算を行う．
+     *
+     * 順変換は列の変換の後に ω^(j2 k1) を，逆変換は ω^(-j2 k1) を掛けてから列の逆変換を行う．
+     *
+     * @param[in, out] a 数列 (Rows() 行 Columns() 列)．変換後の数列を上書きして返す．
+     * @param[in] inverse 逆変換の場合 true
+     */
+    void ColumnPass(ll *a, bool inverse) const;
+
+    /**
+     * 行の変換を行う．
+     *
+     * 転置した数列は Columns() 行 Rows() 列の行列として読み書きする．
+     *
+     * @param[in] src 入力の数列．
+     * @param[out] dst 出力の数列．src と同じ領域でもよい (転置しない場合)．
+     * @param[in] inverse 逆変換の場合 true
+     * @param[in] src_transposed 入力が転置されていれば true
+     * @param[in] dst_transposed 転置して出力する場合 true
+     */
+    void RowPass(const ll *src, ll *dst, bool inverse, bool src_transposed,
+                 bool dst_transposed) const;
+
+    /**
+     * パネルを順に読み込み，処理して書き戻す．
+     *
+     * スレッドプールが設定されていれば，パネル i + 1 の読み込みと
+     * パネル i の処理・書き戻しを別のスレッドで並行に実行する．
+     *
+     * @param[in] num_panels パネルの数
+     * @param[in] panel_size パネルの要素数
+     * @param[in] prefetch パネルの先読みを指示する関数
+     * @param[in] gather パネルを作業領域に読み込む関数
+     * @param[in] process 作業領域のパネルを処理して書き戻す関数
+     */
+    void RunPanels(ll num_panels, ll panel_size, const std::function<void(ll)>& prefetch,
+                   const std::function<void(ll, ll *)>& gather,
+                   const std::function<void(ll, ll *)>& process) const;
+
+    /** モジュラス */
+    ll mod_;
+
+    /** 次数 */
+    ll n_;
+
+    /** 行数 n1 (列の変換の長さ) */
+    ll rows_;
+
+    /** 列数 n2 (行の変換の長さ) */
+    ll columns_;
+
+    /** 1 の n 乗根 ω */
+    ll omega_;
+
+    /** ω の逆元 */
+    ll omega_inv_;
+
+    /** 回転因子の乗算に用いるモンゴメリ乗算 (R = 2^64) */
+    Montgomery64 montgomery_;
+
+    /** 列の変換 (長さ n1) */
+    NttMontgomery64 column_ntt_;
+
+    /** 行の変換 (長さ n2) */
+    NttMontgomery64 row_ntt_;
+
+    /** 列の変換で一度に読み込む列数 */
+    ll panel_columns_;
+
+    /** 行の変換で一度に読み込む行数 */
+    ll panel_rows_;
+
+    /** パネルの読み込みと変換を並行に実行するためのスレッドプール */
+    ThreadPool *pool_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_NTT_OUT_OF_CORE_HPP_
@@ -0,0 +1,261 @@
+/**
+ * @file ntt_static.hpp
+ * @brief モジュラスと次数をコンパイル時に決める Number theoretic transform を
+ *        実装するヘッダファイル．
+ */
+
+#ifndef FFT_NTT_STATIC_HPP_
+#define FFT_NTT_STATIC_HPP_
+
+#include "include/ntt.hpp"
+#include <algorithm>
+#include <array>
+
+/**
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * モジュラスと次数をテンプレート引数で与える Number theoretic transform のためのクラス．
+ *
+ * バタフライ演算は仮想関数を介さずインライン展開され，モジュラスによる剰余や
+ * ループの上限はコンパイル時定数となる．回転因子のテーブルもコンパイル時に作成する．
+ * 逆変換は IDFT(a)[k] = DFT(a)[-k mod n] / n を用いて順変換のテーブルを共有する．
+ *
+ * @tparam Modulus モジュラス (2^31 未満の素数)
+ * @tparam Root 1 の 2^LogN 乗根 (原始根)
+ * @tparam LogN 次数が 2 の何乗か
+ */
+template <ll Modulus, ll Root, ll LogN>
+class NttStatic : public Ntt {
+
+public:
+    /** モジュラス */
+    static constexpr ll kMod = Modulus;
+
+    /** 1 の n 乗根 */
+    static constexpr ll kOmega = Root;
+
+    /** 次数 */
+    static constexpr ll kN = 1LL << LogN;
+
+    /** 次数が 2 の何乗か */
+    static constexpr ll kLogN = LogN;
+
+    static_assert(Modulus < (1LL << 31), "Modulus must be less than 2^31");
+    static_assert(LogN >= 1, "LogN must be positive");
+
+    /**
+     * 次数を返す．
+     *
+     * @return ll 次数
+     */
+    virtual ll N() const { return kN; }
+
+    /**
+     * モジュラスを返す．
+     *
+     * @return ll モジュラス
+     */
+    virtual ll Mod() const { return kMod; }
+
+    /**
+     * 数列の離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Dft(ll *a) const {
+        DftImpl(a);
+    }
+
+    /**
+     * 数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Idft(ll *a) const {
+        IdftImpl(a);
+    }
+
+    /**
+     * 32 ビットで格納した数列の離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Dft(u32 *a) const {
+        DftImpl(a);
+    }
+
+    /**
+     * 32 ビットで格納した数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    virtual void Idft(u32 *a) const {
+        IdftImpl(a);
+    }
+
+    /**
+     * 長さ n の数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultVec(const ll *a, const ll *b, ll *c, ll n) const {
+        for (ll i = 0; i < n; i++) {
+            c[i] = (a[i] * b[i]) % kMod;
+        }
+    }
+
+    /**
+     * 32 ビットで格納した長さ n の数列の要素ごとの積を計算して返す．
+     *
+     * @param[in] a 数列．
+     * @param[in] b 数列．
+     * @param[out] c 数列 a と b の要素ごとの積．
+     * @param[in] n 数列の長さ．
+     */
+    virtual void MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const {
+        for (ll i = 0; i < n; i++) {
+            c[i] = static_cast<u32>((static_cast<ll>(a[i]) * b[i]) % kMod);
+        }
+    }
+
+    using Ntt::MultVec;
+
+    /**
+     * mod Modulus でべき乗を計算して返す．
+     *
+     * @param[in] x 基数
+     * @param[in] k 指数
+     * @return ll x の k 乗
+     */
+    static constexpr ll Pow(ll x, ll k) {
+        ll p = x % kMod;
+        ll v = 1;
+        while (k >= 1) {
+            if ((k & 1) == 1) {
+                v = (v * p) % kMod;
+            }
+            k >>= 1;
+            p = (p * p) % kMod;
+        }
+        return v;
+    }
+
+private:
+    /**
+     * 回転因子のテーブルを作成する．
+     *
+     * 第 l 段で用いる 1 の 2^l 乗根の r 乗を添字 2^(l-1) + r に格納する．
+     *
+     * @return std::array<ll, kN> 回転因子のテーブル
+     */
+    static constexpr std::array<ll, kN> MakePowTable() {
+        std::array<ll, kN> table {};
+        ll half = kN >> 1;
+        ll w = 1;
+        for (ll r = 0; r < half; r++) {
+            table[half + r] = w;
+            w = (w * kOmega) % kMod;
+        }
+
+        for (ll l = kLogN - 1; l >= 1; l--) {
+            ll max_r = 1LL << (l - 1);
+            for (ll r = 0; r < max_r; r++) {
+                table[max_r + r] = table[half + (r << (kLogN - l))];
+            }
+        }
+        return table;
+    }
+
+    /**
+     * バタフライ演算を実行して結果を返す．
+     *
+     * @param[in, out] a 要素
+     * @param[in, out] b 要素
+     * @param[in] w 回転因子
+     */
+    template <typename T>
+    static void Butterfly(T& a, T& b, ll w) {
+        ll tmp = (w * b) % kMod;
+        ll diff = a + kMod - tmp;
+        ll sum = a + tmp;
+        b = static_cast<T>((diff >= kMod) ? diff - kMod : diff);
+        a = static_cast<T>((sum >= kMod) ? sum - kMod : sum);
+    }
+
+    /**
+     * ビット反転で並び替えた数列に変換の各段を実行する．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    template <typename T>
+    static void Transform(T *a) {
+        for (ll l = 1; l <= kLogN; l++) {
+            ll max_q = 1LL << (kLogN - l);
+            ll max_r = 1LL << (l - 1);
+            const ll *w = &kOmegaPows[max_r];
+            for (ll q = 0; q < max_q; q++) {
+                T *x = a + (q << l);
+                for (ll r = 0; r < max_r; r++) {
+                    Butterfly(x[r], x[r + max_r], w[r]);
+                }
+            }
+        }
+    }
+
+    /**
+     * 数列の離散フーリエ変換を計算して返す．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    template <typename T>
+    void DftImpl(T *a) const {
+        Reverse(a, kN);
+        Transform(a);
+    }
+
+    /**
+     * 数列の逆離散フーリエ変換を計算して返す．
+     *
+     * 順変換の出力の添字 1..n-1 を反転すると回転因子の逆数による変換になる．
+     *
+     * @tparam T 要素の型 (ll または u32)
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     */
+    template <typename T>
+    void IdftImpl(T *a) const {
+        Reverse(a, kN);
+        Transform(a);
+        std::reverse(a + 1, a + kN);
+
+        for (ll i = 0; i < kN; i++) {
+            a[i] = static_cast<T>((a[i] * kNInv) % kMod);
+        }
+    }
+
+    /** 次数の逆元 */
+    static constexpr ll kNInv = Pow(kN, kMod - 2);
+
+    /** 回転因子のテーブル (段ごとに連続した配置) */
+    static constexpr std::array<ll, kN> kOmegaPows = MakePowTable();
+
+    static_assert(Pow(kOmega, kN) == 1 && Pow(kOmega, kN / 2) == kMod - 1,
+                  "Root must be a primitive 2^LogN-th root of unity");
+};
+
+/** モジュラス 337, 次数 8 のコンパイル時に決まる Number theoretic transform */
+using NttStaticMod337Deg8 = NttStatic<337, 85, 3>;
+
+/** モジュラス 19529729, 次数 131072 のコンパイル時に決まる Number theoretic transform */
+using NttStaticMod19529729Deg131072 = NttStatic<19529729, 770, 17>;
+
+} // namespace ntt
+
+#endif // #ifndef FFT_NTT_STATIC_HPP_
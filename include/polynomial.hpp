@@ -0,0 +1,289 @@
+/**
+ * @file polynomial.hpp
+ * @brief Number theoretic transform による多項式演算のクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_POLYNOMIAL_HPP_
+#define FFT_POLYNOMIAL_HPP_
+
+#include "include/ntt.hpp"
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * Z_p[x] の多項式演算 (逆元，除算，対数，指数，多点評価，補間) を行うクラス．
+ *
+ * 多項式は係数を次数の低い順に並べた std::vector<ll> で表し，各係数は [0, p) とする．
+ * 変換は NttHarvey の DftSized / IdftSized で必要な長さだけ行う．
+ *
+ * 逆元と指数は変換の長さを倍にしながら Newton 法で求め，1 回の反復で同じ多項式の
+ * 変換を複数の積に使い回す．指数は長さ 2m の変換の偶数番目が長さ m の変換と
+ * 一致することを利用し，逆元の更新に長さ m の変換を新たに計算しない．
+ * 多点評価と補間は積木 (subproduct tree) を用いる．部分木の積 P (次数 s) は
+ * P mod (x^s - 1) の長さ s の変換とともに保持し，親の積に必要な長さ 2s の変換は
+ * 奇数番目の長さ s の変換を 1 回加えるだけで求める．
+ *
+ * 必要な変換の長さが MaxN() を超える場合は std::length_error を送出する．
+ */
+class PolynomialRing {
+
+public:
+    /** 素朴な方法で積や評価を計算する長さの上限 */
+    static constexpr ll kNaiveLength = 32;
+
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] mod モジュラス (2^30 未満の素数)．
+     * @param[in] max_n 変換の長さの上限 (2 以上の 2 のべき乗で，mod - 1 を割り切る)．
+     * @throw std::invalid_argument mod または max_n が扱えない場合
+     */
+    PolynomialRing(ll mod, ll max_n);
+
+    /**
+     * モジュラスを返す．
+     *
+     * @return ll モジュラス
+     */
+    ll Mod() const { return mod_; }
+
+    /**
+     * 変換の長さの上限を返す．
+     *
+     * @return ll 変換の長さの上限
+     */
+    ll MaxN() const { return engine_.N(); }
+
+    /**
+     * 多項式の積を計算して返す．
+     *
+     * @param[in] a 多項式
+     * @param[in] b 多項式
+     * @return std::vector<ll> a と b の積 (長さ a.size() + b.size() - 1，いずれかが空なら空)
+     */
+    std::vector<ll> Mult(const std::vector<ll>& a, const std::vector<ll>& b) const;
+
+    /**
+     * 冪級数の逆元 a^-1 mod x^n を計算して返す．
+     *
+     * @param[in] a 冪級数 (a[0] != 0)
+     * @param[in] n 求める項数 (MaxN() 以下)
+     * @return std::vector<ll> a^-1 mod x^n
+     * @throw std::invalid_argument a[0] が 0 の場合
+     */
+    std::vector<ll> Inv(const std::vector<ll>& a, ll n) const;
+
+    /**
+     * 多項式の除算 a = b q + r (deg r < deg b) を行う．
+     *
+     * @param[in] a 被除数
+     * @param[in] b 除数 (0 でない)
+     * @param[out] q 商 (末尾に 0 を含まない)．nullptr の場合は求めない．
+     * @param[out] r 余り (末尾に 0 を含まない)．nullptr の場合は求めない．
+     * @throw std::invalid_argument b が 0 の場合
+     */
+    void DivMod(const std::vector<ll>& a, const std::vector<ll>& b,
+                std::vector<ll> *q, std::vector<ll> *r) const;
+
+    /**
+     * 冪級数の対数 log a mod x^n を計算して返す．
+     *
+     * @param[in] a 冪級数 (a[0] = 1)
+     * @param[in] n 求める項数 (MaxN() / 2 以下)
+     * @return std::vector<ll> log a mod x^n
+     * @throw std::invalid_argument a[0] が 1 でない場合
+     */
+    std::vector<ll> Log(const std::vector<ll>& a, ll n) const;
+
+    /**
+     * 冪級数の指数 exp a mod x^n を計算して返す．
+     *
+     * @param[in] a 冪級数 (a[0] = 0)
+     * @param[in] n 求める項数 (MaxN() 以下)
+     * @return std::vector<ll> exp a mod x^n
+     * @throw std::invalid_argument a[0] が 0 でない場合
+     */
+    std::vector<ll> Exp(const std::vector<ll>& a, ll n) const;
+
+    /**
+     * 多項式の各点での値を計算して返す．
+     *
+     * @param[in] a 多項式
+     * @param[in] xs 点
+     * @return std::vector<ll> 各点での a の値
+     */
+    std::vector<ll> Evaluate(const std::vector<ll>& a, const std::vector<ll>& xs) const;
+
+    /**
+     * 各点で指定した値をとる次数 xs.size() 未満の多項式を返す．
+     *
+     * @param[in] xs 互いに異なる点
+     * @param[in] ys 各点での値 (xs と同じ長さ)
+     * @return std::vector<ll> 補間多項式 (長さ xs.size())
+     * @throw std::invalid_argument xs と ys の長さが異なるか，xs に重複がある場合
+     */
+    std::vector<ll> Interpolate(const std::vector<ll>& xs, const std::vector<ll>& ys) const;
+
+private:
+    /**
+     * 積木．根を 1 番とし，i 番の節点の子を 2i, 2i + 1 番とする．
+     *
+     * 節点は 2 のべき乗の長さの区間 [l, l + len) のうち点のある範囲の積 Π (x - x_i) をもつ．
+     */
+    struct SubproductTree {
+        /** 点 */
+        std::vector<ll> points;
+
+        /** 葉の数 (点の数以上の 2 のべき乗) */
+        ll leaves;
+
+        /** 節点の積 (点のない節点は空) */
+        std::vector<std::vector<ll>> polys;
+
+        /** 区間が点で埋まった節点の P mod (x^len - 1) の長さ len の変換 (素朴に求めた節点は空) */
+        std::vector<std::vector<ll>> spectra;
+    };
+
+    /**
+     * 2 のべき乗の長さの数列の離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @throw std::length_error 長さが MaxN() を超える場合
+     */
+    void Dft(std::vector<ll>& a) const;
+
+    /**
+     * 長さ m (2 のべき乗) の配列の離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 配列．変換後の配列を上書きして返す．
+     * @param[in] m 長さ
+     * @throw std::length_error 長さが MaxN() を超える場合
+     */
+    void Dft(ll *a, ll m) const;
+
+    /**
+     * 2 のべき乗の長さの数列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 数列．変換後の数列を上書きして返す．
+     * @throw std::length_error 長さが MaxN() を超える場合
+     */
+    void Idft(std::vector<ll>& a) const;
+
+    /**
+     * 長さ m (2 のべき乗) の配列の逆離散フーリエ変換を計算して返す．
+     *
+     * @param[in, out] a 配列．変換後の配列を上書きして返す．
+     * @param[in] m 長さ
+     * @throw std::length_error 長さが MaxN() を超える場合
+     */
+    void Idft(ll *a, ll m) const;
+
+    /**
+     * 次数 s 以下の多項式 P の長さ 2s の変換を，P mod (x^s - 1) の長さ s の変換から求めて返す．
+     *
+     * 偶数番目はそのまま，奇数番目は p_j ω_2s^j (j < s) の長さ s の変換から p_s を引いて求める．
+     *
+     * @param[in] spectrum P mod (x^s - 1) の長さ s の変換
+     * @param[in] p P の係数 (長さ s + 1 以下)
+     * @return std::vector<ll> P の長さ 2s の変換
+     */
+    std::vector<ll> DoubleSpectrum(const std::vector<ll>& spectrum, const std::vector<ll>& p) const;
+
+    /**
+     * 多項式 a を b で割った商を返す．
+     *
+     * 逆順にした b の逆元との積で求め，商または除数が短い場合は筆算で求める．
+     *
+     * @param[in] a 被除数
+     * @param[in] b 除数 (末尾に 0 を含まない)
+     * @return std::vector<ll> 商
+     */
+    std::vector<ll> Quotient(const std::vector<ll>& a, const std::vector<ll>& b) const;
+
+    /**
+     * 商 q から余り a - b q を求めて返す．
+     *
+     * 余りの次数は deg b 未満であるため，積 b q は長さ deg b 以上の巡回畳み込みで足りる．
+     *
+     * @param[in] a 被除数
+     * @param[in] b 除数 (末尾に 0 を含まない)
+     * @param[in] q a を b で割った商
+     * @return std::vector<ll> 余り (長さ b.size() - 1 以下)
+     */
+    std::vector<ll> Remainder(const std::vector<ll>& a, const std::vector<ll>& b,
+                              const std::vector<ll>& q) const;
+
+    /**
+     * 点の積木を作成して返す．
+     *
+     * @param[in] xs 点 (1 つ以上)
+     * @return SubproductTree 積木
+     */
+    SubproductTree BuildTree(const std::vector<ll>& xs) const;
+
+    /**
+     * 積木の節点の積を子の積から求める．
+     *
+     * @param[in, out] tree 積木
+     * @param[in] node 節点の番号
+     * @param[in] l 区間の左端
+     * @param[in] len 区間の長さ
+     */
+    void BuildNode(SubproductTree& tree, ll node, ll l, ll len) const;
+
+    /**
+     * 区間が点で埋まった節点の積の長さ 2 len の変換を返す．
+     *
+     * @param[in] tree 積木
+     * @param[in] node 節点の番号
+     * @param[in] len 区間の長さ
+     * @return std::vector<ll> 節点の積の長さ 2 len の変換
+     */
+    std::vector<ll> NodeSpectrum(const SubproductTree& tree, ll node, ll len) const;
+
+    /**
+     * 余りを積木に沿って下ろし，節点の区間の点での値を求める．
+     *
+     * @param[in] tree 積木
+     * @param[in] node 節点の番号
+     * @param[in] l 区間の左端
+     * @param[in] len 区間の長さ
+     * @param[in] a 多項式
+     * @param[out] values 各点での値
+     */
+    void EvaluateNode(const SubproductTree& tree, ll node, ll l, ll len,
+                      const std::vector<ll>& a, std::vector<ll>& values) const;
+
+    /**
+     * 節点の区間の点について Σ w_i Π_(j != i) (x - x_j) を求めて返す．
+     *
+     * @param[in] tree 積木
+     * @param[in] node 節点の番号
+     * @param[in] l 区間の左端
+     * @param[in] len 区間の長さ
+     * @param[in] weights 各点の重み w_i
+     * @return std::vector<ll> 節点の区間の点についての和
+     */
+    std::vector<ll> InterpolateNode(const SubproductTree& tree, ll node, ll l, ll len,
+                                    const std::vector<ll>& weights) const;
+
+    /** モジュラス */
+    ll mod_;
+
+    /** 変換を行う Number theoretic transform */
+    NttHarvey engine_;
+
+    /** 1 の MaxN() 乗根 ω のべき乗 ω^i (i < MaxN() / 2) */
+    std::vector<ll> omega_pows_;
+
+    /** 1 以上 MaxN() 以下の整数の逆元 (積分に用いる) */
+    std::vector<ll> invs_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_POLYNOMIAL_HPP_
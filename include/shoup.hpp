@@ -0,0 +1,61 @@
+/**
+ * @file shoup.hpp
+ * @brief Shoup の方法による剰余乗算を定義するヘッダファイル．
+ */
+
+#ifndef FFT_SHOUP_HPP_
+#define FFT_SHOUP_HPP_
+
+#include <cstdint>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * w に対する Shoup の商 floor(w 2^32 / p) を返す．
+ *
+ * @param[in] w 係数 ([0, p))
+ * @param[in] p モジュラス (2^31 未満)
+ * @return std::uint64_t Shoup の商
+ */
+inline std::uint64_t ShoupQuotient(std::uint64_t w, std::uint64_t p) {
+    return (w << 32) / p;
+}
+
+/**
+ * Shoup の方法で w y mod p を [0, 2p) の範囲で計算して返す．
+ *
+ * 最後の条件付き減算を省くため，遅延リダクションを行うバタフライ演算に用いる．
+ *
+ * @param[in] y 要素 (2^32 未満)
+ * @param[in] w 係数 ([0, p))
+ * @param[in] w_shoup w に対する Shoup の商 ShoupQuotient(w, p)
+ * @param[in] p モジュラス (2^31 未満)
+ * @return std::uint64_t w y mod p と合同な [0, 2p) の値
+ */
+inline std::uint64_t MultShoupLazy(std::uint64_t y, std::uint64_t w, std::uint64_t w_shoup,
+                                   std::uint64_t p) {
+    std::uint64_t q = (w_shoup * y) >> 32;
+    return w * y - q * p;
+}
+
+/**
+ * Shoup の方法で w y mod p を [0, p) の範囲で計算して返す．
+ *
+ * @param[in] y 要素 (2^32 未満)
+ * @param[in] w 係数 ([0, p))
+ * @param[in] w_shoup w に対する Shoup の商 ShoupQuotient(w, p)
+ * @param[in] p モジュラス (2^31 未満)
+ * @return std::uint64_t w y mod p
+ */
+inline std::uint64_t MultShoupReduced(std::uint64_t y, std::uint64_t w, std::uint64_t w_shoup,
+                                      std::uint64_t p) {
+    std::uint64_t r = MultShoupLazy(y, w, w_shoup, p);
+    return (r >= p) ? r - p : r;
+}
+
+} // namespace ntt
+
+#endif // FFT_SHOUP_HPP_
@@ -0,0 +1,182 @@
+/**
+ * @file stream_convolver.hpp
+ * @brief 長い数列を区切って固定のカーネルと畳み込むクラスを定義するヘッダファイル．
+ */
+
+#ifndef FFT_STREAM_CONVOLVER_HPP_
+#define FFT_STREAM_CONVOLVER_HPP_
+
+#include "include/ntt.hpp"
+#include "include/thread_pool.hpp"
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/**
+ * 少しずつ与えられる数列と固定のカーネルの畳み込みを，区切りごとに出力するクラス．
+ *
+ * 長さ K のカーネルに対し，入力を B = N() - K + 1 個ずつのブロックに区切って
+ * 長さ N() の巡回畳み込みを行い，overlap-add または overlap-save で出力をつなぐ．
+ * カーネルの変換はコンストラクタで一度だけ計算し，各ブロックは
+ * Ntt::TransformInput と Ntt::MultTransformed で畳み込む．
+ *
+ * ブロック用の作業領域を 2 つ交互に使い，スレッドプールが設定されていれば
+ * ブロック k + 1 の変換とブロック k の逆変換および出力を別のスレッドで並行に実行する．
+ * このため出力は入力より 1 ブロック遅れる．保持する領域は入力の長さによらず O(N()) である．
+ *
+ * スレッド間で共有してはならない．
+ */
+class StreamConvolver {
+
+public:
+    /** 出力をつなぐ方法 */
+    enum class Method {
+        /** ブロックの畳み込みの末尾 K - 1 個を次のブロックの先頭に加える */
+        kOverlapAdd,
+        /** 直前の K - 1 個の入力をブロックの前に置き，巡回の影響を受けない B 個を出力する */
+        kOverlapSave,
+    };
+
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] ntt 畳み込みに用いる Number theoretic transform．
+     *                このオブジェクトより長く存在しなければならない．
+     * @param[in] kernel カーネル (長さ len_kernel, 各要素は [0, mod))．
+     * @param[in] len_kernel カーネルの長さ (1 以上 ntt.N() 以下)．
+     * @param[in] method 出力をつなぐ方法．
+     * @throw std::invalid_argument len_kernel が範囲外の場合
+     */
+    StreamConvolver(const Ntt& ntt, const ll *kernel, ll len_kernel,
+                    Method method = Method::kOverlapAdd);
+
+    /**
+     * 1 回の変換で処理する入力の数を返す．
+     *
+     * @return ll ブロックの長さ N() - K + 1
+     */
+    ll BlockSize() const { return block_; }
+
+    /**
+     * カーネルの長さを返す．
+     *
+     * @return ll カーネルの長さ
+     */
+    ll KernelLength() const { return len_kernel_; }
+
+    /**
+     * ブロックの変換と逆変換を並行に実行するためのスレッドプールを設定する．
+     *
+     * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+     */
+    void SetThreadPool(ThreadPool *pool) { pool_ = pool; }
+
+    /**
+     * 入力を追加し，確定した出力を out の末尾に追加する．
+     *
+     * 出力は入力全体とカーネルの畳み込みを先頭から順に並べたものであり，
+     * ブロック単位で確定する．
+     *
+     * @param[in] x 入力 (長さ len, 各要素は [0, mod))．
+     * @param[in] len 入力の長さ．
+     * @param[out] out 出力を追加する数列．
+     * @return ll 追加した出力の数
+     */
+    ll Push(const ll *x, ll len, std::vector<ll> *out);
+
+    /**
+     * 入力の終わりを通知し，残りの出力を out の末尾に追加する．
+     *
+     * これまでの出力と合わせて，入力の長さ + K - 1 個 (入力が空なら 0 個) となる．
+     * 呼び出し後は新しい入力列を受け付ける．
+     *
+     * @param[out] out 出力を追加する数列．
+     * @return ll 追加した出力の数
+     */
+    ll Flush(std::vector<ll> *out);
+
+    /** 出力していない入力と途中の結果を捨て，新しい入力列を受け付ける． */
+    void Reset();
+
+private:
+    /**
+     * たまった入力をブロックとして変換し，変換済みのブロックがあれば並行に出力する．
+     *
+     * @param[out] out 出力を追加する数列．
+     */
+    void Submit(std::vector<ll> *out);
+
+    /**
+     * 変換済みのブロックがあれば畳み込みを完了して出力する．
+     *
+     * @param[out] out 出力を追加する数列．
+     */
+    void Drain(std::vector<ll> *out);
+
+    /**
+     * たまった入力を作業領域に並べて変換する．
+     *
+     * @param[out] slot 作業領域 (長さ N())
+     */
+    void Load(ll *slot);
+
+    /**
+     * 変換したブロックの畳み込みを完了し，確定した B 個の出力を追加する．
+     *
+     * @param[in, out] slot 変換したブロック (長さ N())
+     * @param[out] out 出力を追加する数列．
+     */
+    void Emit(ll *slot, std::vector<ll> *out);
+
+    /** 畳み込みに用いる Number theoretic transform */
+    const Ntt& ntt_;
+
+    /** 出力をつなぐ方法 */
+    Method method_;
+
+    /** カーネルの長さ K */
+    ll len_kernel_;
+
+    /** ブロックの長さ B */
+    ll block_;
+
+    /** カーネルの変換 */
+    Spectrum kernel_spectrum_;
+
+    /** ブロックの作業領域 (2 つを交互に使う) */
+    AlignedVector<ll> slots_[2];
+
+    /** 変換済みで出力していないブロックの作業領域の番号 */
+    int current_;
+
+    /** 変換済みで出力していないブロックがあれば true */
+    bool in_flight_;
+
+    /** ブロックに満たない入力 */
+    AlignedVector<ll> input_;
+
+    /** input_ にたまった入力の数 */
+    ll input_len_;
+
+    /** overlap-add では次のブロックに加える値，overlap-save では直前の入力 (長さ K - 1) */
+    AlignedVector<ll> overlap_;
+
+    /** 受け取った入力の数 */
+    ll consumed_;
+
+    /** 変換したブロックの数 */
+    ll submitted_;
+
+    /** 出力した数 */
+    ll emitted_;
+
+    /** ブロックの変換と逆変換を並行に実行するためのスレッドプール */
+    ThreadPool *pool_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_STREAM_CONVOLVER_HPP_
@@ -0,0 +1,109 @@
+/**
+ * @file thread_pool.hpp
+ * @brief スレッドプールを定義するヘッダファイル．
+ */
+
+#ifndef FFT_THREAD_POOL_HPP_
+#define FFT_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/** 64ビット整数型 */
+using ll = long long int;
+
+/**
+ * 常駐するワーカースレッドでタスクを並列実行するためのクラス．
+ *
+ * スレッドはコンストラクタで生成され，デストラクタまで再利用される．
+ * 呼び出し元のスレッドもタスクを実行するため，ワーカースレッドの数は
+ * スレッド数より 1 少ない．
+ */
+class ThreadPool {
+
+public:
+    /**
+     * コンストラクタ．
+     *
+     * @param[in] num_threads スレッド数 (呼び出し元を含む)．0 以下の場合はハードウェアの並列数．
+     */
+    explicit ThreadPool(int num_threads);
+
+    /** デストラクタ． */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * スレッド数を返す．
+     *
+     * @return int スレッド数 (呼び出し元を含む)
+     */
+    int NumThreads() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /**
+     * タスク 0, 1, ..., num_tasks - 1 を並列に実行し，すべての終了を待つ．
+     *
+     * タスクは空いているスレッドが番号順に取り出して実行する．
+     * タスクの中から呼び出した場合は，呼び出し元のスレッドで逐次実行する．
+     * タスクは例外を送出してはならない．
+     *
+     * @param[in] num_tasks タスク数
+     * @param[in] task タスク番号を受け取って実行する関数
+     */
+    void Run(ll num_tasks, const std::function<void(ll)>& task);
+
+private:
+    /** ワーカースレッドの処理 */
+    void WorkerLoop();
+
+    /** 実行中のタスクを取り出して実行する */
+    void Work();
+
+    /** ワーカースレッド */
+    std::vector<std::thread> workers_;
+
+    /** Run の呼び出しを直列化するための排他制御 */
+    std::mutex run_mutex_;
+
+    /** 状態を保護するための排他制御 */
+    std::mutex mutex_;
+
+    /** ワーカースレッドにタスクを通知するための条件変数 */
+    std::condition_variable task_cv_;
+
+    /** 呼び出し元にタスクの終了を通知するための条件変数 */
+    std::condition_variable done_cv_;
+
+    /** 実行中のタスク */
+    const std::function<void(ll)> *task_ = nullptr;
+
+    /** 実行中のタスク数 */
+    ll num_tasks_ = 0;
+
+    /** 次に取り出すタスク番号 */
+    std::atomic<ll> next_task_{0};
+
+    /** 実行中のワーカースレッド数 */
+    int num_busy_ = 0;
+
+    /** タスクを通知した回数 */
+    ll generation_ = 0;
+
+    /** 終了する場合 true */
+    bool stop_ = false;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_THREAD_POOL_HPP_
@@ -28,6 +28,54 @@ public:
      * @return ll 逆数
      */
     static ll InvMod(ll x, ll n);
+
+    /**
+     * 積を返す．
+     *
+     * 128 ビットの中間値で計算するため，n は 2^63 未満であればよい．
+     *
+     * @param[in] x 値 ([0, n))
+     * @param[in] y 値 ([0, n))
+     * @param[in] n モジュラス
+     * @return ll x と y の積
+     */
+    static ll MulMod(ll x, ll y, ll n);
+
+    /**
+     * べき乗を返す．
+     *
+     * @param[in] x 基数
+     * @param[in] k 指数
+     * @param[in] n モジュラス
+     * @return ll x の k 乗
+     */
+    static ll PowMod(ll x, ll k, ll n);
+
+    /**
+     * 素数であるかを返す．
+     *
+     * 64 ビット整数で決定的となる底を用いた Miller-Rabin 法で判定する．
+     *
+     * @param[in] n 値 (2^63 未満)
+     * @return bool 素数であれば true
+     */
+    static bool IsPrime(ll n);
+
+    /**
+     * 素数 p を法とする原始根のうち最小のものを返す．
+     *
+     * @param[in] p 素数
+     * @return ll 原始根
+     */
+    static ll PrimitiveRoot(ll p);
+
+    /**
+     * 値が 2 の何乗以下かを返す．
+     *
+     * @param[in] n 値
+     * @return ll 2^k <= n を満たす最大の k
+     */
+    static ll Log2(ll n);
 };
 
 } // namespace ntt
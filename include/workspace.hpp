@@ -0,0 +1,74 @@
+/**
+ * @file workspace.hpp
+ * @brief 作業領域を定義するヘッダファイル．
+ */
+
+#ifndef FFT_WORKSPACE_HPP_
+#define FFT_WORKSPACE_HPP_
+
+#include "include/aligned_memory.hpp"
+#include <cstdint>
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/** 64ビット整数型 */
+using ll = long long int;
+
+/** 32ビット符号なし整数型 */
+using u32 = std::uint32_t;
+
+/**
+ * 変換や畳み込みで用いる作業領域のクラス．
+ *
+ * 一度確保した領域は再利用されるため，同じ大きさの計算を繰り返す場合は
+ * 2 回目以降にメモリ確保が発生しない．領域は AlignedMemory で確保し，
+ * 先頭はキャッシュラインの境界に揃う．
+ * スレッド間で共有してはならない．
+ */
+class Workspace {
+
+public:
+    /**
+     * index 番目の作業領域を返す．
+     *
+     * 領域の要素は初期化されない．
+     *
+     * @param[in] index 作業領域の番号
+     * @param[in] size 必要な要素数
+     * @return ll* size 個以上の要素をもつ作業領域
+     */
+    ll *Buffer(ll index, ll size);
+
+    /**
+     * 32 ビットの要素をもつ index 番目の作業領域を返す．
+     *
+     * Buffer とは別の領域であり，領域の要素は初期化されない．
+     *
+     * @param[in] index 作業領域の番号
+     * @param[in] size 必要な要素数
+     * @return u32* size 個以上の要素をもつ作業領域
+     */
+    u32 *Buffer32(ll index, ll size);
+
+    /**
+     * スレッドごとの既定の作業領域を返す．
+     *
+     * @return Workspace& 呼び出したスレッドの作業領域
+     */
+    static Workspace& ThreadLocal();
+
+private:
+    /** 作業領域 */
+    std::vector<AlignedVector<ll>> buffers_;
+
+    /** 32 ビットの要素をもつ作業領域 */
+    std::vector<AlignedVector<u32>> buffers32_;
+};
+
+} // namespace ntt
+
+#endif // #ifndef FFT_WORKSPACE_HPP_
@@ -4,28 +4,56 @@
  */
 
 #include "include/util.hpp"
+#include "include/aligned_memory.hpp"
+#include "include/bigint.hpp"
+#include "include/bit_reversal.hpp"
 #include "include/montgomery.hpp"
 #include "include/ntt.hpp"
+#include "include/ntt_crt.hpp"
+#include "include/ntt_four_step.hpp"
+#include "include/ntt_negacyclic.hpp"
+#include "include/ntt_out_of_core.hpp"
+#include "include/ntt_static.hpp"
+#include "include/polynomial.hpp"
+#include "include/stream_convolver.hpp"
+#include "include/thread_pool.hpp"
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
 
 namespace {
 
 /**
  * Number theoretic transform の実行サンプルを出力する．
  *
+ * @tparam T 数列の要素の型 (ntt::ll または ntt::u32)
  * @param[in] ntt NTTオブジェクト
  * @param[in] is_show_mode 標準出力する場合true
+ * @param[in] is_truncated 入力の長さを指定して畳み込みを計算する場合true (T が ntt::ll の場合のみ)
  * @return double 実行時間 [ms]
  */
-double NttSample(const ntt::Ntt& ntt, bool is_show_mode) {
+template <typename T = ntt::ll>
+double NttSample(const ntt::Ntt& ntt, bool is_show_mode, bool is_truncated = false) {
     int size = ntt.N();
 
-    ntt::ll *a = new ntt::ll[size];
-    ntt::ll *b = new ntt::ll[size];
-    ntt::ll *c = new ntt::ll[size];
+    // 数列はスレッドごとのアリーナから切り出し，繰り返し呼んでもメモリ確保を発生させない
+    ntt::Arena& arena = ntt::Arena::ThreadLocal();
+    ntt::ArenaScope scope(arena);
+    T *a = arena.Allocate<T>(size);
+    T *b = arena.Allocate<T>(size);
+    T *c = arena.Allocate<T>(size);
 
     for (int i = 0; i < size; i++) {
         a[i] = 0;
@@ -53,10 +81,18 @@ double NttSample(const ntt::Ntt& ntt, bool is_show_mode) {
     }
 
     auto begin = std::chrono::system_clock::now();
-    ntt.Mult(a, b, c);
+    if constexpr (std::is_same_v<T, ntt::ll>) {
+        if (is_truncated) {
+            ntt.Mult(a, 4, b, 4, c);
+        } else {
+            ntt.Mult(a, b, c);
+        }
+    } else {
+        ntt.Mult(a, b, c, nullptr);
+    }
     auto end = std::chrono::system_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
-    double elapsed_time = static_cast<double>(elapsed.count());
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - begin);
+    double elapsed_time = elapsed.count();
 
     if (is_show_mode) {
         std::cout << "a * b: ";
@@ -66,15 +102,6 @@ double NttSample(const ntt::Ntt& ntt, bool is_show_mode) {
         std::cout << std::endl;
     }
 
-    delete[] a;
-    a = nullptr;
-
-    delete[] b;
-    b = nullptr;
-
-    delete[] c;
-    c = nullptr;
-
     return elapsed_time;
 }
 
@@ -114,6 +141,503 @@ double NttMontgomerySample(bool is_show_mode) {
     return elapsed;
 }
 
+/**
+ * 遅延リダクションのバタフライ演算を利用した Number theoretic transform の
+ * 実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @return double 実行時間 [ms]
+ */
+double NttHarveySample(bool is_show_mode) {
+    ntt::NttHarvey ntt(19529729, 131072);
+    double elapsed = NttSample(ntt, is_show_mode);
+    return elapsed;
+}
+
+/**
+ * 64 ビットのモジュラスに対してモンゴメリ乗算を利用した Number theoretic transform の
+ * 実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @return double 実行時間 [ms]
+ */
+double NttMontgomery64Sample(bool is_show_mode) {
+    ntt::NttMontgomery64 ntt(4179340454199820289LL, 131072);
+    double elapsed = NttSample(ntt, is_show_mode);
+    return elapsed;
+}
+
+/**
+ * 32 ビットで数列を格納し，モンゴメリ乗算を利用した Number theoretic transform の
+ * 実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @return double 実行時間 [ms]
+ */
+double NttMontgomery32Sample(bool is_show_mode) {
+    ntt::NttMod19529729Deg131072M ntt;
+    double elapsed = NttSample<ntt::u32>(ntt, is_show_mode);
+    return elapsed;
+}
+
+/**
+ * SIMD 命令を使わずモンゴメリ乗算を利用した Number theoretic transform の
+ * 実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @return double 実行時間 [ms]
+ */
+double NttMontgomeryScalarSample(bool is_show_mode) {
+    ntt::NttMod19529729Deg131072M ntt;
+    ntt.SetSimdIsa(ntt::MontgomerySimd::Isa::kScalar);
+    double elapsed = NttSample(ntt, is_show_mode);
+    return elapsed;
+}
+
+/**
+ * モジュラスと次数をコンパイル時に決めた Number theoretic transform の
+ * 実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @return double 実行時間 [ms]
+ */
+double NttStaticSample(bool is_show_mode) {
+    ntt::NttStaticMod19529729Deg131072 ntt;
+    double elapsed = NttSample(ntt, is_show_mode);
+    return elapsed;
+}
+
+/**
+ * 入力の長さを指定したモンゴメリ乗算を利用した Number theoretic transform の
+ * 実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @return double 実行時間 [ms]
+ */
+double NttTruncatedSample(bool is_show_mode) {
+    ntt::NttMod19529729Deg131072M ntt;
+    double elapsed = NttSample(ntt, is_show_mode, true);
+    return elapsed;
+}
+
+/**
+ * スレッドプールを利用した Number theoretic transform の実行サンプルを出力する．
+ *
+ * @param[in] is_show_mode 標準出力する場合true
+ * @param[in] pool スレッドプール
+ * @return double 実行時間 [ms]
+ */
+double NttParallelSample(bool is_show_mode, ntt::ThreadPool *pool) {
+    ntt::NttMod19529729Deg131072M ntt;
+    ntt.SetThreadPool(pool);
+    double elapsed = NttSample(ntt, is_show_mode);
+    return elapsed;
+}
+
+/**
+ * モンゴメリ乗算を繰り返した場合の 1 回あたりの時間を出力する．
+ *
+ * @tparam M モンゴメリ乗算のクラス
+ * @param[in] name 表示名
+ * @param[in] montgomery モンゴメリ乗算のオブジェクト
+ */
+template <typename M>
+void ShowMontgomeryBenchmark(const std::string& name, const M& montgomery) {
+    const ntt::ll count = 10000000;
+    ntt::ll x = montgomery.N() - 2;
+    ntt::ll y = (montgomery.N() - 1) / 3;
+
+    auto begin = std::chrono::system_clock::now();
+    for (ntt::ll i = 0; i < count; i++) {
+        x = montgomery.Mult(x, y);
+    }
+    auto end = std::chrono::system_clock::now();
+    double elapsed = std::chrono::duration<double, std::nano>(end - begin).count();
+
+    std::cout << name << ": " << (elapsed / count) << " [ns/mult] (result " << x << ")"
+              << std::endl;
+}
+
+/**
+ * 変換の順序ごとに数列全体を走査する回数，転送量の見積もりと実行時間を出力する．
+ */
+void ShowScheduleSample() {
+    using Schedule = ntt::NttBase::Schedule;
+
+    std::cout << "---- Transform schedule ----" << std::endl;
+    for (ntt::ll log_n : { 17, 20, 22 }) {
+        ntt::NttHarvey ntt(998244353, 1LL << log_n);
+        std::vector<ntt::ll> a(ntt.N());
+        for (ntt::ll i = 0; i < ntt.N(); i++) {
+            a[i] = i % ntt.Mod();
+        }
+
+        for (Schedule schedule : { Schedule::kBreadthFirst, Schedule::kBlocked }) {
+            ntt.SetSchedule(schedule);
+            ntt::NttBase::ScheduleReport report = ntt.Report(log_n);
+
+            auto begin = std::chrono::system_clock::now();
+            ntt.Dft(a.data());
+            auto end = std::chrono::system_clock::now();
+            double elapsed = std::chrono::duration<double, std::milli>(end - begin).count();
+
+            std::cout << "2^" << log_n
+                      << ((schedule == Schedule::kBlocked) ? " blocked:  " : " breadth:  ")
+                      << report.stages << " stages, " << report.passes << " passes, "
+                      << (report.bytes >> 20) << " [MiB], " << elapsed << " [ms]" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * ビット反転の並び替えの方法ごとの実行時間を出力する．
+ */
+void ShowReverseSample() {
+    using Method = ntt::BitReversal::Method;
+    const std::vector<std::pair<Method, std::string>> methods {
+        { Method::kIncremental, "incremental" }, { Method::kTable, "table      " },
+        { Method::kBlocked, "blocked    " }, { Method::kBlockedSimd, "blocked+simd" }
+    };
+
+    std::cout << "---- Bit reversal ----" << std::endl;
+    ntt::BitReversal reversal(24);
+    for (ntt::ll log_n : { 17, 20, 22, 24 }) {
+        std::vector<ntt::ll> a(1LL << log_n);
+        std::vector<ntt::u32> b(1LL << log_n);
+        for (ntt::ll i = 0; i < (1LL << log_n); i++) {
+            a[i] = i;
+            b[i] = static_cast<ntt::u32>(i);
+        }
+
+        for (const auto& method : methods) {
+            auto begin = std::chrono::system_clock::now();
+            reversal.Reverse(a.data(), log_n, method.first);
+            auto middle = std::chrono::system_clock::now();
+            reversal.Reverse(b.data(), log_n, method.first);
+            auto end = std::chrono::system_clock::now();
+            double elapsed_ll = std::chrono::duration<double, std::milli>(middle - begin).count();
+            double elapsed_u32 = std::chrono::duration<double, std::milli>(end - middle).count();
+
+            std::cout << "2^" << log_n << " " << method.second << ": " << elapsed_ll
+                      << " [ms] (64 bit), " << elapsed_u32 << " [ms] (32 bit)" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * x^n + 1 を法とする積を，長さ n の負巡回畳み込みと
+ * 長さ 2n の巡回畳み込みの後に x^n = -1 で折り返す方法とで計算し，実行時間を出力する．
+ */
+void ShowNegacyclicSample() {
+    const ntt::ll kMod = 998244353;
+
+    std::cout << "---- Negacyclic convolution (x^n + 1) ----" << std::endl;
+    for (ntt::ll log_n : { 12, 16, 20 }) {
+        ntt::ll n = 1LL << log_n;
+        ntt::NttNegacyclic negacyclic(kMod, n);
+        ntt::NttHarvey harvey(kMod, 2 * n);
+
+        std::vector<ntt::ll> a(n);
+        std::vector<ntt::ll> b(n);
+        for (ntt::ll i = 0; i < n; i++) {
+            a[i] = (i * i + 1) % kMod;
+            b[i] = (kMod - i) % kMod;
+        }
+        std::vector<ntt::ll> c(n);
+        std::vector<ntt::ll> d(2 * n - 1);
+
+        auto begin = std::chrono::system_clock::now();
+        negacyclic.Mult(a.data(), b.data(), c.data(), nullptr);
+        auto middle = std::chrono::system_clock::now();
+        harvey.Mult(a.data(), n, b.data(), n, d.data(), nullptr);
+        for (ntt::ll i = 0; i + 1 < n; i++) {
+            d[i] = (d[i] + kMod - d[n + i]) % kMod;
+        }
+        auto end = std::chrono::system_clock::now();
+        double elapsed_negacyclic = std::chrono::duration<double, std::milli>(middle - begin).count();
+        double elapsed_fold = std::chrono::duration<double, std::milli>(end - middle).count();
+
+        bool is_same = std::equal(c.begin(), c.end(), d.begin());
+        std::cout << "2^" << log_n << ": negacyclic " << elapsed_negacyclic << " [ms], 2n + fold "
+                  << elapsed_fold << " [ms]" << (is_same ? "" : " (mismatch)") << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * 多項式の逆元，指数，対数，多点評価と補間の実行時間を出力する．
+ */
+void ShowPolynomialSample() {
+    const ntt::ll kMod = 998244353;
+    ntt::PolynomialRing ring(kMod, 1LL << 20);
+
+    std::cout << "---- Polynomial ----" << std::endl;
+    for (ntt::ll log_n : { 12, 16, 18 }) {
+        ntt::ll n = 1LL << log_n;
+        std::vector<ntt::ll> a(n);
+        for (ntt::ll i = 0; i < n; i++) {
+            a[i] = (i * i + 7 * i) % kMod;
+        }
+        a[0] = 1;
+
+        auto begin = std::chrono::system_clock::now();
+        std::vector<ntt::ll> inv = ring.Inv(a, n);
+        auto after_inv = std::chrono::system_clock::now();
+        std::vector<ntt::ll> log = ring.Log(a, n);
+        auto after_log = std::chrono::system_clock::now();
+        std::vector<ntt::ll> exp = ring.Exp(log, n);
+        auto after_exp = std::chrono::system_clock::now();
+
+        std::vector<ntt::ll> xs(n);
+        for (ntt::ll i = 0; i < n; i++) {
+            xs[i] = i + 1;
+        }
+        std::vector<ntt::ll> values = ring.Evaluate(a, xs);
+        auto after_evaluate = std::chrono::system_clock::now();
+        std::vector<ntt::ll> interpolated = ring.Interpolate(xs, values);
+        auto end = std::chrono::system_clock::now();
+
+        auto elapsed = [](std::chrono::system_clock::time_point from,
+                          std::chrono::system_clock::time_point to) {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        };
+        bool is_same = (exp == a) && (interpolated == a);
+        std::cout << "2^" << log_n << ": inv " << elapsed(begin, after_inv) << " [ms], log "
+                  << elapsed(after_inv, after_log) << " [ms], exp " << elapsed(after_log, after_exp)
+                  << " [ms], evaluate " << elapsed(after_exp, after_evaluate)
+                  << " [ms], interpolate " << elapsed(after_evaluate, end) << " [ms]"
+                  << (is_same ? "" : " (mismatch)") << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * 2^22 個の入力を区切って長さ 4097 のカーネルと畳み込む実行時間を出力する．
+ *
+ * @param[in] pool スレッドプール
+ */
+void ShowStreamSample(ntt::ThreadPool *pool) {
+    using Method = ntt::StreamConvolver::Method;
+    const ntt::ll kMod = 998244353;
+    const ntt::ll kLength = 1LL << 22;
+    const ntt::ll kChunk = 10000;
+
+    ntt::NttHarvey ntt(kMod, 1LL << 14);
+    std::vector<ntt::ll> kernel(4097);
+    for (size_t i = 0; i < kernel.size(); i++) {
+        kernel[i] = (i * 31 + 7) % kMod;
+    }
+    std::vector<ntt::ll> x(kChunk);
+
+    for (Method method : { Method::kOverlapAdd, Method::kOverlapSave }) {
+        ntt::StreamConvolver convolver(ntt, kernel.data(), kernel.size(), method);
+        convolver.SetThreadPool(pool);
+
+        // 出力は都度捨て，保持する領域が入力の長さによらないことを示す
+        std::vector<ntt::ll> out;
+        ntt::ll written = 0;
+        ntt::ll last = 0;
+        auto begin = std::chrono::system_clock::now();
+        for (ntt::ll pushed = 0; pushed < kLength; pushed += kChunk) {
+            ntt::ll take = std::min(kChunk, kLength - pushed);
+            for (ntt::ll i = 0; i < take; i++) {
+                x[i] = (pushed + i) % 1000;
+            }
+            out.clear();
+            written += convolver.Push(x.data(), take, &out);
+        }
+        out.clear();
+        written += convolver.Flush(&out);
+        last = out.back();
+        auto end = std::chrono::system_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        std::cout << "stream (" << ((method == Method::kOverlapAdd) ? "overlap-add" : "overlap-save")
+                  << ", block " << convolver.BlockSize() << "): " << elapsed << " [ms], "
+                  << (kLength / elapsed / 1000) << " [Msamples/s], " << written
+                  << " outputs, last = " << last << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * 2^24 個の数列をファイルに置いて変換する実行時間を，メモリ上での変換と比較して出力する．
+ *
+ * @param[in] pool スレッドプール
+ */
+void ShowOutOfCoreSample(ntt::ThreadPool *pool) {
+    const ntt::ll kMod = 469762049;
+    const ntt::ll kLength = 1LL << 24;
+    std::string path = "/tmp/ntt_out_of_core_sample.XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        std::cout << "out-of-core: cannot create a temporary file\n" << std::endl;
+        return;
+    }
+    close(fd);
+
+    std::vector<ntt::ll> a(kLength);
+    for (ntt::ll i = 0; i < kLength; i++) {
+        a[i] = i % kMod;
+    }
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(a.data()), kLength * sizeof(ntt::ll));
+    }
+
+    ntt::NttOutOfCore out_of_core(kMod, kLength);
+    out_of_core.SetThreadPool(pool);
+    ntt::NttHarvey harvey(kMod, kLength);
+
+    auto begin = std::chrono::system_clock::now();
+    out_of_core.Dft(path);
+    auto middle = std::chrono::system_clock::now();
+    harvey.Dft(a.data());
+    auto end = std::chrono::system_clock::now();
+    double elapsed_file = std::chrono::duration<double, std::milli>(middle - begin).count();
+    double elapsed_memory = std::chrono::duration<double, std::milli>(end - middle).count();
+
+    std::vector<ntt::ll> b(kLength);
+    {
+        std::ifstream file(path, std::ios::binary);
+        file.read(reinterpret_cast<char *>(b.data()), kLength * sizeof(ntt::ll));
+    }
+    std::remove(path.c_str());
+
+    std::cout << "out-of-core 2^24 (" << out_of_core.Rows() << " x " << out_of_core.Columns()
+              << "): file " << elapsed_file << " [ms], memory " << elapsed_memory << " [ms], "
+              << ((a == b) ? "match" : "MISMATCH") << "\n" << std::endl;
+}
+
+/**
+ * 4 段階法と NttHarvey の変換の実行時間を 2^20 から 2^24 まで出力する．
+ *
+ * @param[in] pool スレッドプール
+ */
+void ShowFourStepSample(ntt::ThreadPool *pool) {
+    const ntt::ll kMod = 469762049;
+
+    std::cout << "---- Four-step NTT ----" << std::endl;
+    for (ntt::ll log_n : { 20, 22, 24 }) {
+        ntt::ll n = 1LL << log_n;
+        ntt::NttHarvey harvey(kMod, n);
+        ntt::NttFourStep four_step(kMod, n);
+        harvey.SetThreadPool(pool);
+        four_step.SetThreadPool(pool);
+
+        std::vector<ntt::ll> a(n);
+        for (ntt::ll i = 0; i < n; i++) {
+            a[i] = i % kMod;
+        }
+
+        auto begin = std::chrono::system_clock::now();
+        harvey.Dft(a.data());
+        auto middle = std::chrono::system_clock::now();
+        four_step.Dft(a.data());
+        auto end = std::chrono::system_clock::now();
+        double elapsed_harvey = std::chrono::duration<double, std::milli>(middle - begin).count();
+        double elapsed_four_step = std::chrono::duration<double, std::milli>(end - middle).count();
+
+        std::cout << "2^" << log_n << " (" << four_step.Rows() << " x " << four_step.Columns()
+                  << "): harvey " << elapsed_harvey << " [ms], four-step "
+                  << elapsed_four_step << " [ms]" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * 複数の素数による整数の畳み込みの実行時間を出力する．
+ *
+ * @param[in] pool スレッドプール
+ */
+void ShowCrtSample(ntt::ThreadPool *pool) {
+    ntt::NttCrt ntt(131072);
+    ntt.SetThreadPool(pool);
+    ntt::ll len = ntt.N() / 2;
+
+    // 係数は最大で 65536 * (10^6)^2 程度となり，単一の素数には収まらない
+    std::vector<ntt::ll> a(len);
+    std::vector<ntt::ll> b(len);
+    std::vector<ntt::ll> c(2 * len - 1);
+    for (ntt::ll i = 0; i < len; i++) {
+        a[i] = 1000000 - i;
+        b[i] = 999999 - i;
+    }
+
+    auto begin = std::chrono::system_clock::now();
+    ntt.Mult(a.data(), len, b.data(), len, c.data());
+    auto end = std::chrono::system_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    std::cout << "crt (" << ntt.Mods().size() << " primes, " << len << " x " << len
+              << " integers): " << elapsed << " [ms], c[" << (len - 1) << "] = "
+              << c[len - 1] << "\n" << std::endl;
+}
+
+/**
+ * 多倍長整数の乗算の実行時間を 10 進 1K 桁から 10M 桁まで出力する．
+ */
+void ShowBigIntSample() {
+    ntt::BigIntMultiplier multiplier;
+
+    std::cout << "---- BigInt multiplication ----" << std::endl;
+    for (ntt::ll digits = 1000; digits <= 10000000; digits *= 10) {
+        // 10 進 digits 桁は約 digits log2(10) / 32 リム
+        ntt::ll limbs = static_cast<ntt::ll>(digits * std::log2(10.0) / 32) + 1;
+        std::vector<ntt::u32> a(limbs);
+        std::vector<ntt::u32> b(limbs);
+        std::vector<ntt::u32> c(2 * limbs);
+        for (ntt::ll i = 0; i < limbs; i++) {
+            a[i] = static_cast<ntt::u32>(i * 2654435761u + 1);
+            b[i] = static_cast<ntt::u32>(i * 2246822519u + 3);
+        }
+
+        auto begin = std::chrono::system_clock::now();
+        multiplier.Mult(a.data(), limbs, b.data(), limbs, c.data());
+        auto end = std::chrono::system_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        // 2 乗は変換が 1 回少ない
+        begin = std::chrono::system_clock::now();
+        multiplier.Mult(a.data(), limbs, a.data(), limbs, c.data());
+        end = std::chrono::system_clock::now();
+        double elapsed_square = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        std::cout << digits << " digits (" << limbs << " limbs): " << elapsed << " [ms], square "
+                  << elapsed_square << " [ms]" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * 複数の畳み込みをまとめて計算した場合のスループットを出力する．
+ *
+ * @param[in] pool スレッドプール
+ */
+void ShowBatchSample(ntt::ThreadPool *pool) {
+    ntt::NttGeneric ntt(19529729, 4096);
+    ntt::ll n = ntt.N();
+    ntt::ll count = 256;
+
+    std::vector<ntt::ll> a(n * count, 0);
+    std::vector<ntt::ll> b(n * count, 0);
+    std::vector<ntt::ll> c(n * count, 0);
+    for (ntt::ll i = 0; i < n * count; i++) {
+        a[i] = i % ntt.Mod();
+        b[i] = (3 * i + 1) % ntt.Mod();
+    }
+
+    auto begin = std::chrono::system_clock::now();
+    ntt.MultBatch(a.data(), b.data(), c.data(), count, n, pool);
+    auto end = std::chrono::system_clock::now();
+    double elapsed = std::chrono::duration<double>(end - begin).count();
+
+    std::cout << "batch (" << count << " x " << n << " points): "
+              << (count / elapsed) << " [products/s]\n" << std::endl;
+}
+
 /**
  * 配列の要素の平均を計算して返す．
  *
@@ -157,9 +681,10 @@ double Std(const std::array<double, N>& array) {
  * @param[in] sample サンプルメソッド
  * @param[in] times 実行回数
  */
-void ShowSample(std::string sample_name, double (*sample)(bool), int times = 10) {
+void ShowSample(std::string sample_name, const std::function<double(bool)>& sample,
+                int times = 10) {
     std::cout << sample_name << std::endl;
-    std::array<double, 10> elapsed_times;
+    std::array<double, 10> elapsed_times {};
 
     double elapsed_time = sample(true);
     elapsed_times[0] = elapsed_time;
@@ -225,6 +750,37 @@ int main(int argc, char **argv) {
     }
 
     ShowSample("---- NTT (Basic)       ----", NttBasicSample);
+    ShowSample("---- NTT (Static)      ----", NttStaticSample);
+    ShowSample("---- NTT (Harvey)      ----", NttHarveySample);
+    ShowSample("---- NTT (Montgomery, scalar) ----", NttMontgomeryScalarSample);
     ShowSample("---- NTT (Montgomery)  ----", NttMontgomerySample);
+    ShowSample("---- NTT (Montgomery, 32-bit) ----", NttMontgomery32Sample);
+    ShowSample("---- NTT (Montgomery, 64-bit modulus) ----", NttMontgomery64Sample);
+
+    std::cout << "---- Montgomery multiplication ----" << std::endl;
+    ShowMontgomeryBenchmark("R = 2^25, N = 19529729", ntt::MontgomeryMod19529729R25());
+    ShowMontgomeryBenchmark("R = 2^64, N = 4179340454199820289",
+                            ntt::Montgomery64(4179340454199820289LL));
+    std::cout << std::endl;
+    ShowSample("---- NTT (Truncated)   ----", NttTruncatedSample);
+    ShowBigIntSample();
+    ShowScheduleSample();
+    ShowReverseSample();
+    ShowNegacyclicSample();
+    ShowPolynomialSample();
+
+    int max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        ntt::ThreadPool pool(threads);
+        std::string name = "---- NTT (Parallel, " + std::to_string(threads) + " threads) ----";
+        ShowSample(name, [&pool](bool is_show_mode) {
+            return NttParallelSample(is_show_mode, &pool);
+        });
+        ShowBatchSample(&pool);
+        ShowCrtSample(&pool);
+        ShowFourStepSample(&pool);
+        ShowStreamSample(&pool);
+        ShowOutOfCoreSample(&pool);
+    }
     return 0;
 }
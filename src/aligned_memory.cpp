@@ -0,0 +1,173 @@
+/**
+ * @file aligned_memory.cpp
+ * @brief 境界を揃えたメモリの確保を定義するソースファイル．
+ */
+
+#include "include/aligned_memory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/* kHugePageThreshold 以上の領域にヒュージページを用いる場合 true */
+std::atomic<bool> huge_pages(true);
+
+/*
+ * bytes を unit の倍数に切り上げて返す．
+ *
+ * @param[in] bytes バイト数
+ * @param[in] unit 単位 (2 のべき乗)
+ * @return size_t 切り上げたバイト数
+ */
+size_t RoundUp(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) & ~(unit - 1);
+}
+
+} // namespace
+
+/*
+ * 境界を揃えた領域を確保する．
+ *
+ * 大きな領域は境界の分だけ余分に予約し，前後の余りを返却して境界に揃える．
+ *
+ * @param[in] bytes バイト数
+ * @return void* 確保した領域
+ */
+void *AlignedMemory::Allocate(size_t bytes) {
+    if (bytes < kHugePageThreshold) {
+        void *p = std::aligned_alloc(kAlignment, RoundUp(std::max<size_t>(bytes, 1), kAlignment));
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    size_t size = RoundUp(bytes, kHugePageSize);
+    void *reserved = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(reserved);
+    std::uintptr_t aligned = RoundUp(begin, kHugePageSize);
+    if (aligned > begin) {
+        munmap(reserved, aligned - begin);
+    }
+    std::uintptr_t tail = begin + kHugePageSize - aligned;
+    if (tail > 0) {
+        munmap(reinterpret_cast<void *>(aligned + size), tail);
+    }
+
+    void *p = reinterpret_cast<void *>(aligned);
+    if (HugePages()) {
+        // ヒュージページが使えない環境では失敗するが，通常のページのまま使う
+        madvise(p, size, MADV_HUGEPAGE);
+    }
+    return p;
+}
+
+/*
+ * Allocate で確保した領域を解放する．
+ *
+ * @param[in] p 領域
+ * @param[in] bytes 確保したときのバイト数
+ */
+void AlignedMemory::Deallocate(void *p, size_t bytes) {
+    if (p == nullptr) {
+        return;
+    }
+    if (bytes < kHugePageThreshold) {
+        std::free(p);
+    } else {
+        munmap(p, RoundUp(bytes, kHugePageSize));
+    }
+}
+
+/*
+ * kHugePageThreshold 以上の領域にヒュージページを用いるかを設定する．
+ *
+ * @param[in] enabled ヒュージページを用いる場合 true
+ */
+void AlignedMemory::SetHugePages(bool enabled) {
+    huge_pages.store(enabled, std::memory_order_relaxed);
+}
+
+/*
+ * kHugePageThreshold 以上の領域にヒュージページを用いるかを返す．
+ *
+ * @return bool ヒュージページを用いる場合 true
+ */
+bool AlignedMemory::HugePages() {
+    return huge_pages.load(std::memory_order_relaxed);
+}
+
+/* デストラクタ．すべてのチャンクを解放する． */
+Arena::~Arena() {
+    for (const Chunk& chunk : chunks_) {
+        AlignedMemory::Deallocate(chunk.data, chunk.bytes);
+    }
+}
+
+/*
+ * 確保しているチャンクの合計のバイト数を返す．
+ *
+ * @return size_t バイト数
+ */
+size_t Arena::Capacity() const {
+    size_t bytes = 0;
+    for (const Chunk& chunk : chunks_) {
+        bytes += chunk.bytes;
+    }
+    return bytes;
+}
+
+/*
+ * スレッドごとの既定のアリーナを返す．
+ *
+ * @return Arena& 呼び出したスレッドのアリーナ
+ */
+Arena& Arena::ThreadLocal() {
+    static thread_local Arena arena;
+    return arena;
+}
+
+/*
+ * bytes バイトの領域を切り出す．
+ *
+ * 現在のチャンクに収まらなければ次のチャンクに移る．次のチャンクは返却済みのため，
+ * 足りなければ大きなチャンクに取り替える．
+ *
+ * @param[in] bytes バイト数
+ * @return void* kAlignment バイトの境界に揃った領域
+ */
+void *Arena::AllocateBytes(size_t bytes) {
+    bytes = RoundUp(std::max<size_t>(bytes, 1), AlignedMemory::kAlignment);
+    if (chunk_ < chunks_.size() && offset_ + bytes > chunks_[chunk_].bytes) {
+        chunk_++;
+        offset_ = 0;
+    }
+
+    size_t chunk_bytes = RoundUp(bytes, AlignedMemory::kHugePageSize);
+    if (chunk_ == chunks_.size()) {
+        chunks_.push_back({ static_cast<char *>(AlignedMemory::Allocate(chunk_bytes)), chunk_bytes });
+    } else if (chunks_[chunk_].bytes < bytes) {
+        AlignedMemory::Deallocate(chunks_[chunk_].data, chunks_[chunk_].bytes);
+        chunks_[chunk_] = { static_cast<char *>(AlignedMemory::Allocate(chunk_bytes)), chunk_bytes };
+    }
+
+    void *p = chunks_[chunk_].data + offset_;
+    offset_ += bytes;
+    return p;
+}
+
+} // namespace ntt
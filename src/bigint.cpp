@@ -0,0 +1,366 @@
+/**
+ * @file bigint.cpp
+ * @brief 多倍長整数の乗算を行うクラスを実装するソースファイル．
+ */
+
+#include "include/bigint.hpp"
+#include "include/aligned_memory.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/** NttCrt の既定の素数で扱える最大の次数 */
+constexpr ll kMaxN = 1LL << 23;
+
+/** 64ビット符号なし整数型 */
+using u64 = std::uint64_t;
+
+/*
+ * x (nx リム) に y (ny リム, ny <= nx) を加えて返す．
+ *
+ * @return u32 最上位からの桁上がり
+ */
+u32 AddTo(u32 *x, ll nx, const u32 *y, ll ny) {
+    u64 carry = 0;
+    ll i = 0;
+    for (; i < ny; i++) {
+        carry += static_cast<u64>(x[i]) + y[i];
+        x[i] = static_cast<u32>(carry);
+        carry >>= 32;
+    }
+    for (; carry != 0 && i < nx; i++) {
+        carry += x[i];
+        x[i] = static_cast<u32>(carry);
+        carry >>= 32;
+    }
+    return static_cast<u32>(carry);
+}
+
+/*
+ * x (nx リム) から y (ny リム, ny <= nx) を引いて返す．x >= y であるとする．
+ */
+void SubFrom(u32 *x, ll nx, const u32 *y, ll ny) {
+    u64 borrow = 0;
+    ll i = 0;
+    for (; i < ny; i++) {
+        u64 t = static_cast<u64>(x[i]) - y[i] - borrow;
+        x[i] = static_cast<u32>(t);
+        borrow = (t >> 32) & 1;
+    }
+    for (; borrow != 0 && i < nx; i++) {
+        u64 t = static_cast<u64>(x[i]) - borrow;
+        x[i] = static_cast<u32>(t);
+        borrow = (t >> 32) & 1;
+    }
+}
+
+/*
+ * 筆算で積を計算して返す．c は len_a + len_b リムである．
+ */
+void MultSchoolbook(const u32 *a, ll len_a, const u32 *b, ll len_b, u32 *c) {
+    std::fill(c, c + len_a + len_b, 0);
+    for (ll i = 0; i < len_a; i++) {
+        u64 carry = 0;
+        u64 x = a[i];
+        for (ll j = 0; j < len_b; j++) {
+            carry += x * b[j] + c[i + j];
+            c[i + j] = static_cast<u32>(carry);
+            carry >>= 32;
+        }
+        c[i + len_b] = static_cast<u32>(carry);
+    }
+}
+
+/*
+ * Karatsuba 法で同じ長さ n の整数の積を計算して返す．c は 2n リムである．
+ */
+void MultKaratsuba(const u32 *a, const u32 *b, ll n, u32 *c, ll threshold) {
+    if (n < threshold) {
+        MultSchoolbook(a, n, b, n, c);
+        return;
+    }
+
+    // a = a1 X + a0, b = b1 X + b0 (X = 2^(32h))
+    ll h = n / 2;
+    ll m = n - h;
+    MultKaratsuba(a, b, h, c, threshold);
+    MultKaratsuba(a + h, b + h, m, c + 2 * h, threshold);
+
+    // (a0 + a1)(b0 + b1) - a0 b0 - a1 b1 = a0 b1 + a1 b0
+    // 一時的な和と積は再帰の深さに応じてスレッドごとのアリーナから切り出す
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    u32 *sa = arena.Allocate<u32>(m + 1);
+    u32 *sb = arena.Allocate<u32>(m + 1);
+    std::copy(a + h, a + n, sa);
+    std::copy(b + h, b + n, sb);
+    sa[m] = AddTo(sa, m, a, h);
+    sb[m] = AddTo(sb, m, b, h);
+
+    ll size_z1 = 2 * (m + 1);
+    u32 *z1 = arena.Allocate<u32>(size_z1);
+    MultKaratsuba(sa, sb, m + 1, z1, threshold);
+    SubFrom(z1, size_z1, c, 2 * h);
+    SubFrom(z1, size_z1, c + 2 * h, 2 * m);
+
+    // 中間項は 2n - h リムに収まる
+    ll len_z1 = std::min<ll>(size_z1, 2 * n - h);
+    AddTo(c + h, 2 * n - h, z1, len_z1);
+}
+
+/*
+ * 筆算または Karatsuba 法で積を計算して返す．c は len_a + len_b リムである．
+ */
+void MultSmall(const u32 *a, ll len_a, const u32 *b, ll len_b, u32 *c, ll threshold) {
+    if (len_a < len_b) {
+        std::swap(a, b);
+        std::swap(len_a, len_b);
+    }
+
+    if (len_b < threshold) {
+        MultSchoolbook(a, len_a, b, len_b, c);
+        return;
+    }
+
+    // 長い方を短い方の長さごとに区切って Karatsuba 法で掛け，足し合わせる
+    std::fill(c, c + len_a + len_b, 0);
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    u32 *piece = arena.Allocate<u32>(2 * len_b);
+    for (ll offset = 0; offset < len_a; offset += len_b) {
+        ll len = std::min(len_b, len_a - offset);
+        if (len == len_b) {
+            MultKaratsuba(a + offset, b, len_b, piece, threshold);
+        } else {
+            MultSmall(a + offset, len, b, len_b, piece, threshold);
+        }
+        AddTo(c + offset, len_a + len_b - offset, piece, len + len_b);
+    }
+}
+
+/*
+ * 整数を d ビットずつの桁に分けて返す．
+ */
+void SplitDigits(const u32 *a, ll len, ll d, ll num_digits, ll *digits) {
+    u64 mask = (1ULL << d) - 1;
+    for (ll i = 0; i < num_digits; i++) {
+        ll bit = i * d;
+        ll word = bit >> 5;
+        u64 x = a[word];
+        if (word + 1 < len) {
+            x |= static_cast<u64>(a[word + 1]) << 32;
+        }
+        digits[i] = static_cast<ll>((x >> (bit & 31)) & mask);
+    }
+}
+
+/*
+ * 2 を底とする対数の切り上げを返す．
+ */
+ll CeilLog2(ll n) {
+    ll k = 0;
+    while ((1LL << k) < n) {
+        k++;
+    }
+    return k;
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ */
+BigIntMultiplier::BigIntMultiplier() :
+        karatsuba_threshold_(kDefaultKaratsubaThreshold),
+        ntt_threshold_(kDefaultNttThreshold),
+        pool_(nullptr) {}
+
+/*
+ * 32 ビットのリムで表した整数の積を計算して返す．
+ *
+ * @param[in] a 整数
+ * @param[in] len_a a のリム数
+ * @param[in] b 整数
+ * @param[in] len_b b のリム数
+ * @param[out] c a と b の積 (len_a + len_b リム)
+ */
+void BigIntMultiplier::Mult(const u32 *a, ll len_a, const u32 *b, ll len_b, u32 *c) {
+    if (len_a <= 0 || len_b <= 0) {
+        std::fill(c, c + std::max<ll>(len_a + len_b, 0), 0);
+        return;
+    }
+
+    if (std::min(len_a, len_b) < ntt_threshold_) {
+        MultSmall(a, len_a, b, len_b, c, karatsuba_threshold_);
+    } else {
+        MultNtt(a, len_a, b, len_b, c);
+    }
+}
+
+/*
+ * 8 ビットのリム (バイト列) で表した整数の積を計算して返す．
+ *
+ * @param[in] a 整数
+ * @param[in] len_a a のバイト数
+ * @param[in] b 整数
+ * @param[in] len_b b のバイト数
+ * @param[out] c a と b の積 (len_a + len_b バイト)
+ */
+void BigIntMultiplier::Mult(const std::uint8_t *a, ll len_a, const std::uint8_t *b, ll len_b,
+                            std::uint8_t *c) {
+    auto pack = [](const std::uint8_t *x, ll len) {
+        AlignedVector<u32> limbs((len + 3) / 4, 0);
+        for (ll i = 0; i < len; i++) {
+            limbs[i >> 2] |= static_cast<u32>(x[i]) << (8 * (i & 3));
+        }
+        return limbs;
+    };
+
+    AlignedVector<u32> la = pack(a, len_a);
+    AlignedVector<u32> lb = pack(b, len_b);
+    AlignedVector<u32> lc(la.size() + lb.size());
+    Mult(la.data(), la.size(), lb.data(), lb.size(), lc.data());
+
+    for (ll i = 0; i < len_a + len_b; i++) {
+        c[i] = static_cast<std::uint8_t>(lc[i >> 2] >> (8 * (i & 3)));
+    }
+}
+
+/*
+ * アルゴリズムを切り替えるリム数を設定する．
+ *
+ * 長さ n を h = n / 2 と m = n - h に分けると中間の積は m + 1 リムとなるため，
+ * n <= 3 で分割すると長さが減らない．
+ *
+ * @param[in] karatsuba 短い方のオペランドがこのリム数以上であれば Karatsuba 法を使う
+ * @param[in] ntt 短い方のオペランドがこのリム数以上であれば NTT を使う
+ */
+void BigIntMultiplier::SetThresholds(ll karatsuba, ll ntt) {
+    if (karatsuba < 4) {
+        throw std::invalid_argument("karatsuba threshold must be at least 4");
+    }
+    if (ntt < 1) {
+        throw std::invalid_argument("ntt threshold must be at least 1");
+    }
+    karatsuba_threshold_ = karatsuba;
+    ntt_threshold_ = ntt;
+}
+
+/*
+ * NTT の素数ごとの畳み込みを並列に実行するためのスレッドプールを設定する．
+ *
+ * @param[in] pool スレッドプール
+ */
+void BigIntMultiplier::SetThreadPool(ThreadPool *pool) {
+    pool_ = pool;
+    if (engine_ != nullptr) {
+        engine_->SetThreadPool(pool_);
+    }
+}
+
+/*
+ * NTT による畳み込みで積を計算して返す．
+ *
+ * @param[in] a 整数
+ * @param[in] len_a a のリム数
+ * @param[in] b 整数
+ * @param[in] len_b b のリム数
+ * @param[out] c a と b の積 (len_a + len_b リム)
+ */
+void BigIntMultiplier::MultNtt(const u32 *a, ll len_a, const u32 *b, ll len_b, u32 *c) {
+    // 畳み込みの係数 (最大 L (2^d - 1)^2) が 2^63 未満に収まる最大の桁のビット数を選ぶ
+    ll d = 24;
+    ll num_a = 0;
+    ll num_b = 0;
+    for (; d >= 8; d--) {
+        num_a = (32 * len_a + d - 1) / d;
+        num_b = (32 * len_b + d - 1) / d;
+        if (CeilLog2(std::min(num_a, num_b)) + 2 * d <= 63 && num_a + num_b - 1 <= kMaxN) {
+            break;
+        }
+    }
+    if (d < 8) {
+        throw std::length_error("operands are too large for the NTT multiplication");
+    }
+
+    ll num_c = num_a + num_b - 1;
+    const NttCrt& engine = Engine(1LL << CeilLog2(num_c));
+
+    // 2 乗の場合は同じ桁の列を渡し，NttCrt に変換を 1 回で済ませさせる
+    AlignedVector<ll> da(num_a);
+    AlignedVector<ll> dc(num_c);
+    SplitDigits(a, len_a, d, num_a, da.data());
+    if (a == b && len_a == len_b) {
+        engine.Mult(da.data(), num_a, da.data(), num_a, dc.data());
+    } else {
+        AlignedVector<ll> db(num_b);
+        SplitDigits(b, len_b, d, num_b, db.data());
+        engine.Mult(da.data(), num_a, db.data(), num_b, dc.data());
+    }
+
+    // 各係数を d ビットずつの部分に分けて列ごとに足し合わせる (桁上がりを伴わず自動ベクトル化できる)
+    ll pieces = (63 + d - 1) / d;
+    u64 mask = (1ULL << d) - 1;
+    AlignedVector<u64> columns(num_c + pieces, 0);
+    for (ll k = 0; k < pieces; k++) {
+        u64 *column = columns.data() + k;
+        ll shift = k * d;
+        for (ll i = 0; i < num_c; i++) {
+            column[i] += (static_cast<u64>(dc[i]) >> shift) & mask;
+        }
+    }
+
+    // 列の和は pieces 2^d 未満と小さいため，桁上げは 1 回の走査で済む
+    ll len_c = len_a + len_b;
+    std::fill(c, c + len_c, 0);
+    u64 carry = 0;
+    u64 acc = 0;
+    ll acc_bits = 0;
+    ll out = 0;
+    for (ll i = 0; i < static_cast<ll>(columns.size()) && out < len_c; i++) {
+        carry += columns[i];
+        acc |= (carry & mask) << acc_bits;
+        carry >>= d;
+        acc_bits += d;
+        if (acc_bits >= 32) {
+            c[out++] = static_cast<u32>(acc);
+            acc >>= 32;
+            acc_bits -= 32;
+        }
+    }
+    while (carry != 0 && out < len_c) {
+        acc |= (carry & mask) << acc_bits;
+        carry >>= d;
+        acc_bits += d;
+        if (acc_bits >= 32) {
+            c[out++] = static_cast<u32>(acc);
+            acc >>= 32;
+            acc_bits -= 32;
+        }
+    }
+    if (acc_bits > 0 && out < len_c) {
+        c[out] = static_cast<u32>(acc);
+    }
+}
+
+/*
+ * 次数が n 以上の NttCrt を返す．
+ *
+ * @param[in] n 必要な次数
+ * @return const NttCrt& 次数 n 以上の NttCrt
+ */
+const NttCrt& BigIntMultiplier::Engine(ll n) {
+    if (engine_ == nullptr || engine_->N() < n) {
+        engine_.reset(new NttCrt(n));
+        engine_->SetThreadPool(pool_);
+    }
+    return *engine_;
+}
+
+} // namespace ntt
@@ -0,0 +1,338 @@
+/**
+ * @file bit_reversal.cpp
+ * @brief ビット反転の並び替えを行うクラスを実装するソースファイル．
+ */
+
+#include "include/bit_reversal.hpp"
+#include "include/workspace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * 並び替えのタイルに用いるスレッドごとの作業領域を返す．
+ *
+ * 変換や畳み込みの作業領域と領域が重ならないよう，別に保持する．
+ *
+ * @return Workspace& 呼び出したスレッドの作業領域
+ */
+Workspace& ReversalWorkspace() {
+    static thread_local Workspace workspace;
+    return workspace;
+}
+
+/*
+ * 要素数 size 以上のタイル用の作業領域を返す．
+ */
+ll *TileBuffer(ll *, ll size) {
+    return ReversalWorkspace().Buffer(0, size);
+}
+
+/*
+ * 要素数 size 以上の 32 ビットのタイル用の作業領域を返す．
+ */
+u32 *TileBuffer(u32 *, ll size) {
+    return ReversalWorkspace().Buffer32(0, size);
+}
+
+/*
+ * 長さ n の数列を，反転したインデックスを 1 ずつ更新しながら並び替えて返す．
+ *
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗)．
+ */
+template <typename T>
+void ReverseIncrementalImpl(T *a, ll n) {
+    ll j = 0;
+    for (ll i = 0; i < n; i++) {
+        if (j > i) {
+            T tmp = a[i];
+            a[i] = a[j];
+            a[j] = tmp;
+        }
+
+        ll m = n >> 1;
+        while (m >= 1 && j >= m) {
+            j -= m;
+            m >>= 1;
+        }
+        j += m;
+    }
+}
+
+/*
+ * 1 辺 side の正方行列 src を転置して dst に返す．
+ */
+template <typename T>
+void TransposeScalar(const T *src, T *dst, ll side) {
+    for (ll i = 0; i < side; i++) {
+        for (ll j = 0; j < side; j++) {
+            dst[j * side + i] = src[i * side + j];
+        }
+    }
+}
+
+/*
+ * AVX2 で 1 辺 side (4 の倍数) の正方行列 src を 4x4 の小行列ごとに転置して dst に返す．
+ */
+__attribute__((target("avx2")))
+void TransposeAvx2(const ll *src, ll *dst, ll side) {
+    for (ll bi = 0; bi < side; bi += 4) {
+        for (ll bj = 0; bj < side; bj += 4) {
+            const ll *s = src + bi * side + bj;
+            __m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+            __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + side));
+            __m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + 2 * side));
+            __m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + 3 * side));
+
+            // 128 ビットのレーン内で 2x2 の転置を行い，レーンを入れ替える
+            __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+            __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+            __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+            __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+
+            ll *d = dst + bj * side + bi;
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(d),
+                                _mm256_permute2x128_si256(t0, t2, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + side),
+                                _mm256_permute2x128_si256(t1, t3, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + 2 * side),
+                                _mm256_permute2x128_si256(t0, t2, 0x31));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + 3 * side),
+                                _mm256_permute2x128_si256(t1, t3, 0x31));
+        }
+    }
+}
+
+/*
+ * AVX2 で 1 辺 side (8 の倍数) の正方行列 src を 8x8 の小行列ごとに転置して dst に返す．
+ */
+__attribute__((target("avx2")))
+void TransposeAvx2(const u32 *src, u32 *dst, ll side) {
+    for (ll bi = 0; bi < side; bi += 8) {
+        for (ll bj = 0; bj < side; bj += 8) {
+            const u32 *s = src + bi * side + bj;
+            __m256i r[8];
+            for (ll i = 0; i < 8; i++) {
+                r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i * side));
+            }
+
+            // 32 ビット, 64 ビット単位の組み替えで 128 ビットのレーン内の 4x4 を転置する
+            __m256i t[8];
+            for (ll i = 0; i < 8; i += 2) {
+                t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+                t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+            }
+            __m256i u[8];
+            for (ll i = 0; i < 8; i += 4) {
+                u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+                u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+                u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+                u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+            }
+
+            // 上下 4 行のレーンを入れ替える
+            u32 *d = dst + bj * side + bi;
+            for (ll i = 0; i < 4; i++) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + i * side),
+                                    _mm256_permute2x128_si256(u[i], u[i + 4], 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + (i + 4) * side),
+                                    _mm256_permute2x128_si256(u[i], u[i + 4], 0x31));
+            }
+        }
+    }
+}
+
+/*
+ * 実行環境で AVX2 が使える場合 true を返す．
+ */
+bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] log_n 扱う最大の数列の長さが 2 の何乗か．
+ */
+BitReversal::BitReversal(ll log_n) : log_n_(log_n), half_bits_((log_n + 1) / 2) {
+    if (log_n_ < 0 || log_n_ > 48) {
+        throw std::invalid_argument("log_n must be in [0, 48]");
+    }
+
+    ll n = 1LL << half_bits_;
+    table_.assign(n, 0);
+    for (ll i = 1; i < n; i++) {
+        table_[i] = (table_[i >> 1] >> 1) | static_cast<u32>((i & 1) << (half_bits_ - 1));
+    }
+}
+
+/*
+ * 長さ 2^log_m の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か．
+ * @param[in] method 並び替えの方法．
+ */
+void BitReversal::Reverse(ll *a, ll log_m, Method method) const {
+    ReverseImpl(a, log_m, method);
+}
+
+/*
+ * 32 ビットで格納した長さ 2^log_m の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か．
+ * @param[in] method 並び替えの方法．
+ */
+void BitReversal::Reverse(u32 *a, ll log_m, Method method) const {
+    ReverseImpl(a, log_m, method);
+}
+
+/*
+ * テーブルを用いずに長さ n の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗)．
+ */
+void BitReversal::ReverseIncremental(ll *a, ll n) {
+    ReverseIncrementalImpl(a, n);
+}
+
+/*
+ * テーブルを用いずに 32 ビットで格納した長さ n の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗)．
+ */
+void BitReversal::ReverseIncremental(u32 *a, ll n) {
+    ReverseIncrementalImpl(a, n);
+}
+
+/*
+ * 長さ 2^log_m の数列をビット反転で並び替えて返す．
+ *
+ * タイルの 1 辺が 8 要素に満たない短い数列ではテーブルを引く方法を用いる．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ * @param[in] method 並び替えの方法
+ */
+template <typename T>
+void BitReversal::ReverseImpl(T *a, ll log_m, Method method) const {
+    if (log_m > log_n_) {
+        throw std::invalid_argument("log_m must not exceed log_n");
+    }
+
+    ll q = std::min(kMaxLogTile, log_m / 2);
+    switch (method) {
+    case Method::kIncremental:
+        ReverseIncrementalImpl(a, 1LL << log_m);
+        break;
+    case Method::kTable:
+        ReverseTable(a, log_m);
+        break;
+    case Method::kBlocked:
+    case Method::kBlockedSimd:
+        if (q < 3) {
+            ReverseTable(a, log_m);
+        } else {
+            ReverseBlocked(a, log_m, q, method == Method::kBlockedSimd && HasAvx2());
+        }
+        break;
+    }
+}
+
+/*
+ * テーブルを引いて長さ 2^log_m の数列をビット反転で並び替えて返す．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+template <typename T>
+void BitReversal::ReverseTable(T *a, ll log_m) const {
+    ll n = 1LL << log_m;
+    for (ll i = 0; i < n; i++) {
+        ll j = Rev(i, log_m);
+        if (j > i) {
+            std::swap(a[i], a[j]);
+        }
+    }
+}
+
+/*
+ * 2^q x 2^q のタイルごとに転置して長さ 2^log_m の数列をビット反転で並び替えて返す．
+ *
+ * インデックスを x = (h, b, l) (h, l は q ビット) と分けると，反転後の位置は
+ * (rev(l), rev(b), rev(h)) となる．中位 b ごとに，行 rev(h) に a[(h, b, *)] を
+ * 並べたタイルを作って転置すると，行 l が a[(rev(l), rev(b), *)] にそのまま書ける．
+ * b と rev(b) のタイルを両方読んでから書くため，その場で並び替えられる．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．並び替えた数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か (2q 以上)
+ * @param[in] q タイルの 1 辺の長さが 2 の何乗か
+ * @param[in] simd AVX2 で転置する場合 true
+ */
+template <typename T>
+void BitReversal::ReverseBlocked(T *a, ll log_m, ll q, bool simd) const {
+    ll side = 1LL << q;
+    ll tile = side * side;
+    ll mid_bits = log_m - 2 * q;
+    ll high_shift = log_m - q;
+    ll num_mid = 1LL << mid_bits;
+
+    T *buffer = TileBuffer(a, 3 * tile);
+    T *tile_b = buffer;
+    T *tile_rb = buffer + tile;
+    T *transposed = buffer + 2 * tile;
+
+    auto load = [&](ll b, T *dst) {
+        for (ll h = 0; h < side; h++) {
+            std::memcpy(dst + Rev(h, q) * side, a + (h << high_shift) + (b << q),
+                        side * sizeof(T));
+        }
+    };
+    auto store = [&](const T *src, ll rb) {
+        if (simd) {
+            TransposeAvx2(src, transposed, side);
+        } else {
+            TransposeScalar(src, transposed, side);
+        }
+        for (ll l = 0; l < side; l++) {
+            std::memcpy(a + (Rev(l, q) << high_shift) + (rb << q), transposed + l * side,
+                        side * sizeof(T));
+        }
+    };
+
+    for (ll b = 0; b < num_mid; b++) {
+        ll rb = Rev(b, mid_bits);
+        if (rb < b) {
+            continue;
+        }
+
+        load(b, tile_b);
+        if (rb != b) {
+            load(rb, tile_rb);
+        }
+        store(tile_b, rb);
+        if (rb != b) {
+            store(tile_rb, b);
+        }
+    }
+}
+
+} // namespace ntt
@@ -4,6 +4,7 @@
  */
 
 #include "include/montgomery.hpp"
+#include <stdexcept>
 
 /*
  * Number theoretic transform 向け名前空間
@@ -51,6 +52,16 @@ ll Montgomery::Reduction(ll t) const {
     return (t >= n_) ? t - n_ : t;
 }
 
+/*
+ * モンゴメリ表現 (aR mod N) に変換して返す．
+ *
+ * @param [in] a 値
+ * @return ll a のモンゴメリ表現
+ */
+ll Montgomery::ToMontgomery(ll a) const {
+    return Reduction(a * r2_);
+}
+
 /*
  * mod N で積を計算して返す．
  *
@@ -93,4 +104,48 @@ ll Montgomery::Pow(ll a, ll k) const {
     return v;
 }
 
+/*
+ * コンストラクタ．
+ *
+ * @param[in] n モジュラスN (3 以上 2^62 未満の奇数)
+ */
+Montgomery64::Montgomery64(ll n) : n_(n) {
+    // 偶数の N は 2^64 と互いに素でなく，N^-1 mod 2^64 が存在しない
+    if (n < 3 || n >= (1LL << 62) || (n & 1) == 0) {
+        throw std::invalid_argument("n must be an odd integer in [3, 2^62)");
+    }
+
+    // ニュートン法で N^-1 mod 2^64 を求める (各反復で正しいビット数が 2 倍になる)
+    std::uint64_t inv = n_;
+    for (int i = 0; i < 5; i++) {
+        inv *= 2 - n_ * inv;
+    }
+    nn_ = -inv;
+
+    u128 r = (static_cast<u128>(1) << 64) % n_;
+    r2_ = static_cast<std::uint64_t>((r * r) % n_);
+}
+
+/*
+ * mod N でべき乗を計算して返す．
+ *
+ * @param[in] a 基数
+ * @param[in] k 指数
+ * @return ll a の k 乗
+ */
+ll Montgomery64::Pow(ll a, ll k) const {
+    ll mr_p = ToMontgomery(a % N());
+    ll mr_v = ToMontgomery(1);
+
+    while (k >= 1) {
+        if ((k & 1) == 1) {
+            mr_v = MultReduction(mr_v, mr_p);
+        }
+        k >>= 1;
+        mr_p = MultReduction(mr_p, mr_p);
+    }
+
+    return Reduction(mr_v);
+}
+
 } // namespace ntt
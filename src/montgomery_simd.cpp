@@ -0,0 +1,694 @@
+/**
+ * @file montgomery_simd.cpp
+ * @brief SIMD 命令を使ったモンゴメリ乗算を実装するためのソースファイル．
+ */
+
+#include "include/montgomery_simd.hpp"
+#include <immintrin.h>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * AVX2 でモンゴメリリダクションを計算して返す．
+ *
+ * @param [in] t リダクションを計算する値 (各レーン N^2 未満)
+ * @param [in] vn モジュラス N
+ * @param [in] vn1 N - 1
+ * @param [in] vnn N'
+ * @param [in] vmask R - 1
+ * @param [in] shift R が 2 の何乗か
+ * @return __m256i [0, N) の範囲のモンゴメリリダクション
+ */
+__attribute__((target("avx2")))
+inline __m256i ReductionAvx2(__m256i t, __m256i vn, __m256i vn1, __m256i vnn,
+                             __m256i vmask, __m128i shift) {
+    __m256i m = _mm256_and_si256(_mm256_mul_epu32(t, vnn), vmask);
+    __m256i u = _mm256_srl_epi64(_mm256_add_epi64(t, _mm256_mul_epu32(m, vn)), shift);
+    return _mm256_sub_epi64(u, _mm256_and_si256(_mm256_cmpgt_epi64(u, vn1), vn));
+}
+
+/*
+ * AVX2 で [0, 2N) の値を [0, N) に縮約して返す．
+ *
+ * @param [in] u 値
+ * @param [in] vn モジュラス N
+ * @param [in] vn1 N - 1
+ * @return __m256i [0, N) の範囲の値
+ */
+__attribute__((target("avx2")))
+inline __m256i ReduceOnceAvx2(__m256i u, __m256i vn, __m256i vn1) {
+    return _mm256_sub_epi64(u, _mm256_and_si256(_mm256_cmpgt_epi64(u, vn1), vn));
+}
+
+/*
+ * AVX2 で 64 ビットの要素を 4 個読み込む．
+ */
+__attribute__((target("avx2")))
+inline __m256i LoadAvx2(const ll *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+/*
+ * AVX2 で 32 ビットの要素を 4 個読み込み，64 ビットに拡張する．
+ */
+__attribute__((target("avx2")))
+inline __m256i LoadAvx2(const u32 *p) {
+    return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+}
+
+/*
+ * AVX2 で 64 ビットの要素を 4 個書き込む．
+ */
+__attribute__((target("avx2")))
+inline void StoreAvx2(ll *p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+/*
+ * AVX2 で 64 ビットの各レーンの下位 32 ビットを 4 個書き込む．
+ */
+__attribute__((target("avx2")))
+inline void StoreAvx2(u32 *p, __m256i v) {
+    const __m256i index = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    __m256i packed = _mm256_permutevar8x32_epi32(v, index);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_castsi256_si128(packed));
+}
+
+/*
+ * AVX2 で第 l 段のバタフライ演算を実行する．
+ */
+template <typename T>
+__attribute__((target("avx2")))
+void ButterflyStageAvx2(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                        const ll *w, const Montgomery& montgomery) {
+    const __m256i vn = _mm256_set1_epi64x(montgomery.N());
+    const __m256i vn1 = _mm256_set1_epi64x(montgomery.N() - 1);
+    const __m256i vnn = _mm256_set1_epi64x(montgomery.Nn());
+    const __m256i vmask = _mm256_set1_epi64x((1LL << montgomery.Log2R()) - 1);
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll max_r = (1LL << (l - 1));
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r += 4) {
+            __m256i va = LoadAvx2(x + r);
+            __m256i vb = LoadAvx2(y + r);
+            __m256i vw = LoadAvx2(w + r);
+
+            __m256i vt = ReductionAvx2(_mm256_mul_epu32(vw, vb), vn, vn1, vnn, vmask, shift);
+            __m256i vsum = ReduceOnceAvx2(_mm256_add_epi64(va, vt), vn, vn1);
+            __m256i vdiff = ReduceOnceAvx2(_mm256_add_epi64(va, _mm256_sub_epi64(vn, vt)), vn, vn1);
+
+            StoreAvx2(x + r, vsum);
+            StoreAvx2(y + r, vdiff);
+        }
+    }
+}
+
+/*
+ * AVX2 で第 l 段の周波数間引きのバタフライ演算を実行する．
+ */
+template <typename T>
+__attribute__((target("avx2")))
+void ButterflyStageDifAvx2(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                           const ll *w, const Montgomery& montgomery) {
+    const __m256i vn = _mm256_set1_epi64x(montgomery.N());
+    const __m256i vn1 = _mm256_set1_epi64x(montgomery.N() - 1);
+    const __m256i vnn = _mm256_set1_epi64x(montgomery.Nn());
+    const __m256i vmask = _mm256_set1_epi64x((1LL << montgomery.Log2R()) - 1);
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll max_r = (1LL << (l - 1));
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r += 4) {
+            __m256i va = LoadAvx2(x + r);
+            __m256i vb = LoadAvx2(y + r);
+            __m256i vw = LoadAvx2(w + r);
+
+            __m256i vsum = ReduceOnceAvx2(_mm256_add_epi64(va, vb), vn, vn1);
+            __m256i vdiff = ReduceOnceAvx2(_mm256_add_epi64(va, _mm256_sub_epi64(vn, vb)), vn, vn1);
+            __m256i vt = ReductionAvx2(_mm256_mul_epu32(vw, vdiff), vn, vn1, vnn, vmask, shift);
+
+            StoreAvx2(x + r, vsum);
+            StoreAvx2(y + r, vt);
+        }
+    }
+}
+
+/*
+ * AVX2 で要素ごとの積のリダクションを計算する．
+ *
+ * is_normal が true の場合は R^2 を掛けてもう一度リダクションし，通常の表現の積を返す．
+ *
+ * @return ll 処理した要素数
+ */
+template <typename T>
+__attribute__((target("avx2")))
+ll MultVecAvx2(const T *a, const T *b, T *c, ll n, bool is_normal,
+               const Montgomery& montgomery) {
+    const __m256i vn = _mm256_set1_epi64x(montgomery.N());
+    const __m256i vn1 = _mm256_set1_epi64x(montgomery.N() - 1);
+    const __m256i vnn = _mm256_set1_epi64x(montgomery.Nn());
+    const __m256i vmask = _mm256_set1_epi64x((1LL << montgomery.Log2R()) - 1);
+    const __m256i vr2 = _mm256_set1_epi64x(montgomery.R2());
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = LoadAvx2(a + i);
+        __m256i vb = LoadAvx2(b + i);
+        __m256i vc = ReductionAvx2(_mm256_mul_epu32(va, vb), vn, vn1, vnn, vmask, shift);
+        if (is_normal) {
+            vc = ReductionAvx2(_mm256_mul_epu32(vc, vr2), vn, vn1, vnn, vmask, shift);
+        }
+        StoreAvx2(c + i, vc);
+    }
+    return i;
+}
+
+/*
+ * AVX2 で要素ごとの 2 乗のリダクションをその場で計算する．
+ *
+ * @return ll 処理した要素数
+ */
+template <typename T>
+__attribute__((target("avx2")))
+ll SquareVecAvx2(T *a, ll n, const Montgomery& montgomery) {
+    const __m256i vn = _mm256_set1_epi64x(montgomery.N());
+    const __m256i vn1 = _mm256_set1_epi64x(montgomery.N() - 1);
+    const __m256i vnn = _mm256_set1_epi64x(montgomery.Nn());
+    const __m256i vmask = _mm256_set1_epi64x((1LL << montgomery.Log2R()) - 1);
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = LoadAvx2(a + i);
+        StoreAvx2(a + i, ReductionAvx2(_mm256_mul_epu32(va, va), vn, vn1, vnn, vmask, shift));
+    }
+    return i;
+}
+
+// GCC 12 は AVX-512 の組み込み関数内部の未定義値 (_mm512_undefined_epi32) を
+// 未初期化変数として誤検知するため，AVX-512 の実装に限って警告を抑止する．
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/*
+ * AVX-512 でモンゴメリリダクションを計算して返す．
+ *
+ * @param [in] t リダクションを計算する値 (各レーン N^2 未満)
+ * @param [in] vn モジュラス N
+ * @param [in] vnn N'
+ * @param [in] vmask R - 1
+ * @param [in] shift R が 2 の何乗か
+ * @return __m512i [0, N) の範囲のモンゴメリリダクション
+ */
+__attribute__((target("avx512f")))
+inline __m512i ReductionAvx512(__m512i t, __m512i vn, __m512i vnn, __m512i vmask,
+                               __m128i shift) {
+    __m512i m = _mm512_and_si512(_mm512_mul_epu32(t, vnn), vmask);
+    __m512i u = _mm512_srl_epi64(_mm512_add_epi64(t, _mm512_mul_epu32(m, vn)), shift);
+    return _mm512_mask_sub_epi64(u, _mm512_cmpge_epu64_mask(u, vn), u, vn);
+}
+
+/*
+ * AVX-512 で [0, 2N) の値を [0, N) に縮約して返す．
+ *
+ * @param [in] u 値
+ * @param [in] vn モジュラス N
+ * @return __m512i [0, N) の範囲の値
+ */
+__attribute__((target("avx512f")))
+inline __m512i ReduceOnceAvx512(__m512i u, __m512i vn) {
+    return _mm512_mask_sub_epi64(u, _mm512_cmpge_epu64_mask(u, vn), u, vn);
+}
+
+/*
+ * AVX-512 で 64 ビットの要素を 8 個読み込む．
+ */
+__attribute__((target("avx512f")))
+inline __m512i LoadAvx512(const ll *p) {
+    return _mm512_loadu_si512(p);
+}
+
+/*
+ * AVX-512 で 32 ビットの要素を 8 個読み込み，64 ビットに拡張する．
+ */
+__attribute__((target("avx512f")))
+inline __m512i LoadAvx512(const u32 *p) {
+    return _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+}
+
+/*
+ * AVX-512 で 64 ビットの要素を 8 個書き込む．
+ */
+__attribute__((target("avx512f")))
+inline void StoreAvx512(ll *p, __m512i v) {
+    _mm512_storeu_si512(p, v);
+}
+
+/*
+ * AVX-512 で 64 ビットの各レーンの下位 32 ビットを 8 個書き込む．
+ */
+__attribute__((target("avx512f")))
+inline void StoreAvx512(u32 *p, __m512i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm512_cvtepi64_epi32(v));
+}
+
+/*
+ * AVX-512 で第 l 段のバタフライ演算を実行する．
+ */
+template <typename T>
+__attribute__((target("avx512f")))
+void ButterflyStageAvx512(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                          const ll *w, const Montgomery& montgomery) {
+    const __m512i vn = _mm512_set1_epi64(montgomery.N());
+    const __m512i vnn = _mm512_set1_epi64(montgomery.Nn());
+    const __m512i vmask = _mm512_set1_epi64((1LL << montgomery.Log2R()) - 1);
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll max_r = (1LL << (l - 1));
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r += 8) {
+            __m512i va = LoadAvx512(x + r);
+            __m512i vb = LoadAvx512(y + r);
+            __m512i vw = LoadAvx512(w + r);
+
+            __m512i vt = ReductionAvx512(_mm512_mul_epu32(vw, vb), vn, vnn, vmask, shift);
+            __m512i vsum = ReduceOnceAvx512(_mm512_add_epi64(va, vt), vn);
+            __m512i vdiff = ReduceOnceAvx512(_mm512_add_epi64(va, _mm512_sub_epi64(vn, vt)), vn);
+
+            StoreAvx512(x + r, vsum);
+            StoreAvx512(y + r, vdiff);
+        }
+    }
+}
+
+/*
+ * AVX-512 で第 l 段の周波数間引きのバタフライ演算を実行する．
+ */
+template <typename T>
+__attribute__((target("avx512f")))
+void ButterflyStageDifAvx512(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                             const ll *w, const Montgomery& montgomery) {
+    const __m512i vn = _mm512_set1_epi64(montgomery.N());
+    const __m512i vnn = _mm512_set1_epi64(montgomery.Nn());
+    const __m512i vmask = _mm512_set1_epi64((1LL << montgomery.Log2R()) - 1);
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll max_r = (1LL << (l - 1));
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r += 8) {
+            __m512i va = LoadAvx512(x + r);
+            __m512i vb = LoadAvx512(y + r);
+            __m512i vw = LoadAvx512(w + r);
+
+            __m512i vsum = ReduceOnceAvx512(_mm512_add_epi64(va, vb), vn);
+            __m512i vdiff = ReduceOnceAvx512(_mm512_add_epi64(va, _mm512_sub_epi64(vn, vb)), vn);
+            __m512i vt = ReductionAvx512(_mm512_mul_epu32(vw, vdiff), vn, vnn, vmask, shift);
+
+            StoreAvx512(x + r, vsum);
+            StoreAvx512(y + r, vt);
+        }
+    }
+}
+
+/*
+ * AVX-512 で要素ごとの積のリダクションを計算する．
+ *
+ * @return ll 処理した要素数
+ */
+template <typename T>
+__attribute__((target("avx512f")))
+ll MultVecAvx512(const T *a, const T *b, T *c, ll n, bool is_normal,
+                 const Montgomery& montgomery) {
+    const __m512i vn = _mm512_set1_epi64(montgomery.N());
+    const __m512i vnn = _mm512_set1_epi64(montgomery.Nn());
+    const __m512i vmask = _mm512_set1_epi64((1LL << montgomery.Log2R()) - 1);
+    const __m512i vr2 = _mm512_set1_epi64(montgomery.R2());
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i va = LoadAvx512(a + i);
+        __m512i vb = LoadAvx512(b + i);
+        __m512i vc = ReductionAvx512(_mm512_mul_epu32(va, vb), vn, vnn, vmask, shift);
+        if (is_normal) {
+            vc = ReductionAvx512(_mm512_mul_epu32(vc, vr2), vn, vnn, vmask, shift);
+        }
+        StoreAvx512(c + i, vc);
+    }
+    return i;
+}
+
+/*
+ * AVX-512 で要素ごとの 2 乗のリダクションをその場で計算する．
+ *
+ * @return ll 処理した要素数
+ */
+template <typename T>
+__attribute__((target("avx512f")))
+ll SquareVecAvx512(T *a, ll n, const Montgomery& montgomery) {
+    const __m512i vn = _mm512_set1_epi64(montgomery.N());
+    const __m512i vnn = _mm512_set1_epi64(montgomery.Nn());
+    const __m512i vmask = _mm512_set1_epi64((1LL << montgomery.Log2R()) - 1);
+    const __m128i shift = _mm_cvtsi64_si128(montgomery.Log2R());
+
+    ll i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i va = LoadAvx512(a + i);
+        StoreAvx512(a + i, ReductionAvx512(_mm512_mul_epu32(va, va), vn, vnn, vmask, shift));
+    }
+    return i;
+}
+
+#pragma GCC diagnostic pop
+
+/*
+ * 第 l 段のバタフライ演算を実行する．
+ */
+template <typename T>
+void ButterflyStageImpl(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                        const ll *w, const Montgomery& montgomery, MontgomerySimd::Isa isa,
+                        ll lanes) {
+    if ((r_end - r_begin) % lanes == 0) {
+        if (isa == MontgomerySimd::Isa::kAvx512) {
+            ButterflyStageAvx512(a, l, q_begin, q_end, r_begin, r_end, w, montgomery);
+            return;
+        }
+        if (isa == MontgomerySimd::Isa::kAvx2) {
+            ButterflyStageAvx2(a, l, q_begin, q_end, r_begin, r_end, w, montgomery);
+            return;
+        }
+    }
+
+    ll n = montgomery.N();
+    ll max_r = (1LL << (l - 1));
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r++) {
+            ll tmp = montgomery.Reduction(w[r] * static_cast<ll>(y[r]));
+            ll diff = x[r] + n - tmp;
+            ll sum = x[r] + tmp;
+            y[r] = (diff >= n) ? diff - n : diff;
+            x[r] = (sum >= n) ? sum - n : sum;
+        }
+    }
+}
+
+/*
+ * 第 l 段の周波数間引きのバタフライ演算を実行する．
+ */
+template <typename T>
+void ButterflyStageDifImpl(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                           const ll *w, const Montgomery& montgomery, MontgomerySimd::Isa isa,
+                           ll lanes) {
+    if ((r_end - r_begin) % lanes == 0) {
+        if (isa == MontgomerySimd::Isa::kAvx512) {
+            ButterflyStageDifAvx512(a, l, q_begin, q_end, r_begin, r_end, w, montgomery);
+            return;
+        }
+        if (isa == MontgomerySimd::Isa::kAvx2) {
+            ButterflyStageDifAvx2(a, l, q_begin, q_end, r_begin, r_end, w, montgomery);
+            return;
+        }
+    }
+
+    ll n = montgomery.N();
+    ll max_r = (1LL << (l - 1));
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r++) {
+            ll sum = x[r] + y[r];
+            ll diff = x[r] + n - y[r];
+            diff = (diff >= n) ? diff - n : diff;
+            x[r] = (sum >= n) ? sum - n : sum;
+            y[r] = montgomery.Reduction(w[r] * diff);
+        }
+    }
+}
+
+/*
+ * 数列の要素ごとの積を mod N で計算する．
+ * is_normal が false の場合はリダクションを 1 回だけ行い，abR^-1 mod N を返す．
+ */
+template <typename T>
+void MultVecImpl(const T *a, const T *b, T *c, ll n, bool is_normal,
+                 const Montgomery& montgomery, MontgomerySimd::Isa isa) {
+    ll i = 0;
+    if (isa == MontgomerySimd::Isa::kAvx512) {
+        i = MultVecAvx512(a, b, c, n, is_normal, montgomery);
+    } else if (isa == MontgomerySimd::Isa::kAvx2) {
+        i = MultVecAvx2(a, b, c, n, is_normal, montgomery);
+    }
+
+    for (; i < n; i++) {
+        ll t = montgomery.Reduction(static_cast<ll>(a[i]) * b[i]);
+        c[i] = is_normal ? montgomery.Reduction(t * montgomery.R2()) : t;
+    }
+}
+
+/*
+ * 数列の要素ごとの 2 乗のリダクションをその場で計算する．
+ * 各要素を 1 回だけ読み込み，a^2 R^-1 mod N を返す．
+ */
+template <typename T>
+void SquareVecImpl(T *a, ll n, const Montgomery& montgomery, MontgomerySimd::Isa isa) {
+    ll i = 0;
+    if (isa == MontgomerySimd::Isa::kAvx512) {
+        i = SquareVecAvx512(a, n, montgomery);
+    } else if (isa == MontgomerySimd::Isa::kAvx2) {
+        i = SquareVecAvx2(a, n, montgomery);
+    }
+
+    for (; i < n; i++) {
+        a[i] = montgomery.Reduction(static_cast<ll>(a[i]) * a[i]);
+    }
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．実行環境で使える最も幅の広い命令セットを選ぶ．
+ *
+ * @param [in] montgomery モンゴメリ乗算
+ */
+MontgomerySimd::MontgomerySimd(const Montgomery& montgomery) :
+        MontgomerySimd(montgomery, DetectIsa()) {}
+
+/*
+ * コンストラクタ．
+ *
+ * @param [in] montgomery モンゴメリ乗算
+ * @param [in] isa 命令セット (実行環境で使えるものに限る)
+ */
+MontgomerySimd::MontgomerySimd(const Montgomery& montgomery, Isa isa) :
+        montgomery_(montgomery), isa_(isa) {
+    // 使えない命令を選ぶと，最初の演算で不正命令例外 (SIGILL) となる
+    if (!Supports(isa)) {
+        throw std::invalid_argument("isa is not supported by this CPU");
+    }
+}
+
+/*
+ * 実行環境で使える最も幅の広い命令セットを返す．
+ *
+ * @return Isa 命令セット
+ */
+MontgomerySimd::Isa MontgomerySimd::DetectIsa() {
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::kAvx2;
+    }
+    return Isa::kScalar;
+}
+
+/*
+ * 命令セットが実行環境で使えるかを返す．
+ *
+ * @param [in] isa 命令セット
+ * @return bool 使える場合 true
+ */
+bool MontgomerySimd::Supports(Isa isa) {
+    switch (isa) {
+    case Isa::kScalar:
+        return true;
+    case Isa::kAvx2:
+        return __builtin_cpu_supports("avx2");
+    case Isa::kAvx512:
+        return __builtin_cpu_supports("avx512f");
+    default:
+        return false;
+    }
+}
+
+/*
+ * 1 命令で処理する要素数を返す．
+ *
+ * @return ll レーン数
+ */
+ll MontgomerySimd::Lanes() const {
+    switch (isa_) {
+    case Isa::kAvx512:
+        return 8;
+    case Isa::kAvx2:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+/*
+ * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param [in, out] a 数列．変換後の数列を上書きして返す．
+ * @param [in] l 段
+ * @param [in] q_begin q の開始
+ * @param [in] q_end q の終了
+ * @param [in] r_begin r の開始
+ * @param [in] r_end r の終了
+ * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+ */
+void MontgomerySimd::ButterflyStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    const ll *w) const {
+    ButterflyStageImpl(a, l, q_begin, q_end, r_begin, r_end, w, montgomery_, isa_, Lanes());
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段のバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param [in, out] a 数列．変換後の数列を上書きして返す．
+ * @param [in] l 段
+ * @param [in] q_begin q の開始
+ * @param [in] q_end q の終了
+ * @param [in] r_begin r の開始
+ * @param [in] r_end r の終了
+ * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+ */
+void MontgomerySimd::ButterflyStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                    const ll *w) const {
+    ButterflyStageImpl(a, l, q_begin, q_end, r_begin, r_end, w, montgomery_, isa_, Lanes());
+}
+
+/*
+ * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param [in, out] a 数列．変換後の数列を上書きして返す．
+ * @param [in] l 段
+ * @param [in] q_begin q の開始
+ * @param [in] q_end q の終了
+ * @param [in] r_begin r の開始
+ * @param [in] r_end r の終了
+ * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+ */
+void MontgomerySimd::ButterflyStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                       const ll *w) const {
+    ButterflyStageDifImpl(a, l, q_begin, q_end, r_begin, r_end, w, montgomery_, isa_, Lanes());
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param [in, out] a 数列．変換後の数列を上書きして返す．
+ * @param [in] l 段
+ * @param [in] q_begin q の開始
+ * @param [in] q_end q の終了
+ * @param [in] r_begin r の開始
+ * @param [in] r_end r の終了
+ * @param [in] w 第 l 段の回転因子 (モンゴメリ表現)
+ */
+void MontgomerySimd::ButterflyStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                       const ll *w) const {
+    ButterflyStageDifImpl(a, l, q_begin, q_end, r_begin, r_end, w, montgomery_, isa_, Lanes());
+}
+
+/*
+ * 数列の要素ごとの積を mod N で計算して返す．
+ *
+ * @param [in] a 数列
+ * @param [in] b 数列
+ * @param [out] c 数列 a と b の要素ごとの積
+ * @param [in] n 数列の長さ
+ */
+void MontgomerySimd::MultVec(const ll *a, const ll *b, ll *c, ll n) const {
+    MultVecImpl(a, b, c, n, true, montgomery_, isa_);
+}
+
+/*
+ * 32 ビットで格納した数列の要素ごとの積を mod N で計算して返す．
+ *
+ * @param [in] a 数列
+ * @param [in] b 数列
+ * @param [out] c 数列 a と b の要素ごとの積
+ * @param [in] n 数列の長さ
+ */
+void MontgomerySimd::MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const {
+    MultVecImpl(a, b, c, n, true, montgomery_, isa_);
+}
+
+/*
+ * 数列の要素ごとの積のモンゴメリリダクションを計算して返す．
+ *
+ * @param [in] a 数列
+ * @param [in] b 数列
+ * @param [out] c 数列 a と b の要素ごとの積のリダクション
+ * @param [in] n 数列の長さ
+ */
+void MontgomerySimd::ReductionVec(const ll *a, const ll *b, ll *c, ll n) const {
+    MultVecImpl(a, b, c, n, false, montgomery_, isa_);
+}
+
+/*
+ * 32 ビットで格納した数列の要素ごとの積のモンゴメリリダクションを計算して返す．
+ *
+ * @param [in] a 数列
+ * @param [in] b 数列
+ * @param [out] c 数列 a と b の要素ごとの積のリダクション
+ * @param [in] n 数列の長さ
+ */
+void MontgomerySimd::ReductionVec(const u32 *a, const u32 *b, u32 *c, ll n) const {
+    MultVecImpl(a, b, c, n, false, montgomery_, isa_);
+}
+
+/*
+ * 数列の要素ごとの 2 乗のモンゴメリリダクションをその場で計算して返す．
+ *
+ * @param [in, out] a 数列．要素ごとの 2 乗のリダクションを上書きして返す．
+ * @param [in] n 数列の長さ
+ */
+void MontgomerySimd::SquareReductionVec(ll *a, ll n) const {
+    SquareVecImpl(a, n, montgomery_, isa_);
+}
+
+/*
+ * 32 ビットで格納した数列の要素ごとの 2 乗のモンゴメリリダクションをその場で計算して返す．
+ *
+ * @param [in, out] a 数列．要素ごとの 2 乗のリダクションを上書きして返す．
+ * @param [in] n 数列の長さ
+ */
+void MontgomerySimd::SquareReductionVec(u32 *a, ll n) const {
+    SquareVecImpl(a, n, montgomery_, isa_);
+}
+
+} // namespace ntt
@@ -4,37 +4,258 @@
  */
 
 #include "include/ntt.hpp"
+#include "include/shoup.hpp"
+#include "include/util.hpp"
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 /*
  * Number theoretic transform 向け名前空間
  */
 namespace ntt {
 
+namespace {
+
 /*
- * 数列をビット反転で並び替えて返す．
+ * 変換の内部で用いるスレッドごとの作業領域を返す．
  *
- * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * 畳み込みに渡される作業領域と領域が重ならないよう，別に保持する．
+ *
+ * @return Workspace& 呼び出したスレッドの作業領域
  */
-void Ntt::Reverse(ll *a) const {
-    ll j = 0;
-    ll n = N();
-    for (ll i = 0; i < n; i++) {
-        if (j > i) {
-            ll tmp = a[i];
-            a[i] = a[j];
-            a[j] = tmp;
+Workspace& TransformWorkspace() {
+    static thread_local Workspace workspace;
+    return workspace;
+}
+
+/*
+ * 遅延リダクションのバタフライ演算を実行する．
+ *
+ * 入力 x, y が [0, 4p) であれば，出力 x + wy, x - wy + 2p も [0, 4p) である．
+ */
+inline void HarveyButterfly(std::uint64_t& x, std::uint64_t& y, std::uint64_t w,
+                            std::uint64_t w_shoup, std::uint64_t p) {
+    std::uint64_t two_p = 2 * p;
+    std::uint64_t u = (x >= two_p) ? x - two_p : x;
+    std::uint64_t t = MultShoupLazy(y, w, w_shoup, p);
+    x = u + t;
+    y = u + two_p - t;
+}
+
+/*
+ * 周波数間引きの遅延リダクションのバタフライ演算を実行する．
+ *
+ * 入力 x, y が [0, 2p) であれば，出力 x + y, (x - y + 2p) w も [0, 2p) である．
+ */
+inline void HarveyButterflyDif(std::uint64_t& x, std::uint64_t& y, std::uint64_t w,
+                               std::uint64_t w_shoup, std::uint64_t p) {
+    std::uint64_t two_p = 2 * p;
+    std::uint64_t sum = x + y;
+    std::uint64_t diff = x + two_p - y;
+    x = (sum >= two_p) ? sum - two_p : sum;
+    y = MultShoupLazy(diff, w, w_shoup, p);
+}
+
+/*
+ * 第 l 段の周波数間引きの遅延リダクションのバタフライ演算を実行する．
+ */
+template <typename T>
+void HarveyStageDif(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                    const ll *w, const ll *w_shoup, ll mod) {
+    std::uint64_t p = mod;
+    ll max_r = (1LL << (l - 1));
+
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r++) {
+            std::uint64_t u = x[r];
+            std::uint64_t v = y[r];
+            HarveyButterflyDif(u, v, w[r], w_shoup[r], p);
+            x[r] = static_cast<T>(u);
+            y[r] = static_cast<T>(v);
+        }
+    }
+}
+
+/*
+ * 第 l + 1 段と第 l 段の周波数間引きの遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+ *
+ * w, w_shoup は第 l 段のテーブルの先頭であり，第 l + 1 段のテーブルはその直後に続く．
+ */
+template <typename T>
+void HarveyStageDifPair(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                        const ll *w, const ll *w_shoup, ll mod) {
+    std::uint64_t p = mod;
+    ll h = 1LL << (l - 1);
+    const ll *w2 = w + h;
+    const ll *w2_shoup = w_shoup + h;
+
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << (l + 1));
+        for (ll r = r_begin; r < r_end; r++) {
+            std::uint64_t x0 = x[r];
+            std::uint64_t x1 = x[r + h];
+            std::uint64_t x2 = x[r + 2 * h];
+            std::uint64_t x3 = x[r + 3 * h];
+            HarveyButterflyDif(x0, x2, w2[r], w2_shoup[r], p);
+            HarveyButterflyDif(x1, x3, w2[r + h], w2_shoup[r + h], p);
+            HarveyButterflyDif(x0, x1, w[r], w_shoup[r], p);
+            HarveyButterflyDif(x2, x3, w[r], w_shoup[r], p);
+            x[r] = static_cast<T>(x0);
+            x[r + h] = static_cast<T>(x1);
+            x[r + 2 * h] = static_cast<T>(x2);
+            x[r + 3 * h] = static_cast<T>(x3);
+        }
+    }
+}
+
+/*
+ * 第 l 段の遅延リダクションのバタフライ演算を実行する．
+ */
+template <typename T>
+void HarveyStage(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                 const ll *w, const ll *w_shoup, ll mod) {
+    std::uint64_t p = mod;
+    ll max_r = (1LL << (l - 1));
+
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << l);
+        T *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r++) {
+            std::uint64_t u = x[r];
+            std::uint64_t v = y[r];
+            HarveyButterfly(u, v, w[r], w_shoup[r], p);
+            x[r] = static_cast<T>(u);
+            y[r] = static_cast<T>(v);
+        }
+    }
+}
+
+/*
+ * 第 l 段と第 l + 1 段の遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+ *
+ * w, w_shoup は第 l 段のテーブルの先頭であり，第 l + 1 段のテーブルはその直後に続く．
+ */
+template <typename T>
+void HarveyStagePair(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                     const ll *w, const ll *w_shoup, ll mod) {
+    std::uint64_t p = mod;
+    ll h = 1LL << (l - 1);
+    const ll *w2 = w + h;
+    const ll *w2_shoup = w_shoup + h;
+
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << (l + 1));
+        for (ll r = r_begin; r < r_end; r++) {
+            std::uint64_t x0 = x[r];
+            std::uint64_t x1 = x[r + h];
+            std::uint64_t x2 = x[r + 2 * h];
+            std::uint64_t x3 = x[r + 3 * h];
+            HarveyButterfly(x0, x1, w[r], w_shoup[r], p);
+            HarveyButterfly(x2, x3, w[r], w_shoup[r], p);
+            HarveyButterfly(x0, x2, w2[r], w2_shoup[r], p);
+            HarveyButterfly(x1, x3, w2[r + h], w2_shoup[r + h], p);
+            x[r] = static_cast<T>(x0);
+            x[r + h] = static_cast<T>(x1);
+            x[r + 2 * h] = static_cast<T>(x2);
+            x[r + 3 * h] = static_cast<T>(x3);
         }
+    }
+}
+
+/*
+ * [0, 4p) の数列にスカラーを掛けて [0, p) に正規化する．
+ */
+template <typename T>
+void HarveyMultScalar(T *a, ll m, ll s, ll mod) {
+    std::uint64_t p = mod;
+    std::uint64_t s_shoup = ShoupQuotient(s, p);
+
+    for (ll i = 0; i < m; i++) {
+        a[i] = static_cast<T>(MultShoupReduced(a[i], s, s_shoup, p));
+    }
+}
 
-        ll m = n >> 1;
-        while (m >= 1 && j >= m) {
-            j -= m;
-            m >>= 1;
+/*
+ * [0, 4p) の数列を [0, p) に正規化する．
+ */
+template <typename T>
+void HarveyNormalize(T *a, ll m, ll mod) {
+    for (ll i = 0; i < m; i++) {
+        ll x = a[i];
+        if (x >= 2 * mod) {
+            x -= 2 * mod;
+        }
+        if (x >= mod) {
+            x -= mod;
         }
-        j += m;
+        a[i] = static_cast<T>(x);
     }
 }
 
+} // namespace
+
+/*
+ * 32 ビットで格納した数列の離散フーリエ変換を計算して返す．
+ *
+ * 64 ビットの作業領域に展開して変換する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void Ntt::Dft(u32 *a) const {
+    ll n = N();
+    ll *wide = TransformWorkspace().Buffer(1, n);
+    std::copy(a, a + n, wide);
+    Dft(wide);
+    std::copy(wide, wide + n, a);
+}
+
+/*
+ * 32 ビットで格納した数列の逆離散フーリエ変換を計算して返す．
+ *
+ * 64 ビットの作業領域に展開して変換する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void Ntt::Idft(u32 *a) const {
+    ll n = N();
+    ll *wide = TransformWorkspace().Buffer(1, n);
+    std::copy(a, a + n, wide);
+    Idft(wide);
+    std::copy(wide, wide + n, a);
+}
+
+/*
+ * 数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void Ntt::Reverse(ll *a) const {
+    Reverse(a, N());
+}
+
+/*
+ * 長さ n の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗)．
+ */
+void Ntt::Reverse(ll *a, ll n) const {
+    BitReversal::ReverseIncremental(a, n);
+}
+
+/*
+ * 32 ビットで格納した長さ n の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗)．
+ */
+void Ntt::Reverse(u32 *a, ll n) const {
+    BitReversal::ReverseIncremental(a, n);
+}
+
 /*
  * 数列の要素ごとの積を計算して返す．
  *
@@ -43,7 +264,18 @@ void Ntt::Reverse(ll *a) const {
  * @param[out] c 数列 a と b の要素ごとの積．
  */
 void Ntt::MultVec(ll *a, ll *b, ll *c) const {
-    ll n = N();
+    MultVec(a, b, c, N());
+}
+
+/*
+ * 長さ n の数列の要素ごとの積を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積．
+ * @param[in] n 数列の長さ．
+ */
+void Ntt::MultVec(const ll *a, const ll *b, ll *c, ll n) const {
     ll mod = Mod();
 
     for (ll i = 0; i < n; i++) {
@@ -51,6 +283,22 @@ void Ntt::MultVec(ll *a, ll *b, ll *c) const {
     }
 }
 
+/*
+ * 32 ビットで格納した長さ n の数列の要素ごとの積を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積．
+ * @param[in] n 数列の長さ．
+ */
+void Ntt::MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const {
+    ll mod = Mod();
+
+    for (ll i = 0; i < n; i++) {
+        c[i] = (static_cast<ll>(a[i]) * b[i]) % mod;
+    }
+}
+
 /*
  * 数列の畳み込みを計算して返す．
  *
@@ -59,10 +307,325 @@ void Ntt::MultVec(ll *a, ll *b, ll *c) const {
  * @param[out] c 数列 a と b の畳み込み．
  */
 void Ntt::Mult(ll *a, ll *b, ll *c) const {
-    Dft(a);
-    Dft(b);
-    MultVec(a, b, c);
-    Idft(c);
+    if (a == b) {
+        Square(a, c);
+        return;
+    }
+
+    DftPointwise(a);
+    DftPointwise(b);
+    MultPointwise(a, b, c, N());
+    IdftPointwise(c);
+}
+
+/*
+ * 入力を変更せずに数列の畳み込みを計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void Ntt::Mult(const ll *a, const ll *b, ll *c, Workspace *work) const {
+    if (a == b) {
+        Square(a, c);
+        return;
+    }
+
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll n = N();
+    ll *fb = work->Buffer(0, n);
+    std::copy(b, b + n, fb);
+    if (c != a) {
+        std::copy(a, a + n, c);
+    }
+
+    DftPointwise(c);
+    DftPointwise(fb);
+    MultPointwise(c, fb, c, n);
+    IdftPointwise(c);
+}
+
+/*
+ * 32 ビットで格納した数列の畳み込みを入力を変更せずに計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void Ntt::Mult(const u32 *a, const u32 *b, u32 *c, Workspace *work) const {
+    if (a == b) {
+        Square(a, c);
+        return;
+    }
+
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll n = N();
+    u32 *fb = work->Buffer32(0, n);
+    std::copy(b, b + n, fb);
+    if (c != a) {
+        std::copy(a, a + n, c);
+    }
+
+    DftPointwise(c);
+    DftPointwise(fb);
+    MultPointwise(c, fb, c, n);
+    IdftPointwise(c);
+}
+
+/*
+ * 先頭 len_a, len_b 個の要素のみが非零である数列の畳み込みを計算して返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ (N() 以下)．
+ * @param[in] b 数列 (長さ len_b)．
+ * @param[in] len_b 数列 b の長さ (N() 以下)．
+ * @param[out] c 数列 a と b の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void Ntt::Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c,
+               Workspace *work) const {
+    CheckLength(len_a, len_b);
+    if (len_a <= 0 || len_b <= 0) {
+        return;
+    }
+
+    if (a == b && len_a == len_b) {
+        Square(a, len_a, c, work);
+        return;
+    }
+
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll n = N();
+    ll *fa = work->Buffer(0, n);
+    ll *fb = work->Buffer(1, n);
+    std::fill(std::copy(a, a + len_a, fa), fa + n, 0);
+    std::fill(std::copy(b, b + len_b, fb), fb + n, 0);
+
+    DftPointwise(fa);
+    DftPointwise(fb);
+    MultPointwise(fa, fb, fa, n);
+    IdftPointwise(fa);
+
+    ll len_c = std::min(len_a + len_b - 1, n);
+    std::copy(fa, fa + len_c, c);
+}
+
+/*
+ * 数列の 2 乗 (自身との畳み込み) を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[out] c 数列 a と a の畳み込み．
+ */
+void Ntt::Square(const ll *a, ll *c) const {
+    if (c != a) {
+        std::copy(a, a + N(), c);
+    }
+
+    DftPointwise(c);
+    SquarePointwise(c, N());
+    IdftPointwise(c);
+}
+
+/*
+ * 32 ビットで格納した数列の 2 乗を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[out] c 数列 a と a の畳み込み．
+ */
+void Ntt::Square(const u32 *a, u32 *c) const {
+    if (c != a) {
+        std::copy(a, a + N(), c);
+    }
+
+    DftPointwise(c);
+    SquarePointwise(c, N());
+    IdftPointwise(c);
+}
+
+/*
+ * 先頭 len_a 個の要素のみが非零である数列の 2 乗を計算して返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ (N() 以下)．
+ * @param[out] c 数列 a と a の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void Ntt::Square(const ll *a, ll len_a, ll *c, Workspace *work) const {
+    CheckLength(len_a, len_a);
+    if (len_a <= 0) {
+        return;
+    }
+
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll n = N();
+    ll *fa = work->Buffer(0, n);
+    std::fill(std::copy(a, a + len_a, fa), fa + n, 0);
+
+    DftPointwise(fa);
+    SquarePointwise(fa, n);
+    IdftPointwise(fa);
+
+    ll len_c = std::min(2 * len_a - 1, n);
+    std::copy(fa, fa + len_c, c);
+}
+
+/*
+ * 畳み込みで繰り返し用いる数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[out] spectrum 数列 a の離散フーリエ変換．
+ */
+void Ntt::Prepare(const ll *a, Spectrum *spectrum) const {
+    ll n = N();
+    spectrum->Resize(n);
+    ll *s = spectrum->Data();
+    std::copy(a, a + n, s);
+
+    DftPointwise(s);
+    ToSpectrum(s, n);
+    spectrum->SetLayout(Mod(), SpectrumOrder());
+}
+
+/*
+ * 入力の長さが次数以下であることを確認する．
+ *
+ * 作業領域は N() 要素のため，長い入力は書き込めない．
+ *
+ * @param[in] len_a 数列 a の長さ．
+ * @param[in] len_b 数列 b の長さ．
+ */
+void Ntt::CheckLength(ll len_a, ll len_b) const {
+    if (len_a > N() || len_b > N()) {
+        throw std::invalid_argument("input length must not exceed N()");
+    }
+}
+
+/*
+ * 変換済みの数列がこの変換で作成したものと同じ形であることを確認する．
+ *
+ * 要素数のほか，モジュラスの異なる変換で作成した場合や，
+ * SetBitReversalFree の切り替えで要素の順序が変わった場合を検出する．
+ *
+ * @param[in] spectrum Prepare で変換した数列．
+ */
+void Ntt::CheckSpectrum(const Spectrum& spectrum) const {
+    if (spectrum.Size() != N()) {
+        throw std::invalid_argument("spectrum size must be N()");
+    }
+    if (spectrum.Mod() != Mod()) {
+        throw std::invalid_argument("spectrum was prepared for a different modulus");
+    }
+    if (spectrum.Ordering() != SpectrumOrder()) {
+        throw std::invalid_argument("spectrum order does not match the current transform");
+    }
+}
+
+/*
+ * 変換済みの数列と数列の畳み込みを計算して返す．
+ *
+ * @param[in] spectrum Prepare で変換した数列．
+ * @param[in] x 数列．
+ * @param[out] c 数列 spectrum と x の畳み込み．
+ */
+void Ntt::Mult(const Spectrum& spectrum, const ll *x, ll *c) const {
+    // c を書き換える前に確認する
+    CheckSpectrum(spectrum);
+    TransformInput(x, c);
+    MultTransformed(spectrum, c);
+}
+
+/*
+ * Mult(spectrum, x, c) の前半として数列を変換する．
+ *
+ * @param[in] x 数列．
+ * @param[out] c 変換した数列．
+ */
+void Ntt::TransformInput(const ll *x, ll *c) const {
+    ll n = N();
+    if (c != x) {
+        std::copy(x, x + n, c);
+    }
+    DftPointwise(c);
+}
+
+/*
+ * TransformInput で変換した数列と変換済みの数列の畳み込みを計算して返す．
+ *
+ * @param[in] spectrum Prepare で変換した数列．
+ * @param[in,out] c TransformInput で変換した数列．畳み込みを上書きして返す．
+ */
+void Ntt::MultTransformed(const Spectrum& spectrum, ll *c) const {
+    CheckSpectrum(spectrum);
+    MultSpectrum(spectrum.Data(), c, c, N());
+    IdftSpectrum(c);
+}
+
+/*
+ * 独立した複数の畳み込みを計算して返す．
+ *
+ * @param[in] a 数列へのポインタの配列 (要素数 count)．
+ * @param[in] b 数列へのポインタの配列 (要素数 count)．
+ * @param[out] c 畳み込みを格納する数列へのポインタの配列 (要素数 count)．
+ * @param[in] count 畳み込みの数．
+ * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+ */
+void Ntt::MultBatch(const ll *const *a, const ll *const *b, ll *const *c, ll count,
+                    ThreadPool *pool) const {
+    auto job = [&](ll i) {
+        Mult(a[i], b[i], c[i], &Workspace::ThreadLocal());
+    };
+
+    if (pool == nullptr) {
+        for (ll i = 0; i < count; i++) {
+            job(i);
+        }
+    } else {
+        pool->Run(count, job);
+    }
+}
+
+/*
+ * 一定の間隔で並んだ独立した複数の畳み込みを計算して返す．
+ *
+ * @param[in] a 数列を並べた領域．
+ * @param[in] b 数列を並べた領域．
+ * @param[out] c 畳み込みを格納する領域．
+ * @param[in] count 畳み込みの数．
+ * @param[in] stride 数列の間隔 (N() 以上)．
+ * @param[in] pool スレッドプール．nullptr の場合は逐次実行する．
+ */
+void Ntt::MultBatch(const ll *a, const ll *b, ll *c, ll count, ll stride,
+                    ThreadPool *pool) const {
+    // 間隔が次数より小さいと数列が重なり，並列実行で書き込みが競合する
+    if (stride < N()) {
+        throw std::invalid_argument("stride must be at least N()");
+    }
+
+    auto job = [&](ll i) {
+        Mult(a + i * stride, b + i * stride, c + i * stride, &Workspace::ThreadLocal());
+    };
+
+    if (pool == nullptr) {
+        for (ll i = 0; i < count; i++) {
+            job(i);
+        }
+    } else {
+        pool->Run(count, job);
+    }
 }
 
 /*
@@ -71,7 +634,7 @@ void Ntt::Mult(ll *a, ll *b, ll *c) const {
  * @param[in,out] 数列．変換後の数列を上書きして返す．
  */
 void NttNaive::Dft(ll *a) const {
-    ll *c = new ll[n_];
+    ll *c = TransformWorkspace().Buffer(0, n_);
     for (ll i = 0; i < n_; i++) {
         c[i] = 0;
         for (ll j = 0; j < n_; j++) {
@@ -83,246 +646,1857 @@ void NttNaive::Dft(ll *a) const {
     for (ll i = 0; i < n_; i++) {
         a[i] = c[i];
     }
+}
 
-    delete[] c; c = nullptr;
+/*
+ * 数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttNaive::Idft(ll *a) const {
+    ll *c = TransformWorkspace().Buffer(0, n_);
+    for (ll i = 0; i < n_; i++) {
+        c[i] = 0;
+        for (ll j = 0; j < n_; j++) {
+            c[i] += Pow(phi_, j*i) * a[j];
+        }
+        c[i] %= mod_;
+    }
+
+    for (ll i = 0; i < n_; i++) {
+        c[i] = (c[i] * n_inv_) % mod_;
+    }
+
+    for (ll i = 0; i < n_; i++) {
+        a[i] = c[i];
+    }
+}
+
+/*
+ * べき乗を計算して返す．
+ *
+ * @param[in] x 基数
+ * @param[in] k 指数
+ * @return ll x の k 乗
+ */
+ll NttNaive::Pow(ll x, ll k) const {
+    ll p = x;
+    ll v = 1;
+    if (k == 0) {
+        return v;
+    }
+
+    while (k >= 1) {
+        if ((k & 1) == 1) {
+            v = (v * p) % mod_;
+        }
+        k >>= 1;
+        p = (p * p) % mod_;
+    }
+
+    return v;
+}
+
+/*
+ * 数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::Dft(ll *a) const {
+    DftSized(a, log_n_);
+}
+
+/*
+ * 数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::Idft(ll *a) const {
+    IdftSized(a, log_n_);
+}
+
+/*
+ * 32 ビットで格納した数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::Dft(u32 *a) const {
+    DftSized(a, log_n_);
+}
+
+/*
+ * 32 ビットで格納した数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::Idft(u32 *a) const {
+    IdftSized(a, log_n_);
+}
+
+/*
+ * 長さ n の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗，次数以下)．
+ */
+void NttBase::Reverse(ll *a, ll n) const {
+    bit_reversal_.Reverse(a, Utility::Log2(n), reverse_method_);
+}
+
+/*
+ * 32 ビットで格納した長さ n の数列をビット反転で並び替えて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] n 数列の長さ (2 のべき乗，次数以下)．
+ */
+void NttBase::Reverse(u32 *a, ll n) const {
+    bit_reversal_.Reverse(a, Utility::Log2(n), reverse_method_);
+}
+
+/*
+ * 長さ 2^log_m の数列の離散フーリエ変換を計算して返す．
+ *
+ * 第 l 段の回転因子は 1 の 2^l 乗根のべき乗であり次数によらないため，
+ * 次数 n のテーブルをそのまま用いることができる．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+void NttBase::DftSized(ll *a, ll log_m) const {
+    Reverse(a, 1LL << log_m);
+    Transform(a, log_m, false);
+    Normalize(a, 1LL << log_m);
+}
+
+/*
+ * 長さ 2^log_m の数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+void NttBase::IdftSized(ll *a, ll log_m) const {
+    IdftScaled(a, log_m, 1);
+}
+
+/*
+ * 32 ビットで格納した長さ 2^log_m の数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+void NttBase::DftSized(u32 *a, ll log_m) const {
+    Reverse(a, 1LL << log_m);
+    Transform(a, log_m, false);
+    Normalize(a, 1LL << log_m);
+}
+
+/*
+ * 32 ビットで格納した長さ 2^log_m の数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+void NttBase::IdftSized(u32 *a, ll log_m) const {
+    IdftScaled(a, log_m, 1);
+}
+
+/*
+ * MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::IdftPointwise(ll *a) const {
+    IdftScaled(a, log_n_, PointwiseFactor(), bit_reversal_free_);
+}
+
+/*
+ * 32 ビットで格納した MultPointwise の結果の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::IdftPointwise(u32 *a) const {
+    IdftScaled(a, log_n_, PointwiseFactor(), bit_reversal_free_);
+}
+
+/*
+ * 畳み込みのための離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::DftPointwise(ll *a) const {
+    DftPointwiseSized(a, log_n_);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，畳み込みのための離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::DftPointwise(u32 *a) const {
+    DftPointwiseSized(a, log_n_);
+}
+
+/*
+ * MultSpectrum の結果の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttBase::IdftSpectrum(ll *a) const {
+    IdftScaled(a, log_n_, 1, bit_reversal_free_);
+}
+
+/*
+ * 長さ 2^log_m の数列に対して，畳み込みのための離散フーリエ変換を計算して返す．
+ *
+ * ビット反転を省く場合は周波数間引きで変換し，結果をビット反転した順序のまま返す．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+template <typename T>
+void NttBase::DftPointwiseSized(T *a, ll log_m) const {
+    if (!bit_reversal_free_) {
+        DftSized(a, log_m);
+        return;
+    }
+
+    TransformDif(a, log_m);
+    Normalize(a, 1LL << log_m);
+}
+
+/*
+ * 長さ 2^log_m の数列の逆変換を計算し，2^-log_m と factor を掛けて返す．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ * @param[in] factor 追加で掛ける係数
+ * @param[in] bit_reversed 入力がビット反転した順序であれば true (並び替えを省く)
+ */
+template <typename T>
+void NttBase::IdftScaled(T *a, ll log_m, ll factor, bool bit_reversed) const {
+    if (!bit_reversed) {
+        Reverse(a, 1LL << log_m);
+    }
+    Transform(a, log_m, true);
+
+    // 2^-log_m = n^-1 * 2^(log_n - log_m)
+    ll m_inv = Utility::MulMod(n_inv_, (1LL << (log_n_ - log_m)) % mod_, mod_);
+    MultScalar(a, 1LL << log_m, Utility::MulMod(m_inv, factor, mod_));
+}
+
+/*
+ * 長さ 2^log_m の数列の変換の各段を実行する．
+ *
+ * スレッドプールが設定されている場合，第 1 段から第 log_m - b 段までは
+ * 長さ 2^(log_m - b) の独立したブロックに分けて (2^b はスレッド数以上)，
+ * それ以降の段は段ごとに r の範囲を分けて並列に実行する．
+ * Schedule::kBlocked では各スレッドの範囲を 2^log_block のブロックに分け，
+ * それ以降の段は 2 段ずつ TransformStagePair で実行する．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列 (ビット反転で並び替え済み)．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ * @param[in] inverse 逆変換の場合 true
+ */
+template <typename T>
+void NttBase::Transform(T *a, ll log_m, bool inverse) const {
+    ll m = log_m;
+    bool blocked = (schedule_ == Schedule::kBlocked);
+
+    if (pool_ == nullptr || pool_->NumThreads() == 1 || m < kLogParallelMin) {
+        if (!blocked) {
+            for (ll l = 1; l <= m; l++) {
+                TransformStage(a, l, 0, 1LL << (m - l), 0, 1LL << (l - 1), inverse);
+            }
+            return;
+        }
+
+        // キャッシュに収まるブロックごとに前半の段を済ませ，残りを 2 段ずつ走査する
+        ll log_block = std::min(log_block_, m);
+        for (ll t = 0; t < (1LL << (m - log_block)); t++) {
+            TransformStagesRadix4(a + (t << log_block), log_block, 1, log_block, inverse);
+        }
+        TransformStagesRadix4(a, m, log_block + 1, m, inverse);
+        return;
+    }
+
+    // 後半の段で r の範囲をブロック数で分割できるよう 2b <= log_m とする
+    ll b = 0;
+    while ((1LL << b) < pool_->NumThreads() && 2 * (b + 1) <= m) {
+        b++;
+    }
+    ll num_blocks = 1LL << b;
+
+    ll log_slice = m - b;
+    pool_->Run(num_blocks, [&](ll t) {
+        T *slice = a + (t << log_slice);
+        if (blocked) {
+            // スレッドごとの範囲もキャッシュに収まるブロックに分けて前半の段を済ませる
+            ll log_block = std::min(log_block_, log_slice);
+            for (ll u = 0; u < (1LL << (log_slice - log_block)); u++) {
+                TransformStagesRadix4(slice + (u << log_block), log_block, 1, log_block, inverse);
+            }
+            TransformStagesRadix4(slice, log_slice, log_block + 1, log_slice, inverse);
+            return;
+        }
+        for (ll l = 1; l <= log_slice; l++) {
+            TransformStage(slice, l, 0, 1LL << (log_slice - l), 0, 1LL << (l - 1), inverse);
+        }
+    });
+
+    ll l = log_slice + 1;
+    if (blocked) {
+        for (; l + 1 <= m; l += 2) {
+            ll max_q = 1LL << (m - l - 1);
+            ll chunk = (1LL << (l - 1)) / num_blocks;
+            pool_->Run(num_blocks, [&](ll t) {
+                TransformStagePair(a, l, 0, max_q, t * chunk, (t + 1) * chunk, inverse);
+            });
+        }
+    }
+    for (; l <= m; l++) {
+        ll max_q = 1LL << (m - l);
+        ll chunk = (1LL << (l - 1)) / num_blocks;
+        pool_->Run(num_blocks, [&](ll t) {
+            TransformStage(a, l, 0, max_q, t * chunk, (t + 1) * chunk, inverse);
+        });
+    }
+}
+
+template void NttBase::Transform<ll>(ll *a, ll log_m, bool inverse) const;
+template void NttBase::Transform<u32>(u32 *a, ll log_m, bool inverse) const;
+
+/*
+ * 長さ 2^log_m の数列の周波数間引きの変換を実行する．
+ *
+ * 自然な順序の数列を受け取り，ビット反転した順序の離散フーリエ変換を返す．
+ * 段は第 log_m 段から第 1 段の順に実行する．Schedule::kBlocked では
+ * ブロックより長い段を先に数列全体で 2 段ずつ TransformStageDifPair で実行し，
+ * 残りの段をブロックごとに 2 段ずつ実行する．
+ * スレッドプールが設定されている場合は Transform と逆の順で分割して並列に実行する．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ */
+template <typename T>
+void NttBase::TransformDif(T *a, ll log_m) const {
+    ll m = log_m;
+    bool blocked = (schedule_ == Schedule::kBlocked);
+
+    if (pool_ == nullptr || pool_->NumThreads() == 1 || m < kLogParallelMin) {
+        if (!blocked) {
+            for (ll l = m; l >= 1; l--) {
+                TransformStageDif(a, l, 0, 1LL << (m - l), 0, 1LL << (l - 1));
+            }
+            return;
+        }
+
+        // ブロックより長い段を 2 段ずつ走査し，残りをキャッシュに収まるブロックごとに済ませる
+        ll log_block = std::min(log_block_, m);
+        TransformStagesDifRadix4(a, m, log_block + 1, m);
+        for (ll t = 0; t < (1LL << (m - log_block)); t++) {
+            TransformStagesDifRadix4(a + (t << log_block), log_block, 1, log_block);
+        }
+        return;
+    }
+
+    // 前半の段で r の範囲をブロック数で分割できるよう 2b <= log_m とする
+    ll b = 0;
+    while ((1LL << b) < pool_->NumThreads() && 2 * (b + 1) <= m) {
+        b++;
+    }
+    ll num_blocks = 1LL << b;
+    ll log_slice = m - b;
+
+    ll l = m;
+    if (blocked) {
+        for (; l - 1 > log_slice; l -= 2) {
+            ll max_q = 1LL << (m - l);
+            ll chunk = (1LL << (l - 2)) / num_blocks;
+            pool_->Run(num_blocks, [&](ll t) {
+                TransformStageDifPair(a, l - 1, 0, max_q, t * chunk, (t + 1) * chunk);
+            });
+        }
+    }
+    for (; l > log_slice; l--) {
+        ll max_q = 1LL << (m - l);
+        ll chunk = (1LL << (l - 1)) / num_blocks;
+        pool_->Run(num_blocks, [&](ll t) {
+            TransformStageDif(a, l, 0, max_q, t * chunk, (t + 1) * chunk);
+        });
+    }
+
+    pool_->Run(num_blocks, [&](ll t) {
+        T *slice = a + (t << log_slice);
+        if (blocked) {
+            // スレッドごとの範囲もキャッシュに収まるブロックに分けて後半の段を済ませる
+            ll log_block = std::min(log_block_, log_slice);
+            TransformStagesDifRadix4(slice, log_slice, log_block + 1, log_slice);
+            for (ll u = 0; u < (1LL << (log_slice - log_block)); u++) {
+                TransformStagesDifRadix4(slice + (u << log_block), log_block, 1, log_block);
+            }
+            return;
+        }
+        for (ll l = log_slice; l >= 1; l--) {
+            TransformStageDif(slice, l, 0, 1LL << (log_slice - l), 0, 1LL << (l - 1));
+        }
+    });
+}
+
+/*
+ * 長さ 2^log_m の数列の第 l_first 段から第 l_last 段までを 2 段ずつ実行する．
+ *
+ * 段数が奇数の場合，最後の 1 段は基数 2 で実行する．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ * @param[in] l_first 最初の段
+ * @param[in] l_last 最後の段
+ * @param[in] inverse 逆変換の場合 true
+ */
+template <typename T>
+void NttBase::TransformStagesRadix4(T *a, ll log_m, ll l_first, ll l_last, bool inverse) const {
+    ll l = l_first;
+    for (; l + 1 <= l_last; l += 2) {
+        TransformStagePair(a, l, 0, 1LL << (log_m - l - 1), 0, 1LL << (l - 1), inverse);
+    }
+    if (l == l_last) {
+        TransformStage(a, l, 0, 1LL << (log_m - l), 0, 1LL << (l - 1), inverse);
+    }
+}
+
+/*
+ * 長さ 2^log_m の数列の周波数間引きの変換の第 l_last 段から第 l_first 段までを 2 段ずつ実行する．
+ *
+ * 段数が奇数の場合，最後の第 l_first 段は基数 2 で実行する．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ * @param[in] l_first 最後に実行する段
+ * @param[in] l_last 最初に実行する段
+ */
+template <typename T>
+void NttBase::TransformStagesDifRadix4(T *a, ll log_m, ll l_first, ll l_last) const {
+    ll l = l_last;
+    for (; l - 1 >= l_first; l -= 2) {
+        TransformStageDifPair(a, l - 1, 0, 1LL << (log_m - l), 0, 1LL << (l - 2));
+    }
+    if (l == l_first) {
+        TransformStageDif(a, l, 0, 1LL << (log_m - l), 0, 1LL << (l - 1));
+    }
+}
+
+/*
+ * 長さ 2^log_m の変換で数列全体を走査する回数と転送量の見積もりを返す．
+ *
+ * 2 段の組を段ごとに実行するエンジンでは，組の走査を 2 回として数える．
+ *
+ * @param[in] log_m 数列の長さが 2 の何乗か
+ * @param[in] element_size 要素のバイト数
+ * @return ScheduleReport 見積もり
+ */
+NttBase::ScheduleReport NttBase::Report(ll log_m, ll element_size) const {
+    ScheduleReport report;
+    report.stages = log_m;
+    report.fused_pairs = false;
+    if (schedule_ == Schedule::kBlocked) {
+        // ブロック内の段で 1 回，残りの段は 2 段ごと (まとめない場合は段ごと) に 1 回走査する
+        report.fused_pairs = FusesStagePair();
+        report.blocked_stages = std::min(log_block_, log_m);
+        ll rest = log_m - report.blocked_stages;
+        report.passes = 1 + (report.fused_pairs ? (rest + 1) / 2 : rest);
+    } else {
+        report.blocked_stages = 0;
+        report.passes = log_m;
+    }
+    report.bytes = 2 * report.passes * (1LL << log_m) * element_size;
+    return report;
+}
+
+/*
+ * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttBase::TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                             bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+
+    if (inverse) {
+        const ll *w = &phi_pows_[max_r];
+        for (ll q = q_begin; q < q_end; q++) {
+            for (ll r = r_begin; r < r_end; r++) {
+                ll k = (q << l) + r;
+                ButterflyInv(a[k], a[k + max_r], w[r]);
+            }
+        }
+    } else {
+        const ll *w = &omega_pows_[max_r];
+        for (ll q = q_begin; q < q_end; q++) {
+            for (ll r = r_begin; r < r_end; r++) {
+                ll k = (q << l) + r;
+                Butterfly(a[k], a[k + max_r], w[r]);
+            }
+        }
+    }
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段のバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+ *
+ * 各要素を 64 ビットに展開してバタフライ演算を呼び出す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttBase::TransformStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                             bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+
+    for (ll q = q_begin; q < q_end; q++) {
+        for (ll r = r_begin; r < r_end; r++) {
+            ll k = (q << l) + r;
+            ll x = a[k];
+            ll y = a[k + max_r];
+            if (inverse) {
+                ButterflyInv(x, y, w[r]);
+            } else {
+                Butterfly(x, y, w[r]);
+            }
+            a[k] = static_cast<u32>(x);
+            a[k + max_r] = static_cast<u32>(y);
+        }
+    }
+}
+
+/*
+ * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttBase::TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = &omega_pows_[max_r];
+
+    for (ll q = q_begin; q < q_end; q++) {
+        for (ll r = r_begin; r < r_end; r++) {
+            ll k = (q << l) + r;
+            ll x = a[k];
+            ll y = a[k + max_r];
+            ButterflyDif(x, y, w[r]);
+            a[k] = static_cast<ll>(x);
+            a[k + max_r] = static_cast<ll>(y);
+        }
+    }
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttBase::TransformStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = &omega_pows_[max_r];
+
+    for (ll q = q_begin; q < q_end; q++) {
+        for (ll r = r_begin; r < r_end; r++) {
+            ll k = (q << l) + r;
+            ll x = a[k];
+            ll y = a[k + max_r];
+            ButterflyDif(x, y, w[r]);
+            a[k] = static_cast<u32>(x);
+            a[k + max_r] = static_cast<u32>(y);
+        }
+    }
+}
+
+/*
+ * 第 l 段と第 l + 1 段のバタフライ演算を 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttBase::TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                 bool inverse) const {
+    TransformStagePairGeneric(a, l, q_begin, q_end, r_begin, r_end, inverse);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段と第 l + 1 段のバタフライ演算を
+ * 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttBase::TransformStagePair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                 bool inverse) const {
+    TransformStagePairGeneric(a, l, q_begin, q_end, r_begin, r_end, inverse);
+}
+
+/*
+ * 第 l 段と第 l + 1 段のバタフライ演算を Butterfly, ButterflyInv で 1 回の走査で実行する．
+ *
+ * 長さ 2^(l+1) のブロックの 4 要素 x0, x1, x2, x3 (間隔 2^(l-1)) について，
+ * 第 l 段で (x0, x1), (x2, x3) を，第 l + 1 段で (x0, x2), (x1, x3) を組にする．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+template <typename T>
+void NttBase::TransformStagePairGeneric(T *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                        bool inverse) const {
+    ll h = 1LL << (l - 1);
+    const AlignedVector<ll>& pows = inverse ? phi_pows_ : omega_pows_;
+    const ll *w1 = &pows[h];
+    const ll *w2 = &pows[2 * h];
+
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << (l + 1));
+        for (ll r = r_begin; r < r_end; r++) {
+            ll x0 = x[r];
+            ll x1 = x[r + h];
+            ll x2 = x[r + 2 * h];
+            ll x3 = x[r + 3 * h];
+            if (inverse) {
+                ButterflyInv(x0, x1, w1[r]);
+                ButterflyInv(x2, x3, w1[r]);
+                ButterflyInv(x0, x2, w2[r]);
+                ButterflyInv(x1, x3, w2[r + h]);
+            } else {
+                Butterfly(x0, x1, w1[r]);
+                Butterfly(x2, x3, w1[r]);
+                Butterfly(x0, x2, w2[r]);
+                Butterfly(x1, x3, w2[r + h]);
+            }
+            x[r] = static_cast<T>(x0);
+            x[r + h] = static_cast<T>(x1);
+            x[r + 2 * h] = static_cast<T>(x2);
+            x[r + 3 * h] = static_cast<T>(x3);
+        }
+    }
+}
+
+/*
+ * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttBase::TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                    ll r_end) const {
+    TransformStageDifPairGeneric(a, l, q_begin, q_end, r_begin, r_end);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を
+ * 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttBase::TransformStageDifPair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                    ll r_end) const {
+    TransformStageDifPairGeneric(a, l, q_begin, q_end, r_begin, r_end);
+}
+
+/*
+ * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を ButterflyDif で 1 回の走査で実行する．
+ *
+ * TransformStagePairGeneric の逆順であり，長さ 2^(l+1) のブロックの 4 要素 x0, x1, x2, x3
+ * (間隔 2^(l-1)) について，第 l + 1 段で (x0, x2), (x1, x3) を，第 l 段で (x0, x1), (x2, x3) を
+ * 組にする．
+ *
+ * @tparam T 要素の型 (ll または u32)
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+template <typename T>
+void NttBase::TransformStageDifPairGeneric(T *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                           ll r_end) const {
+    ll h = 1LL << (l - 1);
+    const ll *w1 = &omega_pows_[h];
+    const ll *w2 = &omega_pows_[2 * h];
+
+    for (ll q = q_begin; q < q_end; q++) {
+        T *x = a + (q << (l + 1));
+        for (ll r = r_begin; r < r_end; r++) {
+            ll x0 = x[r];
+            ll x1 = x[r + h];
+            ll x2 = x[r + 2 * h];
+            ll x3 = x[r + 3 * h];
+            ButterflyDif(x0, x2, w2[r]);
+            ButterflyDif(x1, x3, w2[r + h]);
+            ButterflyDif(x0, x1, w1[r]);
+            ButterflyDif(x2, x3, w1[r]);
+            x[r] = static_cast<T>(x0);
+            x[r + h] = static_cast<T>(x1);
+            x[r + 2 * h] = static_cast<T>(x2);
+            x[r + 3 * h] = static_cast<T>(x3);
+        }
+    }
+}
+
+/*
+ * 変換の各段を実行した後の数列を [0, mod) に正規化する．既定では何もしない．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ */
+void NttBase::Normalize(ll *a, ll m) const {
+    (void)a;
+    (void)m;
+}
+
+/*
+ * 32 ビットで格納した数列を [0, mod) に正規化する．既定では何もしない．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ */
+void NttBase::Normalize(u32 *a, ll m) const {
+    (void)a;
+    (void)m;
+}
+
+/*
+ * 先頭 len_a, len_b 個の要素のみが非零である数列の畳み込みを計算して返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ (N() 以下)．
+ * @param[in] b 数列 (長さ len_b)．
+ * @param[in] len_b 数列 b の長さ (N() 以下)．
+ * @param[out] c 数列 a と b の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void NttBase::Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c,
+                   Workspace *work) const {
+    CheckLength(len_a, len_b);
+    if (len_a <= 0 || len_b <= 0) {
+        return;
+    }
+
+    if (a == b && len_a == len_b) {
+        Square(a, len_a, c, work);
+        return;
+    }
+
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll len_c = len_a + len_b - 1;
+    ll log_m = 0;
+    while (log_m < log_n_ && (1LL << log_m) < len_c) {
+        log_m++;
+    }
+    ll size = 1LL << log_m;
+
+    ll *fa = work->Buffer(0, size);
+    ll *fb = work->Buffer(1, size);
+    std::fill(std::copy(a, a + len_a, fa), fa + size, 0);
+    std::fill(std::copy(b, b + len_b, fb), fb + size, 0);
+
+    DftPointwiseSized(fa, log_m);
+    DftPointwiseSized(fb, log_m);
+    MultPointwise(fa, fb, fa, size);
+    IdftScaled(fa, log_m, PointwiseFactor(), bit_reversal_free_);
+
+    std::copy(fa, fa + std::min(len_c, size), c);
+}
+
+/*
+ * 先頭 len_a 個の要素のみが非零である数列の 2 乗を計算して返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ (N() 以下)．
+ * @param[out] c 数列 a と a の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void NttBase::Square(const ll *a, ll len_a, ll *c, Workspace *work) const {
+    CheckLength(len_a, len_a);
+    if (len_a <= 0) {
+        return;
+    }
+
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll len_c = 2 * len_a - 1;
+    ll log_m = 0;
+    while (log_m < log_n_ && (1LL << log_m) < len_c) {
+        log_m++;
+    }
+    ll size = 1LL << log_m;
+
+    ll *fa = work->Buffer(0, size);
+    std::fill(std::copy(a, a + len_a, fa), fa + size, 0);
+
+    DftPointwiseSized(fa, log_m);
+    SquarePointwise(fa, size);
+    IdftScaled(fa, log_m, PointwiseFactor(), bit_reversal_free_);
+
+    std::copy(fa, fa + std::min(len_c, size), c);
+}
+
+/*
+ * 数列の各要素にスカラーを掛けて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttBase::MultScalar(ll *a, ll m, ll s) const {
+    for (ll i = 0; i < m; i++) {
+        a[i] = (a[i] * s) % mod_;
+    }
+}
+
+/*
+ * 32 ビットで格納した数列の各要素にスカラーを掛けて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttBase::MultScalar(u32 *a, ll m, ll s) const {
+    for (ll i = 0; i < m; i++) {
+        a[i] = static_cast<u32>((a[i] * s) % mod_);
+    }
+}
+
+/*
+ * バタフライ演算を実行して結果を返す．
+ *
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子
+ */
+void NttBase::Butterfly(ll& a, ll& b, ll w) const {
+    ll tmp = (w * b) % mod_;
+    ll minus_tmp = (mod_ - tmp) % mod_;
+
+    b = (a + minus_tmp) % mod_;
+    a = (a + tmp) % mod_;
+}
+
+/*
+ * 周波数間引きのバタフライ演算を実行して結果を返す．
+ *
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子
+ */
+void NttBase::ButterflyDif(ll& a, ll& b, ll w) const {
+    ll diff = (a + mod_ - b) % mod_;
+
+    a = (a + b) % mod_;
+    b = (w * diff) % mod_;
+}
+
+/*
+ * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+ *
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子
+ */
+void NttBase::ButterflyInv(ll& a, ll& b, ll w) const {
+    ll tmp = (w * b) % mod_;
+    ll minus_tmp = (mod_ - tmp) % mod_;
+
+    b = (a + minus_tmp) % mod_;
+    a = (a + tmp) % mod_;
+}
+
+/*
+ * べき乗を計算して返す．
+ *
+ * @param[in] x 基数
+ * @param[in] k 指数
+ * @return ll x の k 乗
+ */
+ll NttBase::Pow(ll x, ll k) const {
+    ll p = x;
+    ll v = 1;
+    if (k == 0) {
+        return v;
+    }
+
+    while (k >= 1) {
+        if ((k & 1) == 1) {
+            v = (v * p) % mod_;
+        }
+        k >>= 1;
+        p = (p * p) % mod_;
+    }
+
+    return v;
+}
+
+/*
+ * 1 の n 乗根のべき乗を計算して返す．
+ *
+ * @param[in] k 指数
+ * @return ll 1 の n 乗根の k 乗
+ */
+ll NttBase::PowOmega(ll k) const {
+    ll half = n_ >> 1;
+    k &= (n_ - 1);
+    return (k < half) ? omega_pows_[half + k] : (mod_ - omega_pows_[k]) % mod_;
+}
+
+/*
+ * 1 の n 乗根の逆元のべき乗を計算して返す．
+ *
+ * @param[in] k 指数
+ * @return ll 1 の n 乗根の逆数の k 乗
+ */
+ll NttBase::PowPhi(ll k) const {
+    ll half = n_ >> 1;
+    k &= (n_ - 1);
+    return (k < half) ? phi_pows_[half + k] : (mod_ - phi_pows_[k]) % mod_;
+}
+
+/*
+ * 回転因子のテーブルを作成する．
+ */
+void NttBase::MakePowTables() {
+    omega_pows_.assign(n_, 0);
+    phi_pows_.assign(n_, 0);
+
+    ll half = n_ >> 1;
+    ll omega_pow = 1;
+    ll phi_pow = 1;
+    for (ll r = 0; r < half; r++) {
+        omega_pows_[half + r] = omega_pow;
+        phi_pows_[half + r] = phi_pow;
+        omega_pow = Utility::MulMod(omega_pow, omega_, mod_);
+        phi_pow = Utility::MulMod(phi_pow, phi_, mod_);
+    }
+
+    ll m = log_n_;
+    for (ll l = m - 1; l >= 1; l--) {
+        ll max_r = (1 << (l - 1));
+        for (ll r = 0; r < max_r; r++) {
+            omega_pows_[max_r + r] = omega_pows_[half + (r << (m - l))];
+            phi_pows_[max_r + r] = phi_pows_[half + (r << (m - l))];
+        }
+    }
+}
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] omega 1 の n 乗根．
+ * @param[in] phi 1 の n 乗根の逆元．
+ * @param[in] n 次数．
+ * @param[in] n_inv 次数の逆元．
+ */
+NttNaive::NttNaive(ll mod, ll omega, ll phi, ll n, ll n_inv) : 
+        mod_(mod), omega_(omega), phi_(phi), n_(n), n_inv_(n_inv){}
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] omega 1 の n 乗根．
+ * @param[in] phi 1 の n 乗根の逆元．
+ * @param[in] n 次数．
+ * @param[in] n_inv 次数の逆元．
+ * @param[in] log_n 次数が 2 の何乗か
+ */
+NttBase::NttBase(ll mod, ll omega, ll phi, ll n, ll n_inv, ll log_n) :
+        mod_(mod),
+        omega_(omega),
+        phi_(phi),
+        n_(n),
+        n_inv_(n_inv),
+        log_n_(log_n),
+        bit_reversal_(log_n) {
+    MakePowTables();
+}
+
+/* コンストラクタ */
+NttMod337Deg8::NttMod337Deg8() :
+        NttBase(kMod, kOmega, kPhi, kN, kNInv, kLogN) {}
+
+/* コンストラクタ */
+NttNaiveMod337Deg8::NttNaiveMod337Deg8() :
+        NttNaive(kMod, kOmega, kPhi, kN, kNInv) {}
+
+/* コンストラクタ */
+NttMod19529729Deg131072::NttMod19529729Deg131072() :
+        NttBase(kMod, kOmega, kPhi, kN, kNInv, kLogN) {
+}
+
+/* コンストラクタ */
+NttMod19529729Deg131072M::NttMod19529729Deg131072M() :
+        NttBase(kMod, kOmega, kPhi, kN, kNInv, kLogN),
+        simd_(montgomery_) {
+    for (ll& w : omega_pows_) {
+        w = montgomery_.ToMontgomery(w);
+    }
+
+    for (ll& w : phi_pows_) {
+        w = montgomery_.ToMontgomery(w);
+    }
+}
+
+/* コンストラクタ */
+NttNaiveMod19529729Deg131072::NttNaiveMod19529729Deg131072() :
+        NttNaive(kMod, kOmega, kPhi, kN, kNInv) {
+}
+
+/*
+ * 長さ n の数列の要素ごとの積を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::MultVec(const ll *a, const ll *b, ll *c, ll n) const {
+    simd_.MultVec(a, b, c, n);
+}
+
+/*
+ * 32 ビットで格納した長さ n の数列の要素ごとの積を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const {
+    simd_.MultVec(a, b, c, n);
+}
+
+/*
+ * 数列の各要素にスカラーを掛けて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttMod19529729Deg131072M::MultScalar(ll *a, ll m, ll s) const {
+    ll s_m = montgomery_.ToMontgomery(s);
+    for (ll i = 0; i < m; i++) {
+        a[i] = montgomery_.Reduction(a[i] * s_m);
+    }
+}
+
+/*
+ * 32 ビットで格納した数列の各要素にスカラーを掛けて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttMod19529729Deg131072M::MultScalar(u32 *a, ll m, ll s) const {
+    ll s_m = montgomery_.ToMontgomery(s);
+    for (ll i = 0; i < m; i++) {
+        a[i] = static_cast<u32>(montgomery_.Reduction(a[i] * s_m));
+    }
+}
+
+/*
+ * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの積を 1 回のリダクションで計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積に R^-1 を掛けたもの．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::MultPointwise(const ll *a, const ll *b, ll *c, ll n) const {
+    simd_.ReductionVec(a, b, c, n);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，畳み込みの途中の要素ごとの積を
+ * 1 回のリダクションで計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積に R^-1 を掛けたもの．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::MultPointwise(const u32 *a, const u32 *b, u32 *c,
+                                             ll n) const {
+    simd_.ReductionVec(a, b, c, n);
+}
+
+/*
+ * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの 2 乗をモンゴメリ乗算で計算して返す．
+ *
+ * @param[in,out] a 数列．要素ごとの 2 乗に R^-1 を掛けたものを上書きして返す．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::SquarePointwise(ll *a, ll n) const {
+    simd_.SquareReductionVec(a, n);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，畳み込みの途中の要素ごとの 2 乗を
+ * モンゴメリ乗算で計算して返す．
+ *
+ * @param[in,out] a 数列．要素ごとの 2 乗に R^-1 を掛けたものを上書きして返す．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::SquarePointwise(u32 *a, ll n) const {
+    simd_.SquareReductionVec(a, n);
+}
+
+/*
+ * MultPointwise の結果を通常の積に戻すために掛ける係数 R mod N を返す．
+ *
+ * @return ll R mod N
+ */
+ll NttMod19529729Deg131072M::PointwiseFactor() const {
+    return montgomery_.ToMontgomery(1);
+}
+
+/*
+ * 離散フーリエ変換した数列をモンゴメリ表現のスペクトルに変換する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::ToSpectrum(ll *a, ll n) const {
+    for (ll i = 0; i < n; i++) {
+        a[i] = montgomery_.ToMontgomery(a[i]);
+    }
+}
+
+/*
+ * モンゴメリ表現のスペクトルと数列の要素ごとの積を計算して返す．
+ *
+ * sR * x の1回のリダクションで s * x が得られる．
+ *
+ * @param[in] s スペクトル (モンゴメリ表現)．
+ * @param[in] x 数列．
+ * @param[out] c 数列 s と x の要素ごとの積．
+ * @param[in] n 数列の長さ．
+ */
+void NttMod19529729Deg131072M::MultSpectrum(const ll *s, const ll *x, ll *c, ll n) const {
+    simd_.ReductionVec(s, x, c, n);
+}
+
+/*
+ * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttMod19529729Deg131072M::TransformStage(ll *a, ll l, ll q_begin, ll q_end,
+                                              ll r_begin, ll r_end, bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+    simd_.ButterflyStage(a, l, q_begin, q_end, r_begin, r_end, w);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段のバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttMod19529729Deg131072M::TransformStage(u32 *a, ll l, ll q_begin, ll q_end,
+                                              ll r_begin, ll r_end, bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+    simd_.ButterflyStage(a, l, q_begin, q_end, r_begin, r_end, w);
+}
+
+/*
+ * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttMod19529729Deg131072M::TransformStageDif(ll *a, ll l, ll q_begin, ll q_end,
+                                                 ll r_begin, ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    simd_.ButterflyStageDif(a, l, q_begin, q_end, r_begin, r_end, &omega_pows_[max_r]);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を SIMD 命令で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttMod19529729Deg131072M::TransformStageDif(u32 *a, ll l, ll q_begin, ll q_end,
+                                                 ll r_begin, ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    simd_.ButterflyStageDif(a, l, q_begin, q_end, r_begin, r_end, &omega_pows_[max_r]);
+}
+
+/*
+ * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を SIMD 命令の段ごとの実行で順に行う．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttMod19529729Deg131072M::TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end,
+                                                     ll r_begin, ll r_end) const {
+    ll h = 1LL << (l - 1);
+    TransformStageDif(a, l + 1, q_begin, q_end, r_begin, r_end);
+    TransformStageDif(a, l + 1, q_begin, q_end, r_begin + h, r_end + h);
+    TransformStageDif(a, l, 2 * q_begin, 2 * q_end, r_begin, r_end);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を
+ * SIMD 命令の段ごとの実行で順に行う．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttMod19529729Deg131072M::TransformStageDifPair(u32 *a, ll l, ll q_begin, ll q_end,
+                                                     ll r_begin, ll r_end) const {
+    ll h = 1LL << (l - 1);
+    TransformStageDif(a, l + 1, q_begin, q_end, r_begin, r_end);
+    TransformStageDif(a, l + 1, q_begin, q_end, r_begin + h, r_end + h);
+    TransformStageDif(a, l, 2 * q_begin, 2 * q_end, r_begin, r_end);
+}
+
+/*
+ * 第 l 段と第 l + 1 段のバタフライ演算を SIMD 命令の段ごとの実行で順に行う．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttMod19529729Deg131072M::TransformStagePair(ll *a, ll l, ll q_begin, ll q_end,
+                                                  ll r_begin, ll r_end, bool inverse) const {
+    ll h = 1LL << (l - 1);
+    TransformStage(a, l, 2 * q_begin, 2 * q_end, r_begin, r_end, inverse);
+    TransformStage(a, l + 1, q_begin, q_end, r_begin, r_end, inverse);
+    TransformStage(a, l + 1, q_begin, q_end, r_begin + h, r_end + h, inverse);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段と第 l + 1 段のバタフライ演算を
+ * SIMD 命令の段ごとの実行で順に行う．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttMod19529729Deg131072M::TransformStagePair(u32 *a, ll l, ll q_begin, ll q_end,
+                                                  ll r_begin, ll r_end, bool inverse) const {
+    ll h = 1LL << (l - 1);
+    TransformStage(a, l, 2 * q_begin, 2 * q_end, r_begin, r_end, inverse);
+    TransformStage(a, l + 1, q_begin, q_end, r_begin, r_end, inverse);
+    TransformStage(a, l + 1, q_begin, q_end, r_begin + h, r_end + h, inverse);
+}
+
+/*
+ * バタフライ演算を実行して結果を返す．
+ *
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子 (モンゴメリ表現)
+ */
+void NttMod19529729Deg131072M::Butterfly(ll& a, ll& b, ll w) const {
+    ll tmp = montgomery_.Reduction(w * b);
+    ll minus_tmp = mod_ - tmp;
+
+    b = a + minus_tmp;
+    b = (b >= mod_) ? b - mod_ : b;
+
+    a = a + tmp;
+    a = (a >= mod_) ? a - mod_ : a;
+}
+
+/*
+ * 周波数間引きのバタフライ演算を実行して結果を返す．
+ *
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子 (モンゴメリ表現)
+ */
+void NttMod19529729Deg131072M::ButterflyDif(ll& a, ll& b, ll w) const {
+    ll diff = a + mod_ - b;
+    diff = (diff >= mod_) ? diff - mod_ : diff;
+
+    a = a + b;
+    a = (a >= mod_) ? a - mod_ : a;
+    b = montgomery_.Reduction(w * diff);
+}
+
+/*
+ * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+ *
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子 (モンゴメリ表現)
+ */
+void NttMod19529729Deg131072M::ButterflyInv(ll& a, ll& b, ll w) const {
+    ll tmp = montgomery_.Reduction(w * b);
+    ll minus_tmp = mod_ - tmp;
+
+    b = a + minus_tmp;
+    b = (b >= mod_) ? b - mod_ : b;
+
+    a = a + tmp;
+    a = (a >= mod_) ? a - mod_ : a;
+}
+
+/*
+ * 1 の n 乗根のべき乗を計算して返す．
+ *
+ * @param[in] k 指数
+ * @return ll 1 の n 乗根の k 乗
+ */
+ll NttMod19529729Deg131072M::PowOmega(ll k) const {
+    return montgomery_.Reduction(NttBase::PowOmega(k));
+}
+
+/*
+ * 1 の n 乗根の逆元のべき乗を計算して返す．
+ *
+ * @param[in] k 指数
+ * @return ll 1 の n 乗根の逆数の k 乗
+ */
+ll NttMod19529729Deg131072M::PowPhi(ll k) const {
+    return montgomery_.Reduction(NttBase::PowPhi(k));
+}
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ */
+NttGeneric::NttGeneric(ll mod, ll n) :
+        NttGeneric(mod, n, ComputeOmega(CheckMod(mod), n)) {}
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ * @param[in] omega 1 の n 乗根．
+ */
+NttGeneric::NttGeneric(ll mod, ll n, ll omega) :
+        NttBase(mod,
+                omega,
+                Utility::InvMod(omega, mod),
+                n,
+                Utility::InvMod(n % mod, mod),
+                Utility::Log2(n)) {}
+
+/*
+ * モジュラスが積を ll で扱える素数であることを確認して返す．
+ *
+ * Butterfly は (w b) % mod を ll で計算するため，mod は 2^31 未満とする．
+ *
+ * @param[in] mod モジュラス．
+ * @return ll モジュラス
+ */
+ll NttGeneric::CheckMod(ll mod) {
+    if (mod >= (1LL << 31)) {
+        throw std::invalid_argument("mod must be less than 2^31");
+    }
+    if (!Utility::IsPrime(mod)) {
+        throw std::invalid_argument("mod must be prime");
+    }
+    return mod;
+}
+
+/*
+ * 1 の n 乗根を求めて返す．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ * @return ll 1 の n 乗根
+ */
+ll NttGeneric::ComputeOmega(ll mod, ll n) {
+    if (n < 2 || (n & (n - 1)) != 0) {
+        throw std::invalid_argument("n must be a power of two (n >= 2)");
+    }
+
+    if ((mod - 1) % n != 0) {
+        throw std::invalid_argument("mod - 1 must be divisible by n");
+    }
+
+    ll g = Utility::PrimitiveRoot(mod);
+    return Utility::PowMod(g, (mod - 1) / n, mod);
+}
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ */
+NttHarvey::NttHarvey(ll mod, ll n) :
+        NttGeneric(CheckMod(mod), n),
+        omega_shoup_(omega_pows_.size()),
+        phi_shoup_(phi_pows_.size()) {
+    for (size_t i = 0; i < omega_pows_.size(); i++) {
+        omega_shoup_[i] = ShoupQuotient(omega_pows_[i], mod_);
+        phi_shoup_[i] = ShoupQuotient(phi_pows_[i], mod_);
+    }
+
+    // 2 段をまとめたバタフライ演算で走査の回数を減らす方が速い
+    schedule_ = Schedule::kBlocked;
+}
+
+/*
+ * 数列の各要素にスカラーを掛けて [0, mod) に正規化して返す．
+ *
+ * @param[in,out] a 数列 (各要素は [0, 4 mod))．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttHarvey::MultScalar(ll *a, ll m, ll s) const {
+    HarveyMultScalar(a, m, s, mod_);
+}
+
+/*
+ * 32 ビットで格納した数列の各要素にスカラーを掛けて [0, mod) に正規化して返す．
+ *
+ * @param[in,out] a 数列 (各要素は [0, 4 mod))．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttHarvey::MultScalar(u32 *a, ll m, ll s) const {
+    HarveyMultScalar(a, m, s, mod_);
+}
+
+/*
+ * 第 l 段の遅延リダクションのバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttHarvey::TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                               bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+    const ll *w_shoup = inverse ? &phi_shoup_[max_r] : &omega_shoup_[max_r];
+    HarveyStage(a, l, q_begin, q_end, r_begin, r_end, w, w_shoup, mod_);
+}
+
+/*
+ * 第 l 段の周波数間引きのバタフライ演算を遅延リダクションで実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttHarvey::TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                  ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    HarveyStageDif(a, l, q_begin, q_end, r_begin, r_end, &omega_pows_[max_r],
+                   &omega_shoup_[max_r], mod_);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l 段の周波数間引きのバタフライ演算を
+ * 遅延リダクションで実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttHarvey::TransformStageDif(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                  ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    HarveyStageDif(a, l, q_begin, q_end, r_begin, r_end, &omega_pows_[max_r],
+                   &omega_shoup_[max_r], mod_);
+}
+
+/*
+ * 第 l + 1 段と第 l 段の周波数間引きの遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttHarvey::TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                      ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    HarveyStageDifPair(a, l, q_begin, q_end, r_begin, r_end, &omega_pows_[max_r],
+                       &omega_shoup_[max_r], mod_);
+}
+
+/*
+ * 32 ビットで格納した数列に対して，第 l + 1 段と第 l 段の周波数間引きの
+ * 遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ */
+void NttHarvey::TransformStageDifPair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                      ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    HarveyStageDifPair(a, l, q_begin, q_end, r_begin, r_end, &omega_pows_[max_r],
+                       &omega_shoup_[max_r], mod_);
+}
+
+/*
+ * 第 l 段と第 l + 1 段の遅延リダクションのバタフライ演算を 1 回の走査で実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttHarvey::TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                   bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+    const ll *w_shoup = inverse ? &phi_shoup_[max_r] : &omega_shoup_[max_r];
+    HarveyStagePair(a, l, q_begin, q_end, r_begin, r_end, w, w_shoup, mod_);
 }
 
 /*
- * 数列の逆離散フーリエ変換を計算して返す．
+ * 32 ビットで格納した数列に対して，第 l 段の遅延リダクションのバタフライ演算のうち
+ * q_begin <= q < q_end かつ r_begin <= r < r_end の範囲を実行する．
  *
  * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
  */
-void NttNaive::Idft(ll *a) const {
-    ll *c = new ll[n_];
-    for (ll i = 0; i < n_; i++) {
-        c[i] = 0;
-        for (ll j = 0; j < n_; j++) {
-            c[i] += Pow(phi_, j*i) * a[j];
-        }
-        c[i] %= mod_;
-    }
-
-    for (ll i = 0; i < n_; i++) {
-        c[i] = (c[i] * n_inv_) % mod_;
-    }
-
-    for (ll i = 0; i < n_; i++) {
-        a[i] = c[i];
-    }
-
-    delete[] c; c = nullptr;
+void NttHarvey::TransformStage(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                               bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+    const ll *w_shoup = inverse ? &phi_shoup_[max_r] : &omega_shoup_[max_r];
+    HarveyStage(a, l, q_begin, q_end, r_begin, r_end, w, w_shoup, mod_);
 }
 
 /*
- * べき乗を計算して返す．
+ * 32 ビットで格納した数列に対して，第 l 段と第 l + 1 段の遅延リダクションの
+ * バタフライ演算を 1 回の走査で実行する．
  *
- * @param[in] x 基数
- * @param[in] k 指数
- * @return ll x の k 乗
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
  */
-ll NttNaive::Pow(ll x, ll k) const {
-    ll p = x;
-    ll v = 1;
-    if (k == 0) {
-        return v;
-    }
-
-    while (k >= 1) {
-        if ((k & 1) == 1) {
-            v = (v * p) % mod_;
-        }
-        k >>= 1;
-        p = (p * p) % mod_;
-    }
-
-    return v;
+void NttHarvey::TransformStagePair(u32 *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                   bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
+    const ll *w_shoup = inverse ? &phi_shoup_[max_r] : &omega_shoup_[max_r];
+    HarveyStagePair(a, l, q_begin, q_end, r_begin, r_end, w, w_shoup, mod_);
 }
 
 /*
- * 数列の離散フーリエ変換を計算して返す．
+ * [0, 4 mod) の数列を [0, mod) に正規化する．
  *
- * @param[in,out] 数列．変換後の数列を上書きして返す．
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
  */
-void NttBase::Dft(ll *a) const {
-    Reverse(a);
-
-    ll m = log_n_;
-
-    for (ll l = 1; l <= m; l++) {
-        ll max_q = (1 << (m - l));
-        for (ll q = 0; q < max_q; q++) {
-            ll max_r = (1 << (l - 1));
-            for (ll r = 0; r < max_r; r++) {
-                ll k = (q << l) + r;
-                Butterfly(a[k], a[k + max_r], r << (m - l));
-            }
-        }
-    }
+void NttHarvey::Normalize(ll *a, ll m) const {
+    HarveyNormalize(a, m, mod_);
 }
 
 /*
- * 数列の逆離散フーリエ変換を計算して返す．
+ * 32 ビットで格納した [0, 4 mod) の数列を [0, mod) に正規化する．
  *
  * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
  */
-void NttBase::Idft(ll *a) const {
-    Reverse(a);
+void NttHarvey::Normalize(u32 *a, ll m) const {
+    HarveyNormalize(a, m, mod_);
+}
 
-    ll m = log_n_;
+/*
+ * モジュラスが遅延リダクションで扱える範囲であることを確認して返す．
+ *
+ * @param[in] mod モジュラス．
+ * @return ll モジュラス
+ */
+ll NttHarvey::CheckMod(ll mod) {
+    if (mod >= (1LL << 30)) {
+        throw std::invalid_argument("mod must be less than 2^30");
+    }
+    return mod;
+}
 
-    for (ll l = 1; l <= m; l++) {
-        ll max_q = (1 << (m - l));
-        for (ll q = 0; q < max_q; q++) {
-            ll max_r = (1 << (l - 1));
-            for (ll r = 0; r < max_r; r++) {
-                ll k = (q << l) + r;
-                ButterflyInv(a[k], a[k + max_r], r << (m - l));
-            }
-        }
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス (2^62 未満の素数)．
+ * @param[in] n 次数．
+ */
+NttMontgomery64::NttMontgomery64(ll mod, ll n) :
+        NttGeneric(mod, n, ComputeOmega(CheckMod(mod), n)),
+        montgomery_(mod) {
+    for (ll& w : omega_pows_) {
+        w = montgomery_.ToMontgomery(w);
     }
 
-    for (ll i = 0; i < n_; i++) {
-        a[i] = (a[i] * n_inv_) % mod_;
+    for (ll& w : phi_pows_) {
+        w = montgomery_.ToMontgomery(w);
     }
 }
 
 /*
- * バタフライ演算を実行して結果を返す．
+ * 離散フーリエ変換でのバタフライ演算を実行して結果を返す．
  *
  * @param[in,out] a 要素
  * @param[in,out] b 要素
- * @param[in] k 指数
+ * @param[in] w 回転因子 (モンゴメリ表現)
  */
-void NttBase::Butterfly(ll& a, ll& b, ll k) const {
-    ll tmp = (PowOmega(k) * b) % mod_;
-    ll minus_tmp = (mod_ - tmp) % mod_;
+void NttMontgomery64::Butterfly(ll& a, ll& b, ll w) const {
+    ll tmp = montgomery_.MultReduction(w, b);
 
-    b = (a + minus_tmp) % mod_;
-    a = (a + tmp) % mod_;
+    b = a + mod_ - tmp;
+    b = (b >= mod_) ? b - mod_ : b;
+
+    a = a + tmp;
+    a = (a >= mod_) ? a - mod_ : a;
 }
 
 /*
- * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+ * 周波数間引きのバタフライ演算を実行して結果を返す．
  *
  * @param[in,out] a 要素
  * @param[in,out] b 要素
- * @param[in] k 指数
+ * @param[in] w 回転因子 (モンゴメリ表現)
  */
-void NttBase::ButterflyInv(ll& a, ll& b, ll k) const {
-    ll tmp = (PowPhi(k) * b) % mod_;
-    ll minus_tmp = (mod_ - tmp) % mod_;
+void NttMontgomery64::ButterflyDif(ll& a, ll& b, ll w) const {
+    ll diff = a + mod_ - b;
+    diff = (diff >= mod_) ? diff - mod_ : diff;
 
-    b = (a + minus_tmp) % mod_;
-    a = (a + tmp) % mod_;
+    a = a + b;
+    a = (a >= mod_) ? a - mod_ : a;
+    b = montgomery_.MultReduction(w, diff);
 }
 
 /*
- * べき乗を計算して返す．
+ * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
  *
- * @param[in] x 基数
- * @param[in] k 指数
- * @return ll x の k 乗
+ * @param[in,out] a 要素
+ * @param[in,out] b 要素
+ * @param[in] w 回転因子 (モンゴメリ表現)
  */
-ll NttBase::Pow(ll x, ll k) const {
-    ll p = x;
-    ll v = 1;
-    if (k == 0) {
-        return v;
-    }
-
-    while (k >= 1) {
-        if ((k & 1) == 1) {
-            v = (v * p) % mod_;
-        }
-        k >>= 1;
-        p = (p * p) % mod_;
-    }
-
-    return v;
+void NttMontgomery64::ButterflyInv(ll& a, ll& b, ll w) const {
+    Butterfly(a, b, w);
 }
 
 /*
- * 1 の n 乗根のべき乗を計算して返す．
+ * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
  *
- * @param[in] k 指数
- * @return ll 1 の n 乗根の k 乗
+ * @param[in,out] a 数列．
  */
-ll NttMod337Deg8::PowOmega(ll k) const {
-    return omega_pows_[k % n_];
+void NttMontgomery64::Dft(u32 *a) const {
+    (void)a;
+    throw std::invalid_argument("NttMontgomery64 does not support 32-bit sequences");
 }
 
 /*
- * 1 の n 乗根の逆元のべき乗を計算して返す．
+ * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
  *
- * @param[in] k 指数
- * @return ll 1 の n 乗根の逆数の k 乗
+ * @param[in,out] a 数列．
  */
-ll NttMod337Deg8::PowPhi(ll k) const {
-    return phi_pows_[k % n_];
+void NttMontgomery64::Idft(u32 *a) const {
+    (void)a;
+    throw std::invalid_argument("NttMontgomery64 does not support 32-bit sequences");
 }
 
 /*
- * コンストラクタ．
+ * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
  *
- * @param[in] mod モジュラス．
- * @param[in] omega 1 の n 乗根．
- * @param[in] phi 1 の n 乗根の逆元．
- * @param[in] n 次数．
- * @param[in] n_inv 次数の逆元．
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列．
+ * @param[in] n 数列の長さ．
  */
-NttNaive::NttNaive(ll mod, ll omega, ll phi, ll n, ll n_inv) : 
-        mod_(mod), omega_(omega), phi_(phi), n_(n), n_inv_(n_inv){}
+void NttMontgomery64::MultVec(const u32 *a, const u32 *b, u32 *c, ll n) const {
+    (void)a;
+    (void)b;
+    (void)c;
+    (void)n;
+    throw std::invalid_argument("NttMontgomery64 does not support 32-bit sequences");
+}
 
 /*
- * コンストラクタ．
+ * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
  *
- * @param[in] mod モジュラス．
- * @param[in] omega 1 の n 乗根．
- * @param[in] phi 1 の n 乗根の逆元．
- * @param[in] n 次数．
- * @param[in] n_inv 次数の逆元．
- * @param[in] log_n 次数が 2 の何乗か
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列．
+ * @param[in,out] work 作業領域．
  */
-NttBase::NttBase(ll mod, ll omega, ll phi, ll n, ll n_inv, ll log_n) :
-        mod_(mod),
-        omega_(omega),
-        phi_(phi),
-        n_(n),
-        n_inv_(n_inv),
-        log_n_(log_n) {}
-
-/* コンストラクタ */
-NttMod337Deg8::NttMod337Deg8() :
-        NttBase(kMod, kOmega, kPhi, kN, kNInv, kLogN) {
-
-    ll omega_pows[] { 85, 148, 111, 136, 252, 189, 226 };
-
-    omega_pows_[0] = 1;
-    phi_pows_[0] = 1;
-
-    for (ll i = 1; i < n_; i++) {
-        omega_pows_[i] = omega_pows[i - 1];
-        phi_pows_[i] = omega_pows[n_ - i - 1];
-    }
+void NttMontgomery64::Mult(const u32 *a, const u32 *b, u32 *c, Workspace *work) const {
+    (void)a;
+    (void)b;
+    (void)c;
+    (void)work;
+    throw std::invalid_argument("NttMontgomery64 does not support 32-bit sequences");
 }
 
-/* コンストラクタ */
-NttNaiveMod337Deg8::NttNaiveMod337Deg8() :
-        NttNaive(kMod, kOmega, kPhi, kN, kNInv) {}
-
-/* コンストラクタ */
-NttMod19529729Deg131072::NttMod19529729Deg131072() :
-        NttBase(kMod, kOmega, kPhi, kN, kNInv, kLogN) {
+/*
+ * 32 ビットで格納した数列は扱えないため，常に例外を送出する．
+ *
+ * @param[in] a 数列．
+ * @param[out] c 数列．
+ */
+void NttMontgomery64::Square(const u32 *a, u32 *c) const {
+    (void)a;
+    (void)c;
+    throw std::invalid_argument("NttMontgomery64 does not support 32-bit sequences");
 }
 
-/* コンストラクタ */
-NttMod19529729Deg131072M::NttMod19529729Deg131072M() :
-        NttBase(kMod, kOmega, kPhi, kN, kNInv, kLogN) {
+/*
+ * 長さ n の数列の要素ごとの積を計算して返す．
+ *
+ * @param[in] a 数列．
+ * @param[in] b 数列．
+ * @param[out] c 数列 a と b の要素ごとの積．
+ * @param[in] n 数列の長さ．
+ */
+void NttMontgomery64::MultVec(const ll *a, const ll *b, ll *c, ll n) const {
+    for (ll i = 0; i < n; i++) {
+        c[i] = montgomery_.Mult(a[i], b[i]);
+    }
 }
 
-/* コンストラクタ */
-NttNaiveMod19529729Deg131072::NttNaiveMod19529729Deg131072() :
-        NttNaive(kMod, kOmega, kPhi, kN, kNInv) {
+/*
+ * mod でべき乗を計算して返す．
+ *
+ * @param[in] x 基数
+ * @param[in] k 指数
+ * @return ll x の k 乗
+ */
+ll NttMontgomery64::Pow(ll x, ll k) const {
+    return montgomery_.Pow(x, k);
 }
 
 /*
@@ -331,8 +2505,8 @@ NttNaiveMod19529729Deg131072::NttNaiveMod19529729Deg131072() :
  * @param[in] k 指数
  * @return ll 1 の n 乗根の k 乗
  */
-ll NttMod19529729Deg131072::PowOmega(ll k) const {
-    return Pow(omega_, k);
+ll NttMontgomery64::PowOmega(ll k) const {
+    return montgomery_.Reduction(NttBase::PowOmega(k));
 }
 
 /*
@@ -341,103 +2515,185 @@ ll NttMod19529729Deg131072::PowOmega(ll k) const {
  * @param[in] k 指数
  * @return ll 1 の n 乗根の逆数の k 乗
  */
-ll NttMod19529729Deg131072::PowPhi(ll k) const {
-    return Pow(phi_, k);
+ll NttMontgomery64::PowPhi(ll k) const {
+    return montgomery_.Reduction(NttBase::PowPhi(k));
 }
 
 /*
- * 数列の要素ごとの積を計算して返す．
+ * 数列の各要素にスカラーを掛けて返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] m 数列の長さ．
+ * @param[in] s スカラー．
+ */
+void NttMontgomery64::MultScalar(ll *a, ll m, ll s) const {
+    ll s_m = montgomery_.ToMontgomery(s);
+    for (ll i = 0; i < m; i++) {
+        a[i] = montgomery_.MultReduction(a[i], s_m);
+    }
+}
+
+/*
+ * 畳み込みの途中で離散フーリエ変換した数列の要素ごとの積を 1 回のリダクションで計算して返す．
  *
  * @param[in] a 数列．
  * @param[in] b 数列．
- * @param[out] c 数列 a と b の要素ごとの積．
+ * @param[out] c 数列 a と b の要素ごとの積に R^-1 を掛けたもの．
+ * @param[in] n 数列の長さ．
  */
-void NttMod19529729Deg131072M::MultVec(ll *a, ll *b, ll *c) const {
-    for (ll i = 0; i < n_; i++) {
-        c[i] = montgomery_.Mult(a[i], b[i]);
+void NttMontgomery64::MultPointwise(const ll *a, const ll *b, ll *c, ll n) const {
+    for (ll i = 0; i < n; i++) {
+        c[i] = montgomery_.MultReduction(a[i], b[i]);
     }
 }
 
 /*
- * 数列の逆離散フーリエ変換を計算して返す．
+ * MultPointwise の結果を通常の積に戻すために掛ける係数 R mod N を返す．
  *
- * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @return ll R mod N
  */
-void NttMod19529729Deg131072M::Idft(ll *a) const {
-    Reverse(a);
-
-    ll m = log_n_;
-
-    for (ll l = 1; l <= m; l++) {
-        ll max_q = (1 << (m - l));
-        for (ll q = 0; q < max_q; q++) {
-            ll max_r = (1 << (l - 1));
-            for (ll r = 0; r < max_r; r++) {
-                ll k = (q << l) + r;
-                ButterflyInv(a[k], a[k + max_r], r << (m - l));
-            }
-        }
-    }
+ll NttMontgomery64::PointwiseFactor() const {
+    return montgomery_.ToMontgomery(1);
+}
 
-    for (ll i = 0; i < n_; i++) {
-        a[i] = montgomery_.Mult(a[i], n_inv_);
+/*
+ * 離散フーリエ変換した数列をモンゴメリ表現のスペクトルに変換する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] n 数列の長さ．
+ */
+void NttMontgomery64::ToSpectrum(ll *a, ll n) const {
+    for (ll i = 0; i < n; i++) {
+        a[i] = montgomery_.ToMontgomery(a[i]);
     }
 }
 
 /*
- * バタフライ演算を実行して結果を返す．
+ * モンゴメリ表現のスペクトルと数列の要素ごとの積を計算して返す．
  *
- * @param[in,out] a 要素
- * @param[in,out] b 要素
- * @param[in] k 指数
+ * @param[in] s スペクトル (モンゴメリ表現)．
+ * @param[in] x 数列．
+ * @param[out] c 数列 s と x の要素ごとの積．
+ * @param[in] n 数列の長さ．
  */
-void NttMod19529729Deg131072M::Butterfly(ll& a, ll& b, ll k) const {
-    ll tmp = montgomery_.Mult(PowOmega(k), b);
-    ll minus_tmp = mod_ - tmp;
+void NttMontgomery64::MultSpectrum(const ll *s, const ll *x, ll *c, ll n) const {
+    MultPointwise(s, x, c, n);
+}
 
-    b = a + minus_tmp;
-    b = (b >= mod_) ? b - mod_ : b;
+/*
+ * 第 l 段のバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttMontgomery64::TransformStage(ll *a, ll l, ll q_begin, ll q_end, ll r_begin, ll r_end,
+                                     bool inverse) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = inverse ? &phi_pows_[max_r] : &omega_pows_[max_r];
 
-    a = a + tmp;
-    a = (a >= mod_) ? a - mod_ : a;
+    for (ll q = q_begin; q < q_end; q++) {
+        ll *x = a + (q << l);
+        ll *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r++) {
+            ll tmp = montgomery_.MultReduction(w[r], y[r]);
+            ll diff = x[r] + mod_ - tmp;
+            ll sum = x[r] + tmp;
+            y[r] = (diff >= mod_) ? diff - mod_ : diff;
+            x[r] = (sum >= mod_) ? sum - mod_ : sum;
+        }
+    }
 }
 
 /*
- * 逆離散フーリエ変換でのバタフライ演算を実行して結果を返す．
+ * 第 l 段の周波数間引きのバタフライ演算のうち，q_begin <= q < q_end かつ
+ * r_begin <= r < r_end の範囲を実行する．
  *
- * @param[in,out] a 要素
- * @param[in,out] b 要素
- * @param[in] k 指数
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
  */
-void NttMod19529729Deg131072M::ButterflyInv(ll& a, ll& b, ll k) const {
-    ll tmp = montgomery_.Mult(PowPhi(k), b);
-    ll minus_tmp = mod_ - tmp;
+void NttMontgomery64::TransformStageDif(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                        ll r_end) const {
+    ll max_r = (1LL << (l - 1));
+    const ll *w = &omega_pows_[max_r];
 
-    b = a + minus_tmp;
-    b = (b >= mod_) ? b - mod_ : b;
+    for (ll q = q_begin; q < q_end; q++) {
+        ll *x = a + (q << l);
+        ll *y = x + max_r;
+        for (ll r = r_begin; r < r_end; r++) {
+            ll diff = x[r] + mod_ - y[r];
+            ll sum = x[r] + y[r];
+            x[r] = (sum >= mod_) ? sum - mod_ : sum;
+            y[r] = montgomery_.MultReduction(w[r], (diff >= mod_) ? diff - mod_ : diff);
+        }
+    }
+}
 
-    a = a + tmp;
-    a = (a >= mod_) ? a - mod_ : a;
+/*
+ * 第 l 段と第 l + 1 段のバタフライ演算を段ごとに順に実行する．
+ *
+ * 128 ビットの積が律速となるため，2 段を 1 回の走査にまとめるとレジスタが不足して遅くなる．
+ * ブロック単位の実行によるキャッシュの局所性のみを得る．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 前半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttMontgomery64::TransformStagePair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                         ll r_end, bool inverse) const {
+    ll h = 1LL << (l - 1);
+    TransformStage(a, l, 2 * q_begin, 2 * q_end, r_begin, r_end, inverse);
+    TransformStage(a, l + 1, q_begin, q_end, r_begin, r_end, inverse);
+    TransformStage(a, l + 1, q_begin, q_end, r_begin + h, r_end + h, inverse);
 }
 
 /*
- * 1 の n 乗根のべき乗を計算して返す．
+ * 第 l + 1 段と第 l 段の周波数間引きのバタフライ演算を段ごとに順に実行する．
  *
- * @param[in] k 指数
- * @return ll 1 の n 乗根の k 乗
+ * TransformStagePair と同じ理由で 2 段を 1 回の走査にはまとめない．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ * @param[in] l 後半の段
+ * @param[in] q_begin q の開始
+ * @param[in] q_end q の終了
+ * @param[in] r_begin r の開始
+ * @param[in] r_end r の終了
  */
-ll NttMod19529729Deg131072M::PowOmega(ll k) const {
-    return montgomery_.Pow(omega_, k);
+void NttMontgomery64::TransformStageDifPair(ll *a, ll l, ll q_begin, ll q_end, ll r_begin,
+                                            ll r_end) const {
+    ll h = 1LL << (l - 1);
+    TransformStageDif(a, l + 1, q_begin, q_end, r_begin, r_end);
+    TransformStageDif(a, l + 1, q_begin, q_end, r_begin + h, r_end + h);
+    TransformStageDif(a, l, 2 * q_begin, 2 * q_end, r_begin, r_end);
 }
 
 /*
- * 1 の n 乗根の逆元のべき乗を計算して返す．
+ * モジュラスが 64 ビットのモンゴメリ乗算で扱える範囲であることを確認して返す．
  *
- * @param[in] k 指数
- * @return ll 1 の n 乗根の逆数の k 乗
+ * @param[in] mod モジュラス．
+ * @return ll モジュラス
  */
-ll NttMod19529729Deg131072M::PowPhi(ll k) const {
-    return montgomery_.Pow(phi_, k);
+ll NttMontgomery64::CheckMod(ll mod) {
+    if (mod >= (1LL << 62)) {
+        throw std::invalid_argument("mod must be less than 2^62");
+    }
+    if (!Utility::IsPrime(mod)) {
+        throw std::invalid_argument("mod must be prime");
+    }
+    return mod;
 }
 
 } // namespace ntt
@@ -0,0 +1,215 @@
+/**
+ * @file ntt_crt.cpp
+ * @brief 複数のモジュラスによる畳み込みを中国剰余定理で復元するクラスを実装するソースファイル．
+ */
+
+#include "include/ntt_crt.hpp"
+#include "include/util.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * 素数ごとの畳み込みの内部で用いるスレッドごとの作業領域を返す．
+ *
+ * 呼び出し側の作業領域と領域が重ならないよう，別に保持する．
+ *
+ * @return Workspace& 呼び出したスレッドの作業領域
+ */
+Workspace& CrtWorkspace() {
+    static thread_local Workspace workspace;
+    return workspace;
+}
+
+} // namespace
+
+/*
+ * 既定の素数 998244353, 167772161, 469762049 を使うコンストラクタ．
+ *
+ * @param[in] n 次数．
+ */
+NttCrt::NttCrt(ll n) : NttCrt(n, { 998244353, 167772161, 469762049 }) {}
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] n 次数．
+ * @param[in] mods 互いに異なる素数．
+ */
+NttCrt::NttCrt(ll n, const std::vector<ll>& mods) :
+        n_(n), mods_(mods), pool_(nullptr) {
+    if (mods_.empty()) {
+        throw std::invalid_argument("mods must not be empty");
+    }
+    std::vector<ll> sorted = mods_;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        throw std::invalid_argument("mods must be distinct");
+    }
+
+    ll k = mods_.size();
+    engines_.reserve(k);
+    prefixes_.assign(k, AlignedVector<ll>());
+    prefix_invs_.assign(k, 1);
+    for (ll i = 0; i < k; i++) {
+        engines_.emplace_back(mods_[i], n_);
+
+        ll m = mods_[i];
+        ll prefix = 1;
+        for (ll j = 0; j < i; j++) {
+            prefixes_[i].push_back(prefix);
+            prefix = (prefix * (mods_[j] % m)) % m;
+        }
+        prefix_invs_[i] = Utility::InvMod(prefix, m);
+    }
+}
+
+/*
+ * 非負整数の数列の畳み込みを計算して返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ．
+ * @param[in] b 数列 (長さ len_b)．
+ * @param[in] len_b 数列 b の長さ．
+ * @param[out] c 数列 a と b の畳み込み．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void NttCrt::Mult(const ll *a, ll len_a, const ll *b, ll len_b, ll *c,
+                  Workspace *work) const {
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll len_c = MultDigits(a, len_a, b, len_b, work);
+    ll k = mods_.size();
+
+    // x = v_0 + v_1 m_0 + v_2 m_0 m_1 + ... を 2^64 を法として計算する
+    std::fill(c, c + len_c, 0);
+    std::uint64_t base = 1;
+    for (ll i = 0; i < k; i++) {
+        const ll *v = work->Buffer(i, len_c);
+        for (ll t = 0; t < len_c; t++) {
+            c[t] = static_cast<ll>(static_cast<std::uint64_t>(c[t]) +
+                                   static_cast<std::uint64_t>(v[t]) * base);
+        }
+        base *= static_cast<std::uint64_t>(mods_[i]);
+    }
+}
+
+/*
+ * 非負整数の数列の畳み込みを任意のモジュラスで計算して返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ．
+ * @param[in] b 数列 (長さ len_b)．
+ * @param[in] len_b 数列 b の長さ．
+ * @param[out] c 数列 a と b の畳み込みを mod で割った余り．
+ * @param[in] mod モジュラス．
+ * @param[in,out] work 作業領域．nullptr の場合はスレッドごとの既定の作業領域を用いる．
+ */
+void NttCrt::MultMod(const ll *a, ll len_a, const ll *b, ll len_b, ll *c, ll mod,
+                     Workspace *work) const {
+    if (mod < 1 || mod >= (1LL << 62)) {
+        throw std::invalid_argument("mod must be in [1, 2^62)");
+    }
+    if (work == nullptr) {
+        work = &Workspace::ThreadLocal();
+    }
+
+    ll len_c = MultDigits(a, len_a, b, len_b, work);
+    ll k = mods_.size();
+
+    std::fill(c, c + len_c, 0);
+    ll base = 1 % mod;
+    for (ll i = 0; i < k; i++) {
+        const ll *v = work->Buffer(i, len_c);
+        for (ll t = 0; t < len_c; t++) {
+            ll x = c[t] + Utility::MulMod(v[t] % mod, base, mod);
+            c[t] = (x >= mod) ? x - mod : x;
+        }
+        base = Utility::MulMod(base, mods_[i] % mod, mod);
+    }
+}
+
+/*
+ * 素数ごとの畳み込みを計算し，各係数の Garner の混合基数表現を返す．
+ *
+ * @param[in] a 数列 (長さ len_a)．
+ * @param[in] len_a 数列 a の長さ．
+ * @param[in] b 数列 (長さ len_b)．
+ * @param[in] len_b 数列 b の長さ．
+ * @param[in,out] work 作業領域．
+ * @return ll 畳み込みの長さ
+ */
+ll NttCrt::MultDigits(const ll *a, ll len_a, const ll *b, ll len_b, Workspace *work) const {
+    // 素数ごとの畳み込みはスレッドプールのタスクで実行するため，例外はここで送出する
+    if (len_a > n_ || len_b > n_) {
+        throw std::invalid_argument("input length must not exceed N()");
+    }
+    if (len_a <= 0 || len_b <= 0) {
+        return 0;
+    }
+
+    ll k = mods_.size();
+    ll len_c = std::min(len_a + len_b - 1, n_);
+
+    // 素数ごとの剰余を work の i 番目の領域に求める (並列実行前に確保する)
+    std::vector<ll *> residues(k);
+    for (ll i = 0; i < k; i++) {
+        residues[i] = work->Buffer(i, len_c);
+    }
+
+    // 同じ数列どうしの積は 2 乗として変換を 1 回で済ませる
+    bool square = (a == b && len_a == len_b);
+
+    auto task = [&](ll i) {
+        Workspace& local = CrtWorkspace();
+        ll m = mods_[i];
+        ll *ra = local.Buffer(2, len_a);
+        for (ll t = 0; t < len_a; t++) {
+            ra[t] = a[t] % m;
+        }
+        if (square) {
+            engines_[i].Square(ra, len_a, residues[i], &local);
+            return;
+        }
+
+        ll *rb = local.Buffer(3, len_b);
+        for (ll t = 0; t < len_b; t++) {
+            rb[t] = b[t] % m;
+        }
+        engines_[i].Mult(ra, len_a, rb, len_b, residues[i], &local);
+    };
+
+    if (pool_ == nullptr) {
+        for (ll i = 0; i < k; i++) {
+            task(i);
+        }
+    } else {
+        pool_->Run(k, task);
+    }
+
+    // Garner のアルゴリズム: v_i = (r_i - (v_0 + v_1 m_0 + ...)) (m_0 ... m_(i-1))^-1 mod m_i
+    for (ll i = 1; i < k; i++) {
+        ll m = mods_[i];
+        ll *v = residues[i];
+        for (ll t = 0; t < len_c; t++) {
+            ll sum = 0;
+            for (ll j = 0; j < i; j++) {
+                sum = (sum + (residues[j][t] % m) * prefixes_[i][j]) % m;
+            }
+            ll diff = v[t] - sum;
+            v[t] = (((diff < 0) ? diff + m : diff) * prefix_invs_[i]) % m;
+        }
+    }
+
+    return len_c;
+}
+
+} // namespace ntt
@@ -0,0 +1,262 @@
+/**
+ * @file ntt_four_step.cpp
+ * @brief 4 段階法による大きな次数の Number theoretic transform のクラスを実装するソースファイル．
+ */
+
+#include "include/ntt_four_step.hpp"
+#include "include/shoup.hpp"
+#include "include/util.hpp"
+#include "include/workspace.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * 列の変換で用いるスレッドごとの作業領域を返す．
+ *
+ * 部分変換や畳み込みの作業領域と領域が重ならないよう，別に保持する．
+ *
+ * @return Workspace& 呼び出したスレッドの作業領域
+ */
+Workspace& FourStepWorkspace() {
+    static thread_local Workspace workspace;
+    return workspace;
+}
+
+/*
+ * モジュラスと次数が扱えるかを確認し，次数を返す．
+ *
+ * @param[in] mod モジュラス
+ * @param[in] n 次数
+ * @return ll 次数
+ * @throw std::invalid_argument mod または n が扱えない場合
+ */
+ll CheckSize(ll mod, ll n) {
+    if (n < 4 || (n & (n - 1)) != 0) {
+        throw std::invalid_argument("n must be a power of two (n >= 4)");
+    }
+    if (mod >= (1LL << 30)) {
+        throw std::invalid_argument("mod must be less than 2^30");
+    }
+    if ((mod - 1) % n != 0) {
+        throw std::invalid_argument("mod - 1 must be divisible by n");
+    }
+    return n;
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * 行数は √n 以上 (log n が奇数の場合は列数の 2 倍) とする．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ */
+NttFourStep::NttFourStep(ll mod, ll n) :
+        mod_(mod),
+        n_(CheckSize(mod, n)),
+        rows_(1LL << ((Utility::Log2(n) + 1) / 2)),
+        columns_(n / rows_),
+        omega_(Utility::PowMod(Utility::PrimitiveRoot(mod), (mod - 1) / n, mod)),
+        omega_inv_(Utility::InvMod(omega_, mod)),
+        column_ntt_(mod, rows_),
+        row_ntt_(mod, columns_),
+        bit_reversal_(Utility::Log2(n)),
+        row_reversal_(rows_) {
+    for (ll i = 0; i < rows_; i++) {
+        row_reversal_[i] = i;
+    }
+    BitReversal::ReverseIncremental(row_reversal_.data(), rows_);
+
+    ll width = std::min(kPanelWidth, columns_);
+    panel_twiddles_.resize(width * rows_);
+    panel_twiddles_shoup_.resize(width * rows_);
+    panel_twiddles_inv_.resize(width * rows_);
+    panel_twiddles_inv_shoup_.resize(width * rows_);
+    for (ll c = 0; c < width; c++) {
+        for (ll r = 0; r < rows_; r++) {
+            ll e = c * row_reversal_[r];
+            ll w = Utility::PowMod(omega_, e, mod_);
+            ll w_inv = Utility::PowMod(omega_inv_, e, mod_);
+            panel_twiddles_[c * rows_ + r] = w;
+            panel_twiddles_shoup_[c * rows_ + r] = ShoupQuotient(w, mod_);
+            panel_twiddles_inv_[c * rows_ + r] = w_inv;
+            panel_twiddles_inv_shoup_[c * rows_ + r] = ShoupQuotient(w_inv, mod_);
+        }
+    }
+}
+
+/*
+ * 数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttFourStep::Dft(ll *a) const {
+    DftPointwise(a);
+    bit_reversal_.Reverse(a, bit_reversal_.LogN());
+}
+
+/*
+ * 数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttFourStep::Idft(ll *a) const {
+    bit_reversal_.Reverse(a, bit_reversal_.LogN());
+    IdftPointwise(a);
+}
+
+/*
+ * 畳み込みのための離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttFourStep::DftPointwise(ll *a) const {
+    ColumnPass(a, false);
+    RowPass(a, false);
+}
+
+/*
+ * ビット反転した順序の数列の逆離散フーリエ変換を計算して返す．
+ *
+ * 部分変換がそれぞれ 1/n1, 1/n2 を掛けるため，全体で 1/n が掛かる．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttFourStep::IdftPointwise(ll *a) const {
+    RowPass(a, true);
+    ColumnPass(a, true);
+}
+
+/*
+ * 各列の変換と回転因子の乗算を行う．
+ *
+ * kPanelWidth 列ずつ作業領域に転置して集め，各列を連続した数列として変換する．
+ * 行の読み書きはいずれも kPanelWidth 要素ずつ連続する．
+ *
+ * @param[in,out] a 数列 (rows_ 行 columns_ 列)．変換後の数列を上書きして返す．
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttFourStep::ColumnPass(ll *a, bool inverse) const {
+    ll width = std::min(kPanelWidth, columns_);
+    ll num_panels = columns_ / width;
+
+    Run(num_panels, [&](ll panel) {
+        Workspace& work = FourStepWorkspace();
+        ll *buffer = work.Buffer(0, width * rows_);
+        ll *factors = work.Buffer(1, rows_);
+        ll *factors_shoup = work.Buffer(2, rows_);
+        ll first = panel * width;
+        PanelFactors(panel, inverse, factors, factors_shoup);
+
+        // 行の間隔が 4 KiB の倍数になりキャッシュのセットが衝突するため，
+        // width 行ずつ読んで各列へ連続して書き込む
+        for (ll j0 = 0; j0 < rows_; j0 += width) {
+            for (ll c = 0; c < width; c++) {
+                const ll *src = a + j0 * columns_ + first + c;
+                ll *dst = buffer + c * rows_ + j0;
+                for (ll j = 0; j < width; j++) {
+                    dst[j] = src[j * columns_];
+                }
+            }
+        }
+
+        const ll *twiddles = inverse ? panel_twiddles_inv_.data() : panel_twiddles_.data();
+        const ll *twiddles_shoup =
+            inverse ? panel_twiddles_inv_shoup_.data() : panel_twiddles_shoup_.data();
+        for (ll c = 0; c < width; c++) {
+            ll *column = buffer + c * rows_;
+            const ll *w = twiddles + c * rows_;
+            const ll *w_shoup = twiddles_shoup + c * rows_;
+            auto twist = [&]() {
+                for (ll r = 0; r < rows_; r++) {
+                    ll x = MultShoupReduced(column[r], w[r], w_shoup[r], mod_);
+                    column[r] = MultShoupReduced(x, factors[r], factors_shoup[r], mod_);
+                }
+            };
+
+            if (inverse) {
+                twist();
+                column_ntt_.IdftPointwise(column);
+            } else {
+                column_ntt_.DftPointwise(column);
+                twist();
+            }
+        }
+
+        for (ll k1 = 0; k1 < rows_; k1++) {
+            ll *row = a + k1 * columns_ + first;
+            for (ll c = 0; c < width; c++) {
+                row[c] = buffer[c * rows_ + k1];
+            }
+        }
+    });
+}
+
+/*
+ * 各行の変換を行う．
+ *
+ * @param[in,out] a 数列 (rows_ 行 columns_ 列)．変換後の数列を上書きして返す．
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttFourStep::RowPass(ll *a, bool inverse) const {
+    Run(rows_, [&](ll k1) {
+        ll *row = a + k1 * columns_;
+        if (inverse) {
+            row_ntt_.IdftPointwise(row);
+        } else {
+            row_ntt_.DftPointwise(row);
+        }
+    });
+}
+
+/*
+ * panel 番目の列のまとまりに共通する回転因子の部分 w^(±W panel rev(r)) を返す．
+ *
+ * 自然な順序のべき乗を Shoup の方法で順に求め，ビット反転した位置に置く．
+ *
+ * @param[in] panel 列のまとまりの番号
+ * @param[in] inverse 逆変換の場合 true
+ * @param[out] factors 行ごとの回転因子 (長さ rows_)
+ * @param[out] factors_shoup factors に対する Shoup の商 (長さ rows_)
+ */
+void NttFourStep::PanelFactors(ll panel, bool inverse, ll *factors, ll *factors_shoup) const {
+    ll width = std::min(kPanelWidth, columns_);
+    ll base = Utility::PowMod(inverse ? omega_inv_ : omega_, width * panel, mod_);
+    ll base_shoup = ShoupQuotient(base, mod_);
+
+    ll w = 1;
+    for (ll k = 0; k < rows_; k++) {
+        ll r = row_reversal_[k];
+        factors[r] = w;
+        factors_shoup[r] = ShoupQuotient(w, mod_);
+        w = MultShoupReduced(w, base, base_shoup, mod_);
+    }
+}
+
+/*
+ * 0 以上 num_tasks 未満の各 i について task(i) を実行する．
+ *
+ * @param[in] num_tasks タスクの数
+ * @param[in] task タスク
+ */
+void NttFourStep::Run(ll num_tasks, const std::function<void(ll)>& task) const {
+    if (pool_ == nullptr) {
+        for (ll i = 0; i < num_tasks; i++) {
+            task(i);
+        }
+    } else {
+        pool_->Run(num_tasks, task);
+    }
+}
+
+} // namespace ntt
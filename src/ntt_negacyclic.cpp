@@ -0,0 +1,187 @@
+/**
+ * @file ntt_negacyclic.cpp
+ * @brief x^n + 1 を法とする畳み込み (負巡回畳み込み) のためのクラスを実装するソースファイル．
+ */
+
+#include "include/ntt_negacyclic.hpp"
+#include "include/shoup.hpp"
+#include "include/util.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * モジュラスと次数が扱えるかを確認し，次数を返す．
+ *
+ * @param[in] mod モジュラス
+ * @param[in] n 次数
+ * @return ll 次数
+ * @throw std::invalid_argument mod または n が扱えない場合
+ */
+ll CheckSize(ll mod, ll n) {
+    if (n < 2 || (n & (n - 1)) != 0) {
+        throw std::invalid_argument("n must be a power of two (n >= 2)");
+    }
+    if (mod >= (1LL << 30)) {
+        throw std::invalid_argument("mod must be less than 2^30");
+    }
+    // 合成数では原始根が存在せず，ψ が 0 となって積が壊れる
+    if (mod <= 2 || !Utility::IsPrime(mod)) {
+        throw std::invalid_argument("mod must be an odd prime");
+    }
+    if ((mod - 1) % (2 * n) != 0) {
+        throw std::invalid_argument("mod - 1 must be divisible by 2n");
+    }
+    return n;
+}
+
+/*
+ * [0, 2 bound) の値から bound を引いて [0, bound) に収めて返す．
+ */
+inline ll Reduce(ll x, ll bound) {
+    return (x >= bound) ? x - bound : x;
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ */
+NttNegacyclic::NttNegacyclic(ll mod, ll n) :
+        mod_(mod),
+        n_(CheckSize(mod, n)),
+        psi_(Utility::PowMod(Utility::PrimitiveRoot(mod), (mod - 1) / (2 * n), mod)),
+        psi_rev_(n),
+        psi_rev_shoup_(n),
+        psi_inv_rev_(n),
+        psi_inv_rev_shoup_(n),
+        bit_reversal_(Utility::Log2(n)) {
+    ll psi_inv = Utility::InvMod(psi_, mod_);
+    ll w = 1;
+    ll w_inv = 1;
+    for (ll i = 0; i < n_; i++) {
+        psi_rev_[i] = w;
+        psi_inv_rev_[i] = w_inv;
+        w = (w * psi_) % mod_;
+        w_inv = (w_inv * psi_inv) % mod_;
+    }
+    bit_reversal_.Reverse(psi_rev_.data(), bit_reversal_.LogN());
+    bit_reversal_.Reverse(psi_inv_rev_.data(), bit_reversal_.LogN());
+
+    for (ll i = 0; i < n_; i++) {
+        psi_rev_shoup_[i] = ShoupQuotient(psi_rev_[i], mod_);
+        psi_inv_rev_shoup_[i] = ShoupQuotient(psi_inv_rev_[i], mod_);
+    }
+
+    n_inv_ = Utility::InvMod(n_ % mod_, mod_);
+    n_inv_shoup_ = ShoupQuotient(n_inv_, mod_);
+    last_twiddle_ = (n_inv_ * psi_inv_rev_[1]) % mod_;
+    last_twiddle_shoup_ = ShoupQuotient(last_twiddle_, mod_);
+}
+
+/*
+ * 数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttNegacyclic::Dft(ll *a) const {
+    ToPointwise(a);
+    bit_reversal_.Reverse(a, bit_reversal_.LogN());
+}
+
+/*
+ * 数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttNegacyclic::Idft(ll *a) const {
+    bit_reversal_.Reverse(a, bit_reversal_.LogN());
+    FromPointwise(a);
+}
+
+/*
+ * 環の元を要素ごとの積で乗算できる表現 (ビット反転した順序の変換) に変換する．
+ *
+ * 第 m 段 (m = 1, 2, 4, ...) の i 番目のブロックは回転因子 ψ^rev(m + i) の
+ * Cooley-Tukey のバタフライ演算を行う．値は [0, 4p) に留め，最終段で [0, p) に正規化する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttNegacyclic::ToPointwise(ll *a) const {
+    const ll p = mod_;
+    const ll p2 = 2 * p;
+
+    ll t = n_;
+    for (ll m = 1; m < n_; m <<= 1) {
+        t >>= 1;
+        bool last = (t == 1);
+        for (ll i = 0; i < m; i++) {
+            ll w = psi_rev_[m + i];
+            ll w_shoup = psi_rev_shoup_[m + i];
+            ll *x = a + 2 * i * t;
+            ll *y = x + t;
+            for (ll j = 0; j < t; j++) {
+                ll u = Reduce(x[j], p2);
+                ll v = MultShoupLazy(y[j], w, w_shoup, p);
+                x[j] = u + v;
+                y[j] = u - v + p2;
+                if (last) {
+                    x[j] = Reduce(Reduce(x[j], p2), p);
+                    y[j] = Reduce(Reduce(y[j], p2), p);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * ToPointwise で変換した表現を環の元に戻す．
+ *
+ * 第 m 段 (m = n/2, n/4, ..., 1) の i 番目のブロックは回転因子 ψ^-rev(m + i) の
+ * Gentleman-Sande のバタフライ演算を行う．値は [0, 2p) に留め，
+ * 最終段 (m = 1) で n^-1 を回転因子とまとめて掛けて [0, p) に正規化する．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void NttNegacyclic::FromPointwise(ll *a) const {
+    const ll p = mod_;
+    const ll p2 = 2 * p;
+
+    ll t = 1;
+    for (ll m = n_ >> 1; m > 1; m >>= 1) {
+        for (ll i = 0; i < m; i++) {
+            ll w = psi_inv_rev_[m + i];
+            ll w_shoup = psi_inv_rev_shoup_[m + i];
+            ll *x = a + 2 * i * t;
+            ll *y = x + t;
+            for (ll j = 0; j < t; j++) {
+                ll u = x[j];
+                ll v = y[j];
+                x[j] = Reduce(u + v, p2);
+                y[j] = MultShoupLazy(u - v + p2, w, w_shoup, p);
+            }
+        }
+        t <<= 1;
+    }
+
+    // 最終段: x' = (u + v) n^-1, y' = (u - v) ψ^-rev(1) n^-1
+    ll *x = a;
+    ll *y = a + t;
+    for (ll j = 0; j < t; j++) {
+        ll u = x[j];
+        ll v = y[j];
+        x[j] = MultShoupReduced(u + v, n_inv_, n_inv_shoup_, p);
+        y[j] = MultShoupReduced(u - v + p2, last_twiddle_, last_twiddle_shoup_, p);
+    }
+}
+
+} // namespace ntt
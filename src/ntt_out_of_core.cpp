@@ -0,0 +1,524 @@
+/**
+ * @file ntt_out_of_core.cpp
+ * @brief ファイルに置いた数列の Number theoretic transform を行うクラスを実装するソースファイル．
+ */
+
+#include "include/ntt_out_of_core.hpp"
+#include "include/aligned_memory.hpp"
+#include "include/util.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * モジュラスと次数が扱えるかを確認し，次数を返す．
+ *
+ * @param[in] mod モジュラス
+ * @param[in] n 次数
+ * @return ll 次数
+ * @throw std::invalid_argument mod が 2^62 未満の素数でないか，n が 4 以上の 2 のべき乗でないか，
+ *                              mod - 1 が n で割り切れない場合
+ */
+ll CheckSize(ll mod, ll n) {
+    if (n < 4 || (n & (n - 1)) != 0) {
+        throw std::invalid_argument("n must be a power of two (n >= 4)");
+    }
+    if (mod >= (1LL << 62) || !Utility::IsPrime(mod)) {
+        throw std::invalid_argument("mod must be a prime less than 2^62");
+    }
+    if ((mod - 1) % n != 0) {
+        throw std::invalid_argument("mod - 1 must be divisible by n");
+    }
+    return n;
+}
+
+/*
+ * ll の配列としてメモリマップしたファイル．
+ */
+class MappedFile {
+
+public:
+    /* ファイルの開き方 */
+    enum class Mode {
+        /* 読み込みのみ */
+        kRead,
+        /* 読み書き */
+        kReadWrite,
+        /* 作成 (既存の内容は捨てる) して読み書き */
+        kCreate,
+    };
+
+    /*
+     * コンストラクタ．
+     *
+     * @param[in] path ファイル
+     * @param[in] n 要素数
+     * @param[in] mode ファイルの開き方
+     * @throw std::invalid_argument 既存のファイルの大きさが n 個の ll と異なる場合
+     * @throw std::system_error ファイルを開けないかメモリマップできない場合
+     */
+    MappedFile(const std::string& path, ll n, Mode mode) : bytes_(n * sizeof(ll)) {
+        int flags = (mode == Mode::kRead) ? O_RDONLY : O_RDWR;
+        if (mode == Mode::kCreate) {
+            flags |= O_CREAT | O_TRUNC;
+        }
+        fd_ = open(path.c_str(), flags, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+        }
+
+        if (mode == Mode::kCreate) {
+            if (ftruncate(fd_, bytes_) != 0) {
+                int error = errno;
+                close(fd_);
+                throw std::system_error(error, std::generic_category(), "cannot resize " + path);
+            }
+        } else {
+            struct stat st;
+            if (fstat(fd_, &st) != 0 || st.st_size != static_cast<off_t>(bytes_)) {
+                close(fd_);
+                throw std::invalid_argument("file size must be N() * sizeof(ll): " + path);
+            }
+        }
+
+        int prot = (mode == Mode::kRead) ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void *data = mmap(nullptr, bytes_, prot, MAP_SHARED, fd_, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            close(fd_);
+            throw std::system_error(error, std::generic_category(), "cannot map " + path);
+        }
+        data_ = static_cast<ll *>(data);
+    }
+
+    /* デストラクタ． */
+    ~MappedFile() {
+        munmap(data_, bytes_);
+        close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /*
+     * 先頭の要素へのポインタを返す．
+     *
+     * @return ll* 先頭の要素へのポインタ
+     */
+    ll *Data() { return data_; }
+
+private:
+    /* ファイル記述子 */
+    int fd_;
+
+    /* ファイルの大きさ */
+    size_t bytes_;
+
+    /* マップした領域 */
+    ll *data_;
+};
+
+/*
+ * 連続した領域の先読みを OS に指示する．失敗しても無視する．
+ *
+ * @param[in] a 領域の先頭
+ * @param[in] count 要素数
+ */
+void Advise(const ll *a, ll count) {
+    std::uintptr_t page = sysconf(_SC_PAGESIZE);
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(a) & ~(page - 1);
+    std::uintptr_t end = reinterpret_cast<std::uintptr_t>(a + count);
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_WILLNEED);
+}
+
+/*
+ * ファイルを n 個の ll としてコピーする．
+ *
+ * @param[in] src コピー元のファイル
+ * @param[in] dst コピー先のファイル (存在しなければ作成する)
+ * @param[in] n 要素数
+ */
+void CopyFile(const std::string& src, const std::string& dst, ll n) {
+    MappedFile from(src, n, MappedFile::Mode::kRead);
+    MappedFile to(dst, n, MappedFile::Mode::kCreate);
+    std::copy(from.Data(), from.Data() + n, to.Data());
+}
+
+/*
+ * 対象のファイルと同じディレクトリに mkstemp で作る一時ファイル．
+ *
+ * 名前は対象のファイル名に一意な接尾辞を加えたものとし，同じファイルを扱う
+ * 複数の処理が衝突しない．Replace で対象と置き換えない限り，破棄するときに削除する．
+ */
+class TempFile {
+
+public:
+    /*
+     * コンストラクタ．
+     *
+     * 対象のファイルが存在すれば，そのアクセス権を一時ファイルに引き継ぐ．
+     *
+     * @param[in] target 対象のファイル
+     * @throw std::system_error 一時ファイルを作成できない場合
+     */
+    explicit TempFile(const std::string& target) {
+        std::vector<char> name(target.begin(), target.end());
+        const std::string suffix = ".ntt.XXXXXX";
+        name.insert(name.end(), suffix.begin(), suffix.end());
+        name.push_back('\0');
+
+        int fd = mkstemp(name.data());
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "cannot create a temporary file for " + target);
+        }
+        struct stat st;
+        if (stat(target.c_str(), &st) == 0) {
+            fchmod(fd, st.st_mode & 07777);
+        }
+        close(fd);
+        path_ = name.data();
+    }
+
+    /* デストラクタ．置き換えていなければ一時ファイルを削除する． */
+    ~TempFile() {
+        if (!path_.empty()) {
+            unlink(path_.c_str());
+        }
+    }
+
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    /*
+     * 一時ファイルのパスを返す．
+     *
+     * @return const std::string& パス
+     */
+    const std::string& Path() const { return path_; }
+
+    /*
+     * 一時ファイルで対象のファイルを置き換える．
+     *
+     * @param[in] target 置き換えるファイル
+     * @throw std::system_error 置き換えられない場合
+     */
+    void Replace(const std::string& target) {
+        if (std::rename(path_.c_str(), target.c_str()) != 0) {
+            throw std::system_error(errno, std::generic_category(), "cannot rename " + path_);
+        }
+        path_.clear();
+    }
+
+private:
+    /* 一時ファイルのパス (置き換えた後は空) */
+    std::string path_;
+};
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * 行数は √n 以上 (log n が奇数の場合は列数の 2 倍) とする．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] n 次数．
+ */
+NttOutOfCore::NttOutOfCore(ll mod, ll n) :
+        mod_(mod),
+        n_(CheckSize(mod, n)),
+        rows_(1LL << ((Utility::Log2(n) + 1) / 2)),
+        columns_(n / rows_),
+        omega_(0),
+        omega_inv_(0),
+        montgomery_(mod),
+        column_ntt_(mod, rows_),
+        row_ntt_(mod, columns_),
+        panel_columns_(std::max(1LL, std::min(columns_, kDefaultPanelElements / rows_))),
+        panel_rows_(std::max(1LL, std::min(rows_, kDefaultPanelElements / columns_))),
+        pool_(nullptr) {
+    omega_ = Utility::PowMod(Utility::PrimitiveRoot(mod_), (mod_ - 1) / n_, mod_);
+    omega_inv_ = Utility::InvMod(omega_, mod_);
+}
+
+/*
+ * メモリに読み込むパネルの大きさを設定する．
+ *
+ * @param[in] columns 列の変換で一度に読み込む列数．
+ * @param[in] rows 行の変換で一度に読み込む行数．
+ */
+void NttOutOfCore::SetPanelSize(ll columns, ll rows) {
+    if (columns < 1 || columns > columns_ || (columns & (columns - 1)) != 0) {
+        throw std::invalid_argument("columns must be a power of two in [1, Columns()]");
+    }
+    if (rows < 1 || rows > rows_ || (rows & (rows - 1)) != 0) {
+        throw std::invalid_argument("rows must be a power of two in [1, Rows()]");
+    }
+    panel_columns_ = columns;
+    panel_rows_ = rows;
+}
+
+/*
+ * ファイルに置いた数列の離散フーリエ変換を計算して上書きする．
+ *
+ * 行の変換の結果は転置して一時ファイルに書き出し，元のファイルと置き換える．
+ *
+ * @param[in] path 数列のファイル．
+ */
+void NttOutOfCore::Dft(const std::string& path) const {
+    TempFile temp(path);
+    {
+        MappedFile file(path, n_, MappedFile::Mode::kReadWrite);
+        ColumnPass(file.Data(), false);
+
+        MappedFile out(temp.Path(), n_, MappedFile::Mode::kCreate);
+        RowPass(file.Data(), out.Data(), false, false, true);
+    }
+    temp.Replace(path);
+}
+
+/*
+ * ファイルに置いた数列の逆離散フーリエ変換を計算して上書きする．
+ *
+ * 転置して読み込んだ行の逆変換を一時ファイルに書き出し，列の逆変換の後に元のファイルと置き換える．
+ *
+ * @param[in] path 数列のファイル．
+ */
+void NttOutOfCore::Idft(const std::string& path) const {
+    TempFile temp(path);
+    {
+        MappedFile file(path, n_, MappedFile::Mode::kRead);
+        MappedFile out(temp.Path(), n_, MappedFile::Mode::kCreate);
+        RowPass(file.Data(), out.Data(), true, true, false);
+        ColumnPass(out.Data(), true);
+    }
+    temp.Replace(path);
+}
+
+/*
+ * ファイルに置いた数列の畳み込みを計算してファイルに書き出す．
+ *
+ * 変換の結果は (k1, k2) 要素が X[k1 + n1 k2] となる順序のままとし，転置を行わない．
+ *
+ * @param[in] a 数列 a のファイル．
+ * @param[in] b 数列 b のファイル．
+ * @param[in] c 畳み込みを書き出すファイル．
+ */
+void NttOutOfCore::Mult(const std::string& a, const std::string& b, const std::string& c) const {
+    bool is_square = (a == b);
+    std::unique_ptr<TempFile> temp;
+    if (!is_square) {
+        temp.reset(new TempFile(c));
+        CopyFile(b, temp->Path(), n_);
+    }
+    if (c != a) {
+        CopyFile(a, c, n_);
+    }
+
+    {
+        MappedFile fc(c, n_, MappedFile::Mode::kReadWrite);
+        ColumnPass(fc.Data(), false);
+        RowPass(fc.Data(), fc.Data(), false, false, false);
+
+        if (is_square) {
+            row_ntt_.MultVec(fc.Data(), fc.Data(), fc.Data(), n_);
+        } else {
+            MappedFile ft(temp->Path(), n_, MappedFile::Mode::kReadWrite);
+            ColumnPass(ft.Data(), false);
+            RowPass(ft.Data(), ft.Data(), false, false, false);
+            row_ntt_.MultVec(fc.Data(), ft.Data(), fc.Data(), n_);
+        }
+
+        RowPass(fc.Data(), fc.Data(), true, false, false);
+        ColumnPass(fc.Data(), true);
+    }
+}
+
+/*
+ * 列の変換と回転因子の乗算を行う．
+ *
+ * PanelColumns() 列ずつ各行の連続した部分を読み込み，列ごとに連続するよう並べて変換する．
+ *
+ * @param[in,out] a 数列 (Rows() 行 Columns() 列)．変換後の数列を上書きして返す．
+ * @param[in] inverse 逆変換の場合 true
+ */
+void NttOutOfCore::ColumnPass(ll *a, bool inverse) const {
+    ll width = panel_columns_;
+    ll omega = inverse ? omega_inv_ : omega_;
+
+    auto gather = [&](ll panel, ll *buffer) {
+        ll first = panel * width;
+        for (ll r = 0; r < rows_; r++) {
+            const ll *row = a + r * columns_ + first;
+            for (ll c = 0; c < width; c++) {
+                buffer[c * rows_ + r] = row[c];
+            }
+        }
+    };
+
+    // process は同時に 1 つのパネルしか実行しないため，回転因子の行を共有する
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    ll *twiddles = arena.Allocate<ll>(rows_);
+
+    auto process = [&](ll panel, ll *buffer) {
+        ll first = panel * width;
+        for (ll c = 0; c < width; c++) {
+            ll *column = buffer + c * rows_;
+
+            // 回転因子はモンゴメリ表現で持ち，1 回のリダクションで通常の表現の積を得る
+            ll base = montgomery_.ToMontgomery(Utility::PowMod(omega, first + c, mod_));
+            ll w = montgomery_.ToMontgomery(1);
+            for (ll r = 0; r < rows_; r++) {
+                twiddles[r] = w;
+                w = montgomery_.MultReduction(w, base);
+            }
+            auto twist = [&]() {
+                for (ll r = 0; r < rows_; r++) {
+                    column[r] = montgomery_.MultReduction(column[r], twiddles[r]);
+                }
+            };
+
+            if (inverse) {
+                twist();
+                column_ntt_.Idft(column);
+            } else {
+                column_ntt_.Dft(column);
+                twist();
+            }
+        }
+
+        for (ll r = 0; r < rows_; r++) {
+            ll *row = a + r * columns_ + first;
+            for (ll c = 0; c < width; c++) {
+                row[c] = buffer[c * rows_ + r];
+            }
+        }
+    };
+
+    // 列のパネルは全行にまたがるため，先読みは別スレッドでの読み込みに任せる
+    RunPanels(columns_ / width, width * rows_, [](ll) {}, gather, process);
+}
+
+/*
+ * 行の変換を行う．
+ *
+ * @param[in] src 入力の数列．
+ * @param[out] dst 出力の数列．
+ * @param[in] inverse 逆変換の場合 true
+ * @param[in] src_transposed 入力が転置されていれば true
+ * @param[in] dst_transposed 転置して出力する場合 true
+ */
+void NttOutOfCore::RowPass(const ll *src, ll *dst, bool inverse, bool src_transposed,
+                           bool dst_transposed) const {
+    ll height = panel_rows_;
+    ll panel_size = height * columns_;
+
+    auto prefetch = [&](ll panel) {
+        if (!src_transposed) {
+            Advise(src + panel * panel_size, panel_size);
+        }
+    };
+
+    auto gather = [&](ll panel, ll *buffer) {
+        ll first = panel * height;
+        if (src_transposed) {
+            for (ll k2 = 0; k2 < columns_; k2++) {
+                const ll *part = src + k2 * rows_ + first;
+                for (ll r = 0; r < height; r++) {
+                    buffer[r * columns_ + k2] = part[r];
+                }
+            }
+        } else {
+            std::copy(src + first * columns_, src + first * columns_ + panel_size, buffer);
+        }
+    };
+
+    auto process = [&](ll panel, ll *buffer) {
+        for (ll r = 0; r < height; r++) {
+            if (inverse) {
+                row_ntt_.Idft(buffer + r * columns_);
+            } else {
+                row_ntt_.Dft(buffer + r * columns_);
+            }
+        }
+
+        ll first = panel * height;
+        if (dst_transposed) {
+            for (ll k2 = 0; k2 < columns_; k2++) {
+                ll *part = dst + k2 * rows_ + first;
+                for (ll r = 0; r < height; r++) {
+                    part[r] = buffer[r * columns_ + k2];
+                }
+            }
+        } else {
+            std::copy(buffer, buffer + panel_size, dst + first * columns_);
+        }
+    };
+
+    RunPanels(rows_ / height, panel_size, prefetch, gather, process);
+}
+
+/*
+ * パネルを順に読み込み，処理して書き戻す．
+ *
+ * @param[in] num_panels パネルの数
+ * @param[in] panel_size パネルの要素数
+ * @param[in] prefetch パネルの先読みを指示する関数
+ * @param[in] gather パネルを作業領域に読み込む関数
+ * @param[in] process 作業領域のパネルを処理して書き戻す関数
+ */
+void NttOutOfCore::RunPanels(ll num_panels, ll panel_size,
+                             const std::function<void(ll)>& prefetch,
+                             const std::function<void(ll, ll *)>& gather,
+                             const std::function<void(ll, ll *)>& process) const {
+    // パスごとに確保し直さないよう，作業領域はスレッドのアリーナから切り出す
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    ll *buffers[2] = { arena.Allocate<ll>(panel_size), arena.Allocate<ll>(panel_size) };
+    gather(0, buffers[0]);
+
+    for (ll panel = 0; panel < num_panels; panel++) {
+        ll *current = buffers[panel & 1];
+        ll *next = buffers[(panel + 1) & 1];
+        bool has_next = (panel + 1 < num_panels);
+        if (has_next) {
+            prefetch(panel + 1);
+        }
+
+        if (has_next && pool_ != nullptr) {
+            pool_->Run(2, [&](ll i) {
+                if (i == 0) {
+                    gather(panel + 1, next);
+                } else {
+                    process(panel, current);
+                }
+            });
+        } else {
+            process(panel, current);
+            if (has_next) {
+                gather(panel + 1, next);
+            }
+        }
+    }
+}
+
+} // namespace ntt
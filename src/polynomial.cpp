@@ -0,0 +1,728 @@
+/**
+ * @file polynomial.cpp
+ * @brief Number theoretic transform による多項式演算のクラスを実装するソースファイル．
+ */
+
+#include "include/polynomial.hpp"
+#include "include/aligned_memory.hpp"
+#include "include/util.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * 多項式の末尾の 0 を取り除く．
+ *
+ * @param[in,out] a 多項式
+ */
+void Trim(std::vector<ll>& a) {
+    while (!a.empty() && a.back() == 0) {
+        a.pop_back();
+    }
+}
+
+/*
+ * n 以上の最小の 2 のべき乗を返す．
+ *
+ * @param[in] n 正の整数
+ * @return ll n 以上の最小の 2 のべき乗
+ */
+ll CeilPow2(ll n) {
+    ll m = 1;
+    while (m < n) {
+        m <<= 1;
+    }
+    return m;
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] mod モジュラス．
+ * @param[in] max_n 変換の長さの上限．
+ */
+PolynomialRing::PolynomialRing(ll mod, ll max_n) :
+        mod_(mod),
+        engine_(mod, max_n),
+        omega_pows_(max_n / 2),
+        invs_(max_n + 1, 0) {
+    // NttGeneric と同じ 1 の max_n 乗根を用いる
+    ll omega = Utility::PowMod(Utility::PrimitiveRoot(mod_), (mod_ - 1) / max_n, mod_);
+    ll w = 1;
+    for (size_t i = 0; i < omega_pows_.size(); i++) {
+        omega_pows_[i] = w;
+        w = (w * omega) % mod_;
+    }
+
+    invs_[1] = 1;
+    for (ll i = 2; i <= max_n; i++) {
+        invs_[i] = (mod_ - (mod_ / i) * invs_[mod_ % i] % mod_) % mod_;
+    }
+}
+
+/*
+ * 多項式の積を計算して返す．
+ *
+ * @param[in] a 多項式
+ * @param[in] b 多項式
+ * @return std::vector<ll> a と b の積
+ */
+std::vector<ll> PolynomialRing::Mult(const std::vector<ll>& a, const std::vector<ll>& b) const {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+
+    ll len = a.size() + b.size() - 1;
+    if (static_cast<ll>(std::min(a.size(), b.size())) <= kNaiveLength) {
+        std::vector<ll> c(len, 0);
+        for (size_t i = 0; i < a.size(); i++) {
+            for (size_t j = 0; j < b.size(); j++) {
+                c[i + j] = (c[i + j] + a[i] * b[j]) % mod_;
+            }
+        }
+        return c;
+    }
+
+    ll m = CeilPow2(len);
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    ll *fa = arena.Allocate<ll>(m);
+    std::copy(a.begin(), a.end(), fa);
+    std::fill(fa + a.size(), fa + m, 0);
+    Dft(fa, m);
+    if (&a == &b) {
+        engine_.MultVec(fa, fa, fa, m);
+    } else {
+        ll *fb = arena.Allocate<ll>(m);
+        std::copy(b.begin(), b.end(), fb);
+        std::fill(fb + b.size(), fb + m, 0);
+        Dft(fb, m);
+        engine_.MultVec(fa, fb, fa, m);
+    }
+    Idft(fa, m);
+    return std::vector<ll>(fa, fa + len);
+}
+
+/*
+ * 冪級数の逆元 a^-1 mod x^n を計算して返す．
+ *
+ * g = a^-1 mod x^m から長さ 2m の変換で g - g (a g - 1) を求める．
+ * a g mod (x^2m - 1) の下位 m 項は 1, 0, ..., 0 と分かっているため捨て，
+ * 上位 m 項と g の積の下位 m 項を新たな上位 m 項とする．g の変換は 2 つの積で共有する．
+ *
+ * @param[in] a 冪級数
+ * @param[in] n 求める項数
+ * @return std::vector<ll> a^-1 mod x^n
+ */
+std::vector<ll> PolynomialRing::Inv(const std::vector<ll>& a, ll n) const {
+    if (a.empty() || a[0] == 0) {
+        throw std::invalid_argument("a[0] must be nonzero");
+    }
+    if (n <= 0) {
+        return {};
+    }
+
+    // 反復ごとの作業領域は最後の反復の長さで一度だけ切り出す
+    ll max_len = CeilPow2(n);
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    ll *f = arena.Allocate<ll>(max_len);
+    ll *spectrum = arena.Allocate<ll>(max_len);
+
+    std::vector<ll> g { Utility::InvMod(a[0], mod_) };
+    g.reserve(max_len);
+    for (ll m = 1; m < n; m <<= 1) {
+        ll len = 2 * m;
+        ll copied = std::min<ll>(len, a.size());
+        std::copy(a.begin(), a.begin() + copied, f);
+        std::fill(f + copied, f + len, 0);
+        std::copy(g.begin(), g.end(), spectrum);
+        std::fill(spectrum + m, spectrum + len, 0);
+        Dft(f, len);
+        Dft(spectrum, len);
+
+        engine_.MultVec(f, spectrum, f, len);
+        Idft(f, len);
+        std::fill(f, f + m, 0);
+        Dft(f, len);
+        engine_.MultVec(f, spectrum, f, len);
+        Idft(f, len);
+
+        g.resize(len);
+        for (ll i = m; i < len; i++) {
+            g[i] = (mod_ - f[i]) % mod_;
+        }
+    }
+    g.resize(n);
+    return g;
+}
+
+/*
+ * 多項式の除算 a = b q + r (deg r < deg b) を行う．
+ *
+ * @param[in] a 被除数
+ * @param[in] b 除数
+ * @param[out] q 商
+ * @param[out] r 余り
+ */
+void PolynomialRing::DivMod(const std::vector<ll>& a, const std::vector<ll>& b,
+                            std::vector<ll> *q, std::vector<ll> *r) const {
+    std::vector<ll> divisor(b);
+    Trim(divisor);
+    if (divisor.empty()) {
+        throw std::invalid_argument("divisor must be nonzero");
+    }
+    std::vector<ll> dividend(a);
+    Trim(dividend);
+
+    std::vector<ll> quotient = Quotient(dividend, divisor);
+    if (r != nullptr) {
+        *r = Remainder(dividend, divisor, quotient);
+        Trim(*r);
+    }
+    if (q != nullptr) {
+        Trim(quotient);
+        *q = std::move(quotient);
+    }
+}
+
+/*
+ * 冪級数の対数 log a = ∫ a' a^-1 mod x^n を計算して返す．
+ *
+ * @param[in] a 冪級数
+ * @param[in] n 求める項数
+ * @return std::vector<ll> log a mod x^n
+ */
+std::vector<ll> PolynomialRing::Log(const std::vector<ll>& a, ll n) const {
+    if (a.empty() || a[0] != 1) {
+        throw std::invalid_argument("a[0] must be 1");
+    }
+    if (n <= 1) {
+        return std::vector<ll>(std::max<ll>(n, 0), 0);
+    }
+
+    std::vector<ll> derivative(n - 1, 0);
+    for (ll i = 1; i < std::min<ll>(n, a.size()); i++) {
+        derivative[i - 1] = a[i] * i % mod_;
+    }
+    std::vector<ll> quotient = Mult(derivative, Inv(a, n - 1));
+
+    std::vector<ll> result(n, 0);
+    for (ll i = 1; i < n; i++) {
+        result[i] = quotient[i - 1] * invs_[i] % mod_;
+    }
+    return result;
+}
+
+/*
+ * 冪級数の指数 exp a mod x^n を計算して返す．
+ *
+ * b = exp a mod x^m と c = b^-1 mod x^(m/2) から，1 回の反復で
+ * c を mod x^m に，b を mod x^2m に更新する．
+ * b の長さ 2m の変換の偶数番目は長さ m の変換と一致するため，c の更新と
+ * b a' の計算はそれを使い，c の長さ m の変換は前の反復の長さ 2m の変換を使う．
+ * 反復ごとの変換は長さ 2m が 6 回，長さ m が 5 回となる．
+ *
+ * @param[in] a 冪級数
+ * @param[in] n 求める項数
+ * @return std::vector<ll> exp a mod x^n
+ */
+std::vector<ll> PolynomialRing::Exp(const std::vector<ll>& a, ll n) const {
+    if (!a.empty() && a[0] != 0) {
+        throw std::invalid_argument("a[0] must be 0");
+    }
+    if (n <= 0) {
+        return {};
+    }
+
+    // 反復ごとの作業領域は最後の反復の長さで一度だけ切り出す
+    ll max_len = std::max<ll>(CeilPow2(n), 2);
+    Arena& arena = Arena::ThreadLocal();
+    ArenaScope scope(arena);
+    ll *y = arena.Allocate<ll>(max_len);
+    ll *y_half = arena.Allocate<ll>(max_len);
+    ll *z = arena.Allocate<ll>(max_len);
+    ll *c_spectrum = arena.Allocate<ll>(max_len);
+    ll *x = arena.Allocate<ll>(max_len);
+    ll *t = arena.Allocate<ll>(max_len);
+
+    std::vector<ll> b { 1, (a.size() > 1) ? a[1] : 0 };
+    std::vector<ll> c { 1 };
+    b.reserve(max_len);
+    c.reserve(max_len);
+    c_spectrum[0] = 1;
+    c_spectrum[1] = 1;
+    for (ll m = 2; m < n; m <<= 1) {
+        ll len = 2 * m;
+        std::copy(b.begin(), b.end(), y);
+        std::fill(y + m, y + len, 0);
+        Dft(y, len);
+        for (ll i = 0; i < m; i++) {
+            y_half[i] = y[2 * i];
+        }
+
+        // c <- c - c (b c - 1) mod x^m (長さ m の巡回畳み込み)
+        engine_.MultVec(y_half, c_spectrum, z, m);
+        Idft(z, m);
+        std::fill(z, z + m / 2, 0);
+        Dft(z, m);
+        engine_.MultVec(z, c_spectrum, z, m);
+        Idft(z, m);
+        for (ll i = m / 2; i < m; i++) {
+            c.push_back((mod_ - z[i]) % mod_);
+        }
+        std::copy(c.begin(), c.end(), c_spectrum);
+        std::fill(c_spectrum + m, c_spectrum + len, 0);
+        Dft(c_spectrum, len);
+
+        // r = b a' - b' は mod x^(m-1) で 0 となり，巡回畳み込みで下位に回り込んだ
+        // 上位の項を x^m 倍の位置に戻す
+        std::fill(x, x + len, 0);
+        for (ll i = 0; i + 1 < std::min<ll>(m, a.size()); i++) {
+            x[i] = a[i + 1] * (i + 1) % mod_;
+        }
+        Dft(x, m);
+        engine_.MultVec(x, y_half, x, m);
+        Idft(x, m);
+        for (ll i = 0; i + 1 < m; i++) {
+            x[i] = (x[i] + mod_ - b[i + 1] * (i + 1) % mod_) % mod_;
+        }
+        for (ll i = 0; i + 1 < m; i++) {
+            x[m + i] = x[i];
+            x[i] = 0;
+        }
+
+        // ∫ r c + a - ∫ a' = a - log b (下位 m 項は 0)
+        Dft(x, len);
+        engine_.MultVec(x, c_spectrum, x, len);
+        Idft(x, len);
+        std::fill(t, t + m, 0);
+        for (ll i = m; i < len; i++) {
+            t[i] = x[i - 1] * invs_[i] % mod_;
+            if (i < static_cast<ll>(a.size())) {
+                t[i] = (t[i] + a[i]) % mod_;
+            }
+        }
+
+        // b <- b + b (a - log b) mod x^2m
+        Dft(t, len);
+        engine_.MultVec(t, y, t, len);
+        Idft(t, len);
+        b.insert(b.end(), t + m, t + len);
+    }
+    b.resize(n);
+    return b;
+}
+
+/*
+ * 多項式の各点での値を計算して返す．
+ *
+ * @param[in] a 多項式
+ * @param[in] xs 点
+ * @return std::vector<ll> 各点での a の値
+ */
+std::vector<ll> PolynomialRing::Evaluate(const std::vector<ll>& a,
+                                         const std::vector<ll>& xs) const {
+    if (xs.empty()) {
+        return {};
+    }
+
+    SubproductTree tree = BuildTree(xs);
+    std::vector<ll> values(xs.size());
+    EvaluateNode(tree, 1, 0, tree.leaves, a, values);
+    return values;
+}
+
+/*
+ * 各点で指定した値をとる次数 xs.size() 未満の多項式を返す．
+ *
+ * M = Π (x - x_i) とすると，補間多項式は Σ y_i / M'(x_i) Π_(j != i) (x - x_j) である．
+ * M'(x_i) は同じ積木による多点評価で求める．
+ *
+ * @param[in] xs 互いに異なる点
+ * @param[in] ys 各点での値
+ * @return std::vector<ll> 補間多項式
+ */
+std::vector<ll> PolynomialRing::Interpolate(const std::vector<ll>& xs,
+                                            const std::vector<ll>& ys) const {
+    if (xs.size() != ys.size()) {
+        throw std::invalid_argument("xs and ys must have the same length");
+    }
+    if (xs.empty()) {
+        return {};
+    }
+
+    SubproductTree tree = BuildTree(xs);
+    const std::vector<ll>& root = tree.polys[1];
+    std::vector<ll> derivative(root.size() - 1);
+    for (size_t i = 1; i < root.size(); i++) {
+        derivative[i - 1] = root[i] * static_cast<ll>(i) % mod_;
+    }
+
+    std::vector<ll> weights(xs.size());
+    EvaluateNode(tree, 1, 0, tree.leaves, derivative, weights);
+    for (size_t i = 0; i < xs.size(); i++) {
+        if (weights[i] == 0) {
+            throw std::invalid_argument("xs must be distinct");
+        }
+        weights[i] = ys[i] * Utility::InvMod(weights[i], mod_) % mod_;
+    }
+    return InterpolateNode(tree, 1, 0, tree.leaves, weights);
+}
+
+/*
+ * 2 のべき乗の長さの数列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void PolynomialRing::Dft(std::vector<ll>& a) const {
+    Dft(a.data(), a.size());
+}
+
+/*
+ * 長さ m (2 のべき乗) の配列の離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 配列．変換後の配列を上書きして返す．
+ * @param[in] m 長さ
+ */
+void PolynomialRing::Dft(ll *a, ll m) const {
+    if (m > engine_.N()) {
+        throw std::length_error("transform length exceeds MaxN()");
+    }
+    if (m > 1) {
+        engine_.DftSized(a, Utility::Log2(m));
+    }
+}
+
+/*
+ * 2 のべき乗の長さの数列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 数列．変換後の数列を上書きして返す．
+ */
+void PolynomialRing::Idft(std::vector<ll>& a) const {
+    Idft(a.data(), a.size());
+}
+
+/*
+ * 長さ m (2 のべき乗) の配列の逆離散フーリエ変換を計算して返す．
+ *
+ * @param[in,out] a 配列．変換後の配列を上書きして返す．
+ * @param[in] m 長さ
+ */
+void PolynomialRing::Idft(ll *a, ll m) const {
+    if (m > engine_.N()) {
+        throw std::length_error("transform length exceeds MaxN()");
+    }
+    if (m > 1) {
+        engine_.IdftSized(a, Utility::Log2(m));
+    }
+}
+
+/*
+ * 次数 s 以下の多項式 P の長さ 2s の変換を，P mod (x^s - 1) の長さ s の変換から求めて返す．
+ *
+ * P(ω_2s^(2k+1)) = Σ_(j<s) p_j ω_2s^j ω_s^(jk) + p_s ω_2s^s であり，ω_2s^s = -1 となる．
+ *
+ * @param[in] spectrum P mod (x^s - 1) の長さ s の変換
+ * @param[in] p P の係数
+ * @return std::vector<ll> P の長さ 2s の変換
+ */
+std::vector<ll> PolynomialRing::DoubleSpectrum(const std::vector<ll>& spectrum,
+                                               const std::vector<ll>& p) const {
+    ll s = spectrum.size();
+    if (2 * s > engine_.N()) {
+        throw std::length_error("transform length exceeds MaxN()");
+    }
+
+    ll stride = engine_.N() / (2 * s);
+    std::vector<ll> odd(s, 0);
+    for (ll j = 0; j < std::min<ll>(s, p.size()); j++) {
+        odd[j] = p[j] * omega_pows_[j * stride] % mod_;
+    }
+    Dft(odd);
+
+    ll top = (static_cast<ll>(p.size()) > s) ? p[s] : 0;
+    std::vector<ll> result(2 * s);
+    for (ll k = 0; k < s; k++) {
+        result[2 * k] = spectrum[k];
+        result[2 * k + 1] = (odd[k] + mod_ - top) % mod_;
+    }
+    return result;
+}
+
+/*
+ * 多項式 a を b で割った商を返す．
+ *
+ * rev(q) = rev(a) rev(b)^-1 mod x^(deg a - deg b + 1) を用いる．
+ *
+ * @param[in] a 被除数
+ * @param[in] b 除数
+ * @return std::vector<ll> 商
+ */
+std::vector<ll> PolynomialRing::Quotient(const std::vector<ll>& a,
+                                         const std::vector<ll>& b) const {
+    ll len_a = a.size();
+    ll len_b = b.size();
+    if (len_a < len_b) {
+        return {};
+    }
+
+    ll k = len_a - len_b + 1;
+    if (k <= kNaiveLength || len_b <= kNaiveLength) {
+        std::vector<ll> rest(a);
+        std::vector<ll> q(k);
+        ll lead_inv = Utility::InvMod(b.back(), mod_);
+        for (ll i = k - 1; i >= 0; i--) {
+            ll c = rest[i + len_b - 1] * lead_inv % mod_;
+            q[i] = c;
+            if (c == 0) {
+                continue;
+            }
+            for (ll j = 0; j < len_b; j++) {
+                rest[i + j] = (rest[i + j] + mod_ - c * b[j] % mod_) % mod_;
+            }
+        }
+        return q;
+    }
+
+    std::vector<ll> reversed_a(a.rbegin(), a.rbegin() + k);
+    std::vector<ll> reversed_b(b.rbegin(), b.rbegin() + std::min(len_b, k));
+    std::vector<ll> q = Mult(reversed_a, Inv(reversed_b, k));
+    q.resize(k);
+    std::reverse(q.begin(), q.end());
+    return q;
+}
+
+/*
+ * 商 q から余り a - b q を求めて返す．
+ *
+ * @param[in] a 被除数
+ * @param[in] b 除数
+ * @param[in] q a を b で割った商
+ * @return std::vector<ll> 余り
+ */
+std::vector<ll> PolynomialRing::Remainder(const std::vector<ll>& a, const std::vector<ll>& b,
+                                          const std::vector<ll>& q) const {
+    if (q.empty()) {
+        return a;
+    }
+
+    ll d = b.size() - 1;
+    std::vector<ll> r(d, 0);
+    if (d == 0) {
+        return r;
+    }
+
+    if (static_cast<ll>(std::min(q.size(), b.size())) <= kNaiveLength) {
+        for (ll i = 0; i < d; i++) {
+            ll s = 0;
+            for (ll j = std::max<ll>(0, i - static_cast<ll>(q.size()) + 1); j <= i; j++) {
+                s = (s + b[j] * q[i - j]) % mod_;
+            }
+            r[i] = (((i < static_cast<ll>(a.size())) ? a[i] : 0) + mod_ - s) % mod_;
+        }
+        return r;
+    }
+
+    // a - b q の次数は d 未満であり，mod (x^m - 1) (m >= d) でも変わらない
+    ll m = CeilPow2(d);
+    std::vector<ll> fa(m, 0);
+    std::vector<ll> fb(m, 0);
+    std::vector<ll> fq(m, 0);
+    for (size_t i = 0; i < a.size(); i++) {
+        fa[i & (m - 1)] = (fa[i & (m - 1)] + a[i]) % mod_;
+    }
+    for (size_t i = 0; i < b.size(); i++) {
+        fb[i & (m - 1)] = (fb[i & (m - 1)] + b[i]) % mod_;
+    }
+    for (size_t i = 0; i < q.size(); i++) {
+        fq[i & (m - 1)] = (fq[i & (m - 1)] + q[i]) % mod_;
+    }
+    Dft(fb);
+    Dft(fq);
+    engine_.MultVec(fb.data(), fq.data(), fb.data(), m);
+    Idft(fb);
+    for (ll i = 0; i < d; i++) {
+        r[i] = (fa[i] + mod_ - fb[i]) % mod_;
+    }
+    return r;
+}
+
+/*
+ * 点の積木を作成して返す．
+ *
+ * @param[in] xs 点
+ * @return SubproductTree 積木
+ */
+PolynomialRing::SubproductTree PolynomialRing::BuildTree(const std::vector<ll>& xs) const {
+    SubproductTree tree;
+    tree.points = xs;
+    tree.leaves = CeilPow2(xs.size());
+    tree.polys.resize(2 * tree.leaves);
+    tree.spectra.resize(2 * tree.leaves);
+    BuildNode(tree, 1, 0, tree.leaves);
+    return tree;
+}
+
+/*
+ * 積木の節点の積を子の積から求める．
+ *
+ * 区間が点で埋まった節点の積 P は x^len を最高次とするため，
+ * 子の長さ len の変換の積から P mod (x^len - 1) を求め，定数項を補正する．
+ *
+ * @param[in,out] tree 積木
+ * @param[in] node 節点の番号
+ * @param[in] l 区間の左端
+ * @param[in] len 区間の長さ
+ */
+void PolynomialRing::BuildNode(SubproductTree& tree, ll node, ll l, ll len) const {
+    ll k = tree.points.size();
+    if (l >= k) {
+        return;
+    }
+    if (len == 1) {
+        tree.polys[node] = { (mod_ - tree.points[l]) % mod_, 1 };
+        return;
+    }
+
+    ll half = len / 2;
+    BuildNode(tree, 2 * node, l, half);
+    BuildNode(tree, 2 * node + 1, l + half, half);
+    const std::vector<ll>& left = tree.polys[2 * node];
+    const std::vector<ll>& right = tree.polys[2 * node + 1];
+    if (right.empty()) {
+        tree.polys[node] = left;
+        return;
+    }
+    if (l + len > k || len <= kNaiveLength) {
+        tree.polys[node] = Mult(left, right);
+        return;
+    }
+
+    std::vector<ll> spectrum = NodeSpectrum(tree, 2 * node, half);
+    std::vector<ll> right_spectrum = NodeSpectrum(tree, 2 * node + 1, half);
+    engine_.MultVec(spectrum.data(), right_spectrum.data(), spectrum.data(), len);
+    std::vector<ll> p(spectrum);
+    Idft(p);
+    p[0] = (p[0] + mod_ - 1) % mod_;
+    p.push_back(1);
+    tree.polys[node] = std::move(p);
+    tree.spectra[node] = std::move(spectrum);
+}
+
+/*
+ * 区間が点で埋まった節点の積の長さ 2 len の変換を返す．
+ *
+ * @param[in] tree 積木
+ * @param[in] node 節点の番号
+ * @param[in] len 区間の長さ
+ * @return std::vector<ll> 節点の積の長さ 2 len の変換
+ */
+std::vector<ll> PolynomialRing::NodeSpectrum(const SubproductTree& tree, ll node, ll len) const {
+    const std::vector<ll>& p = tree.polys[node];
+    if (!tree.spectra[node].empty()) {
+        return DoubleSpectrum(tree.spectra[node], p);
+    }
+
+    std::vector<ll> spectrum(p);
+    spectrum.resize(2 * len, 0);
+    Dft(spectrum);
+    return spectrum;
+}
+
+/*
+ * 余りを積木に沿って下ろし，節点の区間の点での値を求める．
+ *
+ * 点が kNaiveLength 個以下になった節点では余りを Horner 法で評価する．
+ *
+ * @param[in] tree 積木
+ * @param[in] node 節点の番号
+ * @param[in] l 区間の左端
+ * @param[in] len 区間の長さ
+ * @param[in] a 多項式
+ * @param[out] values 各点での値
+ */
+void PolynomialRing::EvaluateNode(const SubproductTree& tree, ll node, ll l, ll len,
+                                  const std::vector<ll>& a, std::vector<ll>& values) const {
+    const std::vector<ll>& p = tree.polys[node];
+    if (p.empty()) {
+        return;
+    }
+    std::vector<ll> r = (a.size() >= p.size()) ? Remainder(a, p, Quotient(a, p)) : a;
+
+    ll end = std::min<ll>(l + len, tree.points.size());
+    if (end - l <= kNaiveLength) {
+        for (ll i = l; i < end; i++) {
+            ll x = tree.points[i];
+            ll v = 0;
+            for (ll j = static_cast<ll>(r.size()) - 1; j >= 0; j--) {
+                v = (v * x + r[j]) % mod_;
+            }
+            values[i] = v;
+        }
+        return;
+    }
+
+    EvaluateNode(tree, 2 * node, l, len / 2, r, values);
+    EvaluateNode(tree, 2 * node + 1, l + len / 2, len / 2, r, values);
+}
+
+/*
+ * 節点の区間の点について Σ w_i Π_(j != i) (x - x_j) を求めて返す．
+ *
+ * 左右の子の和 L, R と積 P_L, P_R から L P_R + R P_L を求める．
+ * 区間が点で埋まった節点では，P_L, P_R の長さ len の変換を積木から倍加して求める．
+ *
+ * @param[in] tree 積木
+ * @param[in] node 節点の番号
+ * @param[in] l 区間の左端
+ * @param[in] len 区間の長さ
+ * @param[in] weights 各点の重み
+ * @return std::vector<ll> 節点の区間の点についての和
+ */
+std::vector<ll> PolynomialRing::InterpolateNode(const SubproductTree& tree, ll node, ll l, ll len,
+                                                const std::vector<ll>& weights) const {
+    if (len == 1) {
+        return { weights[l] };
+    }
+
+    ll k = tree.points.size();
+    ll half = len / 2;
+    if (l + half >= k) {
+        return InterpolateNode(tree, 2 * node, l, half, weights);
+    }
+
+    std::vector<ll> left = InterpolateNode(tree, 2 * node, l, half, weights);
+    std::vector<ll> right = InterpolateNode(tree, 2 * node + 1, l + half, half, weights);
+    if (l + len > k || len <= kNaiveLength) {
+        std::vector<ll> c = Mult(left, tree.polys[2 * node + 1]);
+        std::vector<ll> d = Mult(right, tree.polys[2 * node]);
+        for (size_t i = 0; i < c.size(); i++) {
+            c[i] = (c[i] + d[i]) % mod_;
+        }
+        return c;
+    }
+
+    std::vector<ll> left_spectrum = NodeSpectrum(tree, 2 * node, half);
+    std::vector<ll> right_spectrum = NodeSpectrum(tree, 2 * node + 1, half);
+    left.resize(len, 0);
+    right.resize(len, 0);
+    Dft(left);
+    Dft(right);
+    for (ll i = 0; i < len; i++) {
+        left[i] = (left[i] * right_spectrum[i] + right[i] * left_spectrum[i]) % mod_;
+    }
+    Idft(left);
+    return left;
+}
+
+} // namespace ntt
@@ -0,0 +1,223 @@
+/**
+ * @file stream_convolver.cpp
+ * @brief 長い数列を区切って固定のカーネルと畳み込むクラスを実装するソースファイル．
+ */
+
+#include "include/stream_convolver.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/*
+ * カーネルの長さが扱えるかを確認し，その長さを返す．
+ *
+ * @param[in] len_kernel カーネルの長さ
+ * @param[in] n 畳み込みの次数
+ * @return ll カーネルの長さ
+ * @throw std::invalid_argument len_kernel が 1 以上 n 以下でない場合
+ */
+ll CheckKernel(ll len_kernel, ll n) {
+    if (len_kernel < 1 || len_kernel > n) {
+        throw std::invalid_argument("len_kernel must be in [1, N()]");
+    }
+    return len_kernel;
+}
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] ntt 畳み込みに用いる Number theoretic transform．
+ * @param[in] kernel カーネル．
+ * @param[in] len_kernel カーネルの長さ．
+ * @param[in] method 出力をつなぐ方法．
+ */
+StreamConvolver::StreamConvolver(const Ntt& ntt, const ll *kernel, ll len_kernel,
+                                 Method method) :
+        ntt_(ntt),
+        method_(method),
+        len_kernel_(CheckKernel(len_kernel, ntt.N())),
+        block_(ntt.N() - len_kernel + 1),
+        current_(0),
+        in_flight_(false),
+        input_(block_, 0),
+        input_len_(0),
+        overlap_(len_kernel - 1, 0),
+        consumed_(0),
+        submitted_(0),
+        emitted_(0),
+        pool_(nullptr) {
+    AlignedVector<ll> padded(ntt_.N(), 0);
+    std::copy(kernel, kernel + len_kernel_, padded.begin());
+    ntt_.Prepare(padded.data(), &kernel_spectrum_);
+    slots_[0].resize(ntt_.N());
+    slots_[1].resize(ntt_.N());
+}
+
+/*
+ * 入力を追加し，確定した出力を out の末尾に追加する．
+ *
+ * @param[in] x 入力．
+ * @param[in] len 入力の長さ．
+ * @param[out] out 出力を追加する数列．
+ * @return ll 追加した出力の数
+ */
+ll StreamConvolver::Push(const ll *x, ll len, std::vector<ll> *out) {
+    ll before = emitted_;
+    while (len > 0) {
+        ll take = std::min(block_ - input_len_, len);
+        std::copy(x, x + take, input_.begin() + input_len_);
+        input_len_ += take;
+        consumed_ += take;
+        x += take;
+        len -= take;
+        if (input_len_ == block_) {
+            Submit(out);
+        }
+    }
+    return emitted_ - before;
+}
+
+/*
+ * 入力の終わりを通知し，残りの出力を out の末尾に追加する．
+ *
+ * 残りの入力と 0 のブロックを出力が入力の長さ + K - 1 個に達するまで変換し，
+ * 最後のブロックの余分な出力を取り除く．
+ *
+ * @param[out] out 出力を追加する数列．
+ * @return ll 追加した出力の数
+ */
+ll StreamConvolver::Flush(std::vector<ll> *out) {
+    ll before = emitted_;
+    if (consumed_ > 0) {
+        ll total = consumed_ + len_kernel_ - 1;
+        while (submitted_ * block_ < total) {
+            std::fill(input_.begin() + input_len_, input_.end(), 0);
+            Submit(out);
+        }
+        Drain(out);
+
+        ll excess = emitted_ - total;
+        out->resize(out->size() - excess);
+        emitted_ -= excess;
+    }
+
+    ll written = emitted_ - before;
+    Reset();
+    return written;
+}
+
+/*
+ * 出力していない入力と途中の結果を捨て，新しい入力列を受け付ける．
+ */
+void StreamConvolver::Reset() {
+    current_ = 0;
+    in_flight_ = false;
+    input_len_ = 0;
+    std::fill(overlap_.begin(), overlap_.end(), 0);
+    consumed_ = 0;
+    submitted_ = 0;
+    emitted_ = 0;
+}
+
+/*
+ * たまった入力をブロックとして変換し，変換済みのブロックがあれば並行に出力する．
+ *
+ * 2 つのタスクは別の作業領域を使い，Load は入力と (overlap-save の) 直前の入力のみを，
+ * Emit は (overlap-add の) 次のブロックに加える値と出力のみを更新する．
+ *
+ * @param[out] out 出力を追加する数列．
+ */
+void StreamConvolver::Submit(std::vector<ll> *out) {
+    int next = in_flight_ ? 1 - current_ : current_;
+    ll *fresh = slots_[next].data();
+    if (in_flight_) {
+        ll *ready = slots_[current_].data();
+        auto task = [&](ll i) {
+            if (i == 0) {
+                Load(fresh);
+            } else {
+                Emit(ready, out);
+            }
+        };
+
+        if (pool_ == nullptr) {
+            task(0);
+            task(1);
+        } else {
+            pool_->Run(2, task);
+        }
+    } else {
+        Load(fresh);
+    }
+
+    current_ = next;
+    in_flight_ = true;
+    input_len_ = 0;
+    submitted_++;
+}
+
+/*
+ * 変換済みのブロックがあれば畳み込みを完了して出力する．
+ *
+ * @param[out] out 出力を追加する数列．
+ */
+void StreamConvolver::Drain(std::vector<ll> *out) {
+    if (in_flight_) {
+        Emit(slots_[current_].data(), out);
+        in_flight_ = false;
+    }
+}
+
+/*
+ * たまった入力を作業領域に並べて変換する．
+ *
+ * @param[out] slot 作業領域
+ */
+void StreamConvolver::Load(ll *slot) {
+    ll n = ntt_.N();
+    if (method_ == Method::kOverlapAdd) {
+        std::copy(input_.begin(), input_.end(), slot);
+        std::fill(slot + block_, slot + n, 0);
+    } else {
+        std::copy(overlap_.begin(), overlap_.end(), slot);
+        std::copy(input_.begin(), input_.end(), slot + len_kernel_ - 1);
+        std::copy(slot + block_, slot + n, overlap_.begin());
+    }
+    ntt_.TransformInput(slot, slot);
+}
+
+/*
+ * 変換したブロックの畳み込みを完了し，確定した B 個の出力を追加する．
+ *
+ * @param[in,out] slot 変換したブロック
+ * @param[out] out 出力を追加する数列．
+ */
+void StreamConvolver::Emit(ll *slot, std::vector<ll> *out) {
+    ll n = ntt_.N();
+    ll mod = ntt_.Mod();
+    ntt_.MultTransformed(kernel_spectrum_, slot);
+
+    if (method_ == Method::kOverlapAdd) {
+        for (ll i = 0; i < len_kernel_ - 1; i++) {
+            slot[i] += overlap_[i];
+            if (slot[i] >= mod) {
+                slot[i] -= mod;
+            }
+        }
+        out->insert(out->end(), slot, slot + block_);
+        std::copy(slot + block_, slot + n, overlap_.begin());
+    } else {
+        out->insert(out->end(), slot + len_kernel_ - 1, slot + n);
+    }
+    emitted_ += block_;
+}
+
+} // namespace ntt
@@ -0,0 +1,123 @@
+/**
+ * @file thread_pool.cpp
+ * @brief スレッドプールを定義するソースファイル．
+ */
+
+#include "include/thread_pool.hpp"
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+namespace {
+
+/* タスクを実行中のスレッドであれば true */
+thread_local bool in_task = false;
+
+} // namespace
+
+/*
+ * コンストラクタ．
+ *
+ * @param[in] num_threads スレッド数 (呼び出し元を含む)．0 以下の場合はハードウェアの並列数．
+ */
+ThreadPool::ThreadPool(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    for (int i = 1; i < num_threads; i++) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+/* デストラクタ． */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    task_cv_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+/*
+ * タスク 0, 1, ..., num_tasks - 1 を並列に実行し，すべての終了を待つ．
+ *
+ * @param[in] num_tasks タスク数
+ * @param[in] task タスク番号を受け取って実行する関数
+ */
+void ThreadPool::Run(ll num_tasks, const std::function<void(ll)>& task) {
+    if (workers_.empty() || num_tasks <= 1 || in_task) {
+        for (ll i = 0; i < num_tasks; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        num_tasks_ = num_tasks;
+        next_task_ = 0;
+        num_busy_ = static_cast<int>(workers_.size());
+        generation_++;
+    }
+    task_cv_.notify_all();
+
+    in_task = true;
+    Work();
+    in_task = false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return num_busy_ == 0; });
+    task_ = nullptr;
+}
+
+/*
+ * ワーカースレッドの処理．
+ */
+void ThreadPool::WorkerLoop() {
+    in_task = true;
+    ll generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_cv_.wait(lock, [this, generation] {
+                return stop_ || generation_ != generation;
+            });
+            if (stop_) {
+                return;
+            }
+            generation = generation_;
+        }
+
+        Work();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            num_busy_--;
+            if (num_busy_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+/*
+ * 実行中のタスクを取り出して実行する．
+ */
+void ThreadPool::Work() {
+    ll i;
+    while ((i = next_task_.fetch_add(1)) < num_tasks_) {
+        (*task_)(i);
+    }
+}
+
+} // namespace ntt
@@ -4,6 +4,7 @@
  */
 
 #include "include/util.hpp"
+#include <vector>
 
 /*
  * Number theoretic transform 向け名前空間
@@ -18,6 +19,10 @@ namespace ntt {
  * @return ll 逆数
  */
 ll Utility::InvMod(ll x, ll n) {
+    if (x % n == 1) {
+        return 1;
+    }
+
     ll a = n;
     ll b = x;
     ll b_pre = 0;
@@ -29,7 +34,7 @@ ll Utility::InvMod(ll x, ll n) {
     ll tmp = b_current;
 
     ll qn = (q / n) + 1;
-    b_current = (b_pre + (((qn * n - q)*b_current) % n)) % n;
+    b_current = (b_pre + MulMod(qn * n - q, b_current, n)) % n;
     b_pre = tmp;
     a = b;
     b = r;
@@ -40,7 +45,7 @@ ll Utility::InvMod(ll x, ll n) {
 
         ll tmp = b_current;
         ll qn = (q / n) + 1;
-        b_current = (b_pre + (((qn * n - q)*b_current) % n)) % n;
+        b_current = (b_pre + MulMod(qn * n - q, b_current, n)) % n;
         b_pre = tmp;
         a = b;
         b = r;
@@ -49,4 +54,147 @@ ll Utility::InvMod(ll x, ll n) {
     return b_current % n;
 }
 
+/*
+ * 積を返す．
+ *
+ * @param[in] x 値
+ * @param[in] y 値
+ * @param[in] n モジュラス
+ * @return ll x と y の積
+ */
+ll Utility::MulMod(ll x, ll y, ll n) {
+    if (n <= (1LL << 31)) {
+        return (x * y) % n;
+    }
+
+    __extension__ typedef unsigned __int128 u128;
+    return static_cast<ll>((static_cast<u128>(x) * static_cast<u128>(y)) % static_cast<u128>(n));
+}
+
+/*
+ * べき乗を返す．
+ *
+ * @param[in] x 基数
+ * @param[in] k 指数
+ * @param[in] n モジュラス
+ * @return ll x の k 乗
+ */
+ll Utility::PowMod(ll x, ll k, ll n) {
+    ll p = x % n;
+    ll v = 1;
+
+    while (k >= 1) {
+        if ((k & 1) == 1) {
+            v = MulMod(v, p, n);
+        }
+        k >>= 1;
+        p = MulMod(p, p, n);
+    }
+
+    return v;
+}
+
+/*
+ * 素数であるかを返す．
+ *
+ * 最初の 12 個の素数を底とすれば 2^64 未満のすべての整数を正しく判定できる．
+ *
+ * @param[in] n 値
+ * @return bool 素数であれば true
+ */
+bool Utility::IsPrime(ll n) {
+    static const ll kBases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+    if (n < 2) {
+        return false;
+    }
+    for (ll p : kBases) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+
+    // n - 1 = d 2^s (d は奇数)
+    ll d = n - 1;
+    ll s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        s++;
+    }
+
+    for (ll a : kBases) {
+        ll x = PowMod(a, d, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool is_composite = true;
+        for (ll r = 1; r < s; r++) {
+            x = MulMod(x, x, n);
+            if (x == n - 1) {
+                is_composite = false;
+                break;
+            }
+        }
+        if (is_composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * 素数 p を法とする原始根のうち最小のものを返す．
+ *
+ * @param[in] p 素数
+ * @return ll 原始根
+ */
+ll Utility::PrimitiveRoot(ll p) {
+    if (p == 2) {
+        return 1;
+    }
+
+    std::vector<ll> factors;
+    ll m = p - 1;
+    for (ll d = 2; d * d <= m; d++) {
+        if (m % d == 0) {
+            factors.push_back(d);
+            while (m % d == 0) {
+                m /= d;
+            }
+        }
+    }
+    if (m > 1) {
+        factors.push_back(m);
+    }
+
+    for (ll g = 2; g < p; g++) {
+        bool is_root = true;
+        for (ll f : factors) {
+            if (PowMod(g, (p - 1) / f, p) == 1) {
+                is_root = false;
+                break;
+            }
+        }
+
+        if (is_root) {
+            return g;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * 値が 2 の何乗以下かを返す．
+ *
+ * @param[in] n 値
+ * @return ll 2^k <= n を満たす最大の k
+ */
+ll Utility::Log2(ll n) {
+    ll k = 0;
+    while ((2LL << k) <= n) {
+        k++;
+    }
+    return k;
+}
+
 } // namespace ntt
@@ -0,0 +1,63 @@
+/**
+ * @file workspace.cpp
+ * @brief 作業領域を定義するソースファイル．
+ */
+
+#include "include/workspace.hpp"
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/*
+ * index 番目の作業領域を返す．
+ *
+ * @param[in] index 作業領域の番号
+ * @param[in] size 必要な要素数
+ * @return ll* size 個以上の要素をもつ作業領域
+ */
+ll *Workspace::Buffer(ll index, ll size) {
+    if (static_cast<ll>(buffers_.size()) <= index) {
+        buffers_.resize(index + 1);
+    }
+
+    AlignedVector<ll>& buffer = buffers_[index];
+    if (static_cast<ll>(buffer.size()) < size) {
+        buffer.resize(size);
+    }
+
+    return buffer.data();
+}
+
+/*
+ * 32 ビットの要素をもつ index 番目の作業領域を返す．
+ *
+ * @param[in] index 作業領域の番号
+ * @param[in] size 必要な要素数
+ * @return u32* size 個以上の要素をもつ作業領域
+ */
+u32 *Workspace::Buffer32(ll index, ll size) {
+    if (static_cast<ll>(buffers32_.size()) <= index) {
+        buffers32_.resize(index + 1);
+    }
+
+    AlignedVector<u32>& buffer = buffers32_[index];
+    if (static_cast<ll>(buffer.size()) < size) {
+        buffer.resize(size);
+    }
+
+    return buffer.data();
+}
+
+/*
+ * スレッドごとの既定の作業領域を返す．
+ *
+ * @return Workspace& 呼び出したスレッドの作業領域
+ */
+Workspace& Workspace::ThreadLocal() {
+    static thread_local Workspace workspace;
+    return workspace;
+}
+
+} // namespace ntt
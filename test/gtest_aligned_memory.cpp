@@ -0,0 +1,121 @@
+/**
+ * @file gtest_aligned_memory.cpp
+ * @brief 境界を揃えたメモリの確保のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/aligned_memory.hpp"
+#include "include/workspace.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * 境界を揃えたメモリの確保のテストクラス．
+ */
+class AlignedMemoryTest : public ::testing::Test {
+protected:
+    /**
+     * 領域の先頭が境界に揃っているかを返す．
+     *
+     * @param [in] p 領域
+     * @param [in] alignment 境界 (バイト数)
+     * @return bool 揃っている場合 true
+     */
+    bool IsAligned(const void *p, size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+};
+
+/*
+ * 確保した領域がキャッシュラインの境界に，大きな領域はヒュージページの境界に揃い，
+ * 全体に読み書きできることを確認する．
+ */
+TEST_F(AlignedMemoryTest, Allocate) {
+    bool huge_pages = AlignedMemory::HugePages();
+    for (bool enabled : { true, false }) {
+        AlignedMemory::SetHugePages(enabled);
+        ASSERT_EQ(enabled, AlignedMemory::HugePages());
+
+        for (size_t bytes : { size_t(0), size_t(1), size_t(100), size_t(4096),
+                              AlignedMemory::kHugePageThreshold - 8,
+                              AlignedMemory::kHugePageThreshold, AlignedMemory::kHugePageSize,
+                              3 * AlignedMemory::kHugePageSize + 8 }) {
+            char *p = static_cast<char *>(AlignedMemory::Allocate(bytes));
+            ASSERT_TRUE(IsAligned(p, AlignedMemory::kAlignment)) << "bytes = " << bytes;
+            if (bytes >= AlignedMemory::kHugePageThreshold) {
+                ASSERT_TRUE(IsAligned(p, AlignedMemory::kHugePageSize)) << "bytes = " << bytes;
+            }
+            for (size_t i = 0; i < bytes; i++) {
+                p[i] = static_cast<char>(i);
+            }
+            if (bytes > 0) {
+                ASSERT_EQ(static_cast<char>(bytes - 1), p[bytes - 1]);
+            }
+            AlignedMemory::Deallocate(p, bytes);
+        }
+    }
+    AlignedMemory::SetHugePages(huge_pages);
+
+    AlignedVector<ll> v(1000, 7);
+    ASSERT_TRUE(IsAligned(v.data(), AlignedMemory::kAlignment));
+    v.resize(5000, 3);
+    ASSERT_TRUE(IsAligned(v.data(), AlignedMemory::kAlignment));
+    ASSERT_EQ(7, v[999]);
+    ASSERT_EQ(3, v[4999]);
+
+    Workspace workspace;
+    ASSERT_TRUE(IsAligned(workspace.Buffer(0, 17), AlignedMemory::kAlignment));
+    ASSERT_TRUE(IsAligned(workspace.Buffer32(1, 17), AlignedMemory::kAlignment));
+}
+
+/*
+ * アリーナから切り出した配列が境界に揃って重ならず，スコープの終わりで返却された
+ * 領域が新たなメモリ確保なしに再利用されることを確認する．
+ */
+TEST_F(AlignedMemoryTest, Arena) {
+    Arena arena;
+    std::vector<ll *> first;
+    size_t capacity = 0;
+
+    for (int repeat = 0; repeat < 3; repeat++) {
+        ArenaScope scope(arena);
+        std::vector<ll *> arrays;
+        for (ll n : { 1LL, 3LL, 1000LL, 300000LL, 1LL << 20 }) {
+            ll *a = arena.Allocate<ll>(n);
+            ASSERT_TRUE(IsAligned(a, AlignedMemory::kAlignment));
+            for (ll i = 0; i < n; i++) {
+                a[i] = n;
+            }
+            arrays.push_back(a);
+        }
+
+        ll k = 0;
+        for (ll n : { 1LL, 3LL, 1000LL, 300000LL, 1LL << 20 }) {
+            ASSERT_EQ(n, arrays[k][0]);
+            ASSERT_EQ(n, arrays[k][n - 1]);
+            k++;
+        }
+
+        if (repeat == 0) {
+            first = arrays;
+            capacity = arena.Capacity();
+        } else {
+            ASSERT_EQ(first, arrays);
+            ASSERT_EQ(capacity, arena.Capacity());
+        }
+    }
+
+    Arena::Mark mark = arena.Position();
+    ll *outer = arena.Allocate<ll>(10);
+    {
+        ArenaScope scope(arena);
+        arena.Allocate<ll>(100);
+    }
+    ASSERT_EQ(outer + 16, arena.Allocate<ll>(10));
+    arena.Release(mark);
+    ASSERT_EQ(outer, arena.Allocate<ll>(10));
+}
+
+} // namespace ntt
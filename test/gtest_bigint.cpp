@@ -0,0 +1,138 @@
+/**
+ * @file gtest_bigint.cpp
+ * @brief 多倍長整数の乗算のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/bigint.hpp"
+#include "test/test_util.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * 多倍長整数の乗算のテストクラス．
+ */
+class BigIntTest : public ::testing::Test {
+protected:
+    /**
+     * 切り替えのリム数を指定して積を計算して返す．
+     *
+     * @param [in] a 整数
+     * @param [in] b 整数
+     * @param [in] karatsuba Karatsuba 法に切り替えるリム数
+     * @param [in] ntt NTT に切り替えるリム数
+     * @return std::vector<u32> a と b の積
+     */
+    std::vector<u32> Mult(const std::vector<u32>& a, const std::vector<u32>& b,
+                          ll karatsuba, ll ntt);
+};
+
+/*
+ * Karatsuba 法と NTT による積が筆算と一致することを確認する．
+ */
+TEST_F(BigIntTest, Mult) {
+    const ll kNever = 1LL << 40;
+    std::vector<std::pair<ll, ll>> sizes { {1, 1}, {3, 70}, {37, 100}, {257, 256},
+                                           {1000, 777}, {3000, 3000} };
+
+    for (const auto& size : sizes) {
+        std::vector<u32> a = RandomLimbs(size.first, 1);
+        std::vector<u32> b = RandomLimbs(size.second, 2);
+        std::vector<u32> expected = Mult(a, b, kNever, kNever);
+
+        ASSERT_EQ(expected, Mult(a, b, 4, kNever));
+        ASSERT_EQ(expected, Mult(a, b, 4, 1));
+        ASSERT_EQ(expected, Mult(a, b, BigIntMultiplier::kDefaultKaratsubaThreshold,
+                                 BigIntMultiplier::kDefaultNttThreshold));
+    }
+
+    // 全ビットが 1 の場合は桁上がりが最上位まで伝播する
+    std::vector<u32> ones(2000, 0xFFFFFFFFu);
+    std::vector<u32> expected = Mult(ones, ones, kNever, kNever);
+    ASSERT_EQ(expected, Mult(ones, ones, 4, kNever));
+    ASSERT_EQ(expected, Mult(ones, ones, 4, 1));
+}
+
+/*
+ * 同じ整数を渡した 2 乗が異なる領域どうしの積と一致することを確認する．
+ */
+TEST_F(BigIntTest, Square) {
+    for (ll len : { 1LL, 100LL, 3000LL }) {
+        std::vector<u32> a = RandomLimbs(len, 3);
+        std::vector<u32> copy = a;
+        std::vector<u32> expected = Mult(a, copy, 1LL << 40, 1LL << 40);
+
+        BigIntMultiplier multiplier;
+        multiplier.SetThresholds(4, 1);
+        std::vector<u32> actual(2 * len);
+        multiplier.Mult(a.data(), len, a.data(), len, actual.data());
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+/*
+ * バイト列で表した整数の積が正しく計算できることを確認する．
+ */
+TEST_F(BigIntTest, MultBytes) {
+    BigIntMultiplier multiplier;
+
+    std::vector<std::uint8_t> a { 0x02, 0x01 };
+    std::vector<std::uint8_t> b { 0x03 };
+    std::vector<std::uint8_t> c(3);
+    multiplier.Mult(a.data(), a.size(), b.data(), b.size(), c.data());
+    ASSERT_EQ((std::vector<std::uint8_t> { 0x06, 0x03, 0x00 }), c);
+
+    std::vector<std::uint8_t> x(5001);
+    std::vector<std::uint8_t> y(4003);
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = static_cast<std::uint8_t>(i * 131 + 7);
+    }
+    for (size_t i = 0; i < y.size(); i++) {
+        y[i] = static_cast<std::uint8_t>(i * 71 + 3);
+    }
+
+    std::vector<std::uint8_t> expected(x.size() + y.size());
+    std::vector<std::uint8_t> actual(x.size() + y.size());
+    multiplier.SetThresholds(1LL << 40, 1LL << 40);
+    multiplier.Mult(x.data(), x.size(), y.data(), y.size(), expected.data());
+    multiplier.SetThresholds(4, 1);
+    multiplier.Mult(x.data(), x.size(), y.data(), y.size(), actual.data());
+    ASSERT_EQ(expected, actual);
+}
+
+/*
+ * 再帰が止まらない閾値を指定すると例外が送出されることを確認する．
+ */
+TEST_F(BigIntTest, InvalidThresholds) {
+    BigIntMultiplier multiplier;
+    ASSERT_THROW(multiplier.SetThresholds(3, 1), std::invalid_argument);
+    ASSERT_THROW(multiplier.SetThresholds(0, 1), std::invalid_argument);
+    ASSERT_THROW(multiplier.SetThresholds(-1, 1), std::invalid_argument);
+    ASSERT_THROW(multiplier.SetThresholds(4, 0), std::invalid_argument);
+    ASSERT_NO_THROW(multiplier.SetThresholds(4, 1));
+}
+
+/*
+ * 切り替えのリム数を指定して積を計算して返す．
+ *
+ * @param [in] a 整数
+ * @param [in] b 整数
+ * @param [in] karatsuba Karatsuba 法に切り替えるリム数
+ * @param [in] ntt NTT に切り替えるリム数
+ * @return std::vector<u32> a と b の積
+ */
+std::vector<u32> BigIntTest::Mult(const std::vector<u32>& a, const std::vector<u32>& b,
+                                  ll karatsuba, ll ntt) {
+    BigIntMultiplier multiplier;
+    multiplier.SetThresholds(karatsuba, ntt);
+
+    std::vector<u32> c(a.size() + b.size());
+    multiplier.Mult(a.data(), a.size(), b.data(), b.size(), c.data());
+    return c;
+}
+
+} // namespace ntt
@@ -0,0 +1,117 @@
+/**
+ * @file gtest_bit_reversal.cpp
+ * @brief ビット反転の並び替えのテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/bit_reversal.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * ビット反転の並び替えのテストクラス．
+ */
+class BitReversalTest : public ::testing::Test {
+protected:
+    /**
+     * 各要素に自身のインデックスをもつ長さ 2^log_m の数列を作成して返す．
+     *
+     * @param [in] log_m 数列の長さが 2 の何乗か
+     * @return std::vector<T> 数列
+     */
+    template <typename T>
+    std::vector<T> MakeSequence(ll log_m);
+
+    /**
+     * i 番目の要素がインデックス i のビットを反転した値であることを確認する．
+     *
+     * @param [in] a 並び替えた数列
+     * @param [in] log_m 数列の長さが 2 の何乗か
+     */
+    template <typename T>
+    void ExpectReversed(const std::vector<T>& a, ll log_m);
+
+    /** 並び替えの方法 */
+    const std::vector<BitReversal::Method> methods_ {
+        BitReversal::Method::kIncremental, BitReversal::Method::kTable,
+        BitReversal::Method::kBlocked, BitReversal::Method::kBlockedSimd
+    };
+};
+
+/*
+ * 全ての方法でテーブルより短い数列を含めて正しく並び替えられることを確認する．
+ */
+TEST_F(BitReversalTest, Reverse) {
+    BitReversal reversal(17);
+
+    for (auto method : methods_) {
+        for (ll log_m = 0; log_m <= 17; log_m++) {
+            std::vector<ll> a = MakeSequence<ll>(log_m);
+            reversal.Reverse(a.data(), log_m, method);
+            ExpectReversed(a, log_m);
+
+            std::vector<u32> b = MakeSequence<u32>(log_m);
+            reversal.Reverse(b.data(), log_m, method);
+            ExpectReversed(b, log_m);
+
+            // 2 回並び替えると元に戻る
+            reversal.Reverse(b.data(), log_m, method);
+            ASSERT_EQ(MakeSequence<u32>(log_m), b);
+        }
+    }
+
+    // テーブルの奇数ビットの場合，インデックスの上位と下位を組み合わせて反転する
+    BitReversal odd(21);
+    for (auto method : methods_) {
+        std::vector<ll> a = MakeSequence<ll>(21);
+        odd.Reverse(a.data(), 21, method);
+        ExpectReversed(a, 21);
+    }
+}
+
+/*
+ * 扱えない長さを指定すると例外が送出されることを確認する．
+ */
+TEST_F(BitReversalTest, InvalidArgument) {
+    ASSERT_THROW(BitReversal(-1), std::invalid_argument);
+
+    BitReversal reversal(4);
+    std::vector<ll> a = MakeSequence<ll>(5);
+    ASSERT_THROW(reversal.Reverse(a.data(), 5), std::invalid_argument);
+}
+
+/*
+ * 各要素に自身のインデックスをもつ長さ 2^log_m の数列を作成して返す．
+ *
+ * @param [in] log_m 数列の長さが 2 の何乗か
+ * @return std::vector<T> 数列
+ */
+template <typename T>
+std::vector<T> BitReversalTest::MakeSequence(ll log_m) {
+    std::vector<T> a(1LL << log_m);
+    for (ll i = 0; i < (1LL << log_m); i++) {
+        a[i] = static_cast<T>(i);
+    }
+    return a;
+}
+
+/*
+ * i 番目の要素がインデックス i のビットを反転した値であることを確認する．
+ *
+ * @param [in] a 並び替えた数列
+ * @param [in] log_m 数列の長さが 2 の何乗か
+ */
+template <typename T>
+void BitReversalTest::ExpectReversed(const std::vector<T>& a, ll log_m) {
+    for (ll i = 0; i < (1LL << log_m); i++) {
+        ll rev = 0;
+        for (ll bit = 0; bit < log_m; bit++) {
+            rev |= ((i >> bit) & 1) << (log_m - 1 - bit);
+        }
+        ASSERT_EQ(static_cast<T>(rev), a[i]) << "log_m = " << log_m << ", i = " << i;
+    }
+}
+
+} // namespace ntt
@@ -5,6 +5,10 @@
 
 #include "gtest/gtest.h"
 #include "include/montgomery.hpp"
+#include "include/montgomery_simd.hpp"
+#include "include/util.hpp"
+#include <stdexcept>
+#include <vector>
 
 namespace ntt {
 
@@ -54,6 +58,81 @@ TEST_F(MontgomeryTest, Pow) {
     ASSERT_EQ(expected, actual);
 }
 
+/*
+ * 64 ビットのモジュラスに対するモンゴメリ乗算が正しく計算でき，扱えないモジュラスでは
+ * 例外が送出されることを確認する．
+ */
+TEST_F(MontgomeryTest, Mult64) {
+    Montgomery64 montgomery(4179340454199820289LL);
+
+    for (ll a : { 0LL, 1LL, 12345678901234567LL, montgomery.N() - 1 }) {
+        for (ll b : { 1LL, 987654321098765432LL, montgomery.N() - 1 }) {
+            ll expected = Utility::MulMod(a, b, montgomery.N());
+            ASSERT_EQ(expected, montgomery.Mult(a, b));
+            ASSERT_EQ(expected, montgomery.MultReduction(montgomery.ToMontgomery(a), b));
+        }
+    }
+
+    ASSERT_EQ(Utility::PowMod(3, 1234567890123LL, montgomery.N()),
+              montgomery.Pow(3, 1234567890123LL));
+    ASSERT_EQ(1, montgomery.Pow(3, montgomery.N() - 1));
+
+    ASSERT_THROW(Montgomery64(0), std::invalid_argument);
+    ASSERT_THROW(Montgomery64(-7), std::invalid_argument);
+    ASSERT_THROW(Montgomery64(998244352), std::invalid_argument);
+    ASSERT_THROW(Montgomery64(1LL << 62 | 1), std::invalid_argument);
+}
+
+/*
+ * SIMD 命令による要素ごとの積とバタフライ演算がスカラー演算と一致し，実行環境で使えない
+ * 命令セットを指定すると例外が送出されることを確認する．
+ */
+TEST_F(MontgomeryTest, Simd) {
+    MontgomeryMod19529729R25 montgomery;
+    MontgomerySimd scalar(montgomery, MontgomerySimd::Isa::kScalar);
+
+    std::vector<MontgomerySimd::Isa> isas { MontgomerySimd::Isa::kScalar };
+    for (MontgomerySimd::Isa isa : { MontgomerySimd::Isa::kAvx2, MontgomerySimd::Isa::kAvx512 }) {
+        if (MontgomerySimd::Supports(isa)) {
+            isas.push_back(isa);
+        } else {
+            ASSERT_THROW(MontgomerySimd(montgomery, isa), std::invalid_argument);
+        }
+    }
+    ASSERT_THROW(MontgomerySimd(montgomery, static_cast<MontgomerySimd::Isa>(3)),
+                 std::invalid_argument);
+
+    ll n = 37;
+    std::vector<ll> a(n);
+    std::vector<ll> b(n);
+    for (ll i = 0; i < n; i++) {
+        a[i] = (i * 7654321 + 1) % montgomery.N();
+        b[i] = (i * 1234567 + montgomery.N() - 1) % montgomery.N();
+    }
+
+    for (MontgomerySimd::Isa isa : isas) {
+        MontgomerySimd simd(montgomery, isa);
+
+        std::vector<ll> expected(n);
+        std::vector<ll> actual(n);
+        for (ll i = 0; i < n; i++) {
+            expected[i] = (a[i] * b[i]) % montgomery.N();
+        }
+        simd.MultVec(a.data(), b.data(), actual.data(), n);
+        ASSERT_EQ(expected, actual);
+
+        scalar.ReductionVec(a.data(), b.data(), expected.data(), n);
+        simd.ReductionVec(a.data(), b.data(), actual.data(), n);
+        ASSERT_EQ(expected, actual);
+
+        std::vector<ll> x_expected(a.begin(), a.begin() + 32);
+        std::vector<ll> x_actual = x_expected;
+        scalar.ButterflyStage(x_expected.data(), 5, 0, 1, 0, 16, b.data());
+        simd.ButterflyStage(x_actual.data(), 5, 0, 1, 0, 16, b.data());
+        ASSERT_EQ(x_expected, x_actual);
+    }
+}
+
 /*
  * べき乗を計算して返す．
  *
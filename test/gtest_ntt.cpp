@@ -0,0 +1,783 @@
+/**
+ * @file gtest_ntt.cpp
+ * @brief Number theoretic transform のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/ntt.hpp"
+#include "include/ntt_static.hpp"
+#include "test/test_util.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * Number theoretic transform のテストクラス．
+ */
+class NttTest : public ::testing::Test {
+protected:
+    /**
+     * 先頭 len 個の要素のみが非零である数列を作成して返す．
+     *
+     * @param [in] n 次数
+     * @param [in] len 非零要素の個数
+     * @param [in] seed 係数を決める値
+     * @param [in] mod モジュラス
+     * @return std::vector<ll> 数列
+     */
+    std::vector<ll> MakeSequence(ll n, ll len, ll seed, ll mod);
+
+    /**
+     * 畳み込みが正しく計算できることを確認する．
+     *
+     * @param [in] ntt NTTオブジェクト
+     * @param [in] len 非零要素の個数
+     */
+    void CheckMult(const Ntt& ntt, ll len);
+
+    /**
+     * 入力の長さを指定した畳み込みが正しく計算できることを確認する．
+     *
+     * @param [in] ntt NTTオブジェクト
+     * @param [in] len_a 数列 a の長さ
+     * @param [in] len_b 数列 b の長さ
+     */
+    void CheckMultTruncated(const Ntt& ntt, ll len_a, ll len_b);
+};
+
+/*
+ * モジュラス 337, 次数 8 の畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultMod337Deg8) {
+    NttMod337Deg8 ntt;
+    CheckMult(ntt, 8);
+}
+
+/*
+ * モジュラス 19529729, 次数 131072 の畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultMod19529729Deg131072) {
+    NttMod19529729Deg131072 ntt;
+    CheckMult(ntt, 64);
+}
+
+/*
+ * モンゴメリ乗算を使った畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultMod19529729Deg131072M) {
+    NttMod19529729Deg131072M ntt;
+    CheckMult(ntt, 64);
+
+    ntt.SetSimdIsa(MontgomerySimd::Isa::kScalar);
+    CheckMult(ntt, 64);
+
+    if (MontgomerySimd::Supports(MontgomerySimd::Isa::kAvx2)) {
+        ntt.SetSimdIsa(MontgomerySimd::Isa::kAvx2);
+        CheckMult(ntt, 64);
+    }
+
+    // 実行環境で使えない命令セットは，演算の前に設定の時点で拒否する
+    if (!MontgomerySimd::Supports(MontgomerySimd::Isa::kAvx512)) {
+        ASSERT_THROW(ntt.SetSimdIsa(MontgomerySimd::Isa::kAvx512), std::invalid_argument);
+    }
+}
+
+/*
+ * モンゴメリ表現のまま 1 回のリダクションで積をとる畳み込みが，命令セットによらず
+ * NttGeneric による畳み込みと一致することを，モジュラスに近い値を含む乱数列で確認する．
+ */
+TEST_F(NttTest, MultMontgomeryPipeline) {
+    NttMod19529729Deg131072M ntt;
+    NttGeneric generic(ntt.Mod(), ntt.N());
+    ll n = ntt.N();
+    ll mod = ntt.Mod();
+
+    std::vector<ll> a = RandomSequence(n, 1, mod);
+    std::vector<ll> b = RandomSequence(n, 2, mod);
+    for (ll i = 0; i < n; i += 5) {
+        a[i] = mod - 1 - (i & 3);
+        b[n - 1 - i] = mod - 1 - (i & 7);
+    }
+
+    std::vector<ll> expected(n);
+    generic.Mult(a.data(), b.data(), expected.data(), nullptr);
+    std::vector<ll> expected_square(n);
+    generic.Square(a.data(), expected_square.data());
+
+    std::vector<MontgomerySimd::Isa> isas { MontgomerySimd::Isa::kScalar };
+    for (MontgomerySimd::Isa isa : { MontgomerySimd::Isa::kAvx2, MontgomerySimd::Isa::kAvx512 }) {
+        if (MontgomerySimd::Supports(isa)) {
+            isas.push_back(isa);
+        }
+    }
+
+    for (MontgomerySimd::Isa isa : isas) {
+        ntt.SetSimdIsa(isa);
+        int id = static_cast<int>(isa);
+
+        std::vector<ll> actual(n);
+        ntt.Mult(a.data(), b.data(), actual.data(), nullptr);
+        ASSERT_EQ(expected, actual) << "isa = " << id;
+
+        ntt.Square(a.data(), actual.data());
+        ASSERT_EQ(expected_square, actual) << "isa = " << id;
+
+        std::vector<u32> a32(a.begin(), a.end());
+        std::vector<u32> b32(b.begin(), b.end());
+        std::vector<u32> actual32(n);
+        ntt.Mult(a32.data(), b32.data(), actual32.data(), nullptr);
+        ASSERT_EQ(std::vector<u32>(expected.begin(), expected.end()), actual32) << "isa = " << id;
+
+        Spectrum spectrum;
+        ntt.Prepare(b.data(), &spectrum);
+        ntt.Mult(spectrum, a.data(), actual.data());
+        ASSERT_EQ(expected, actual) << "isa = " << id;
+
+        std::vector<ll> fa = a;
+        std::vector<ll> fb = b;
+        ntt.Mult(fa.data(), fb.data(), actual.data());
+        ASSERT_EQ(expected, actual) << "isa = " << id;
+    }
+}
+
+/*
+ * コンパイル時にモジュラスと次数を決めた畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultStatic) {
+    NttStaticMod337Deg8 ntt_small;
+    CheckMult(ntt_small, 8);
+
+    NttStatic<998244353, 258648936, 10> ntt_medium;
+    CheckMult(ntt_medium, 1024);
+
+    NttStaticMod19529729Deg131072 ntt_large;
+    CheckMult(ntt_large, 64);
+}
+
+/*
+ * 任意のモジュラスと次数の畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultGeneric) {
+    NttGeneric ntt_small(19529729, 16);
+    CheckMult(ntt_small, 16);
+
+    NttGeneric ntt_large(998244353, 1024);
+    CheckMult(ntt_large, 1024);
+}
+
+/*
+ * 遅延リダクションのバタフライ演算を使った畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultHarvey) {
+    NttHarvey ntt_small(19529729, 16);
+    CheckMult(ntt_small, 16);
+
+    NttHarvey ntt_large(998244353, 1024);
+    CheckMult(ntt_large, 1024);
+
+    NttHarvey ntt_deg131072(19529729, 131072);
+    CheckMult(ntt_deg131072, 64);
+
+    std::vector<ll> a = MakeSequence(ntt_large.N(), 1024, 3, ntt_large.Mod());
+    std::vector<ll> expected = a;
+    NttGeneric(998244353, 1024).Dft(expected.data());
+    ntt_large.Dft(a.data());
+    ASSERT_EQ(expected, a);
+
+    ASSERT_THROW(NttHarvey(2013265921, 16), std::invalid_argument);
+}
+
+/*
+ * 64 ビットのモジュラスに対する畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultMontgomery64) {
+    NttMontgomery64 ntt(4179340454199820289LL, 1024);
+    CheckMult(ntt, 1024);
+    CheckMultTruncated(ntt, 100, 200);
+
+    NttGeneric ntt_small(19529729, 1024);
+    NttMontgomery64 ntt_small64(19529729, 1024);
+    std::vector<ll> a = MakeSequence(1024, 1024, 3, 19529729);
+    std::vector<ll> expected = a;
+    ntt_small.Dft(expected.data());
+    ntt_small64.Dft(a.data());
+    ASSERT_EQ(expected, a);
+    ASSERT_EQ(ntt_small.PowOmega(5), ntt_small64.PowOmega(5));
+    ASSERT_EQ(ntt_small.PowPhi(1000), ntt_small64.PowPhi(1000));
+
+    std::vector<ll> x = MakeSequence(1024, 1024, 4, ntt.Mod());
+    std::vector<ll> y = MakeSequence(1024, 1024, 5, ntt.Mod());
+    Spectrum spectrum;
+    ntt.Prepare(x.data(), &spectrum);
+    std::vector<ll> actual(1024);
+    ntt.Mult(spectrum, y.data(), actual.data());
+    ASSERT_EQ(NaiveCyclicConvolution(x, y, ntt.Mod()), actual);
+
+    ASSERT_THROW(NttMontgomery64(4611686018427387905LL, 16), std::invalid_argument);
+}
+
+/*
+ * 64 ビットのモジュラスに対する変換に 32 ビットで格納した数列を渡すと例外が送出されることを確認する．
+ */
+TEST_F(NttTest, Montgomery64RejectsU32) {
+    NttMontgomery64 ntt(4179340454199820289LL, 16);
+    const Ntt& base = ntt;
+    std::vector<u32> a(16, 1);
+    std::vector<u32> c(16);
+    ASSERT_THROW(base.Dft(a.data()), std::invalid_argument);
+    ASSERT_THROW(base.Idft(a.data()), std::invalid_argument);
+    ASSERT_THROW(base.MultVec(a.data(), a.data(), c.data(), 16), std::invalid_argument);
+    ASSERT_THROW(base.Mult(a.data(), a.data(), c.data(), nullptr), std::invalid_argument);
+    ASSERT_THROW(base.Square(a.data(), c.data()), std::invalid_argument);
+}
+
+/*
+ * 入力を変更しない畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultConst) {
+    NttMod19529729Deg131072M ntt;
+    NttNaiveMod337Deg8 ntt_naive;
+    Workspace work;
+
+    for (const Ntt *p : { static_cast<const Ntt *>(&ntt), static_cast<const Ntt *>(&ntt_naive) }) {
+        std::vector<ll> a = MakeSequence(p->N(), 8, 1, p->Mod());
+        std::vector<ll> b = MakeSequence(p->N(), 8, 2, p->Mod());
+        std::vector<ll> expected = NaiveCyclicConvolution(a, b, p->Mod());
+        std::vector<ll> a_org = a;
+        std::vector<ll> b_org = b;
+
+        std::vector<ll> actual(p->N(), 0);
+        p->Mult(a.data(), b.data(), actual.data(), &work);
+        ASSERT_EQ(expected, actual);
+        ASSERT_EQ(a_org, a);
+        ASSERT_EQ(b_org, b);
+
+        p->Mult(a.data(), b.data(), b.data(), nullptr);
+        ASSERT_EQ(expected, b);
+    }
+}
+
+/*
+ * 長さを省略した要素ごとの積が長さ N() の積に委譲され，派生クラスで上書きできることを確認する．
+ */
+TEST_F(NttTest, MultVecOverride) {
+    struct CountingNtt : public NttGeneric {
+        CountingNtt() : NttGeneric(998244353, 16) {}
+        void MultVec(ll *a, ll *b, ll *c) const override {
+            calls++;
+            NttGeneric::MultVec(a, b, c);
+        }
+        mutable ll calls = 0;
+    };
+
+    CountingNtt counting;
+    const Ntt& ntt = counting;
+    std::vector<ll> a = MakeSequence(ntt.N(), ntt.N(), 1, ntt.Mod());
+    std::vector<ll> b = MakeSequence(ntt.N(), ntt.N(), 2, ntt.Mod());
+    std::vector<ll> expected(ntt.N());
+    ntt.MultVec(a.data(), b.data(), expected.data(), ntt.N());
+
+    std::vector<ll> actual(ntt.N());
+    ntt.MultVec(a.data(), b.data(), actual.data());
+    ASSERT_EQ(expected, actual);
+    ASSERT_EQ(1, counting.calls);
+}
+
+/*
+ * 32 ビットで格納した数列の畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, Mult32) {
+    NttMod19529729Deg131072 ntt_basic;
+    NttMod19529729Deg131072M ntt_montgomery;
+    NttMod19529729Deg131072M ntt_montgomery_scalar;
+    ntt_montgomery_scalar.SetSimdIsa(MontgomerySimd::Isa::kScalar);
+    NttStaticMod19529729Deg131072 ntt_static;
+    NttNaiveMod337Deg8 ntt_naive;
+    NttHarvey ntt_harvey(998244353, 1024);
+    Workspace work;
+
+    for (const Ntt *p : { static_cast<const Ntt *>(&ntt_basic),
+                          static_cast<const Ntt *>(&ntt_harvey),
+                          static_cast<const Ntt *>(&ntt_montgomery),
+                          static_cast<const Ntt *>(&ntt_montgomery_scalar),
+                          static_cast<const Ntt *>(&ntt_static),
+                          static_cast<const Ntt *>(&ntt_naive) }) {
+        std::vector<ll> a = MakeSequence(p->N(), 8, 1, p->Mod());
+        std::vector<ll> b = MakeSequence(p->N(), 8, 2, p->Mod());
+        std::vector<ll> expected = NaiveCyclicConvolution(a, b, p->Mod());
+
+        std::vector<u32> a32(a.begin(), a.end());
+        std::vector<u32> b32(b.begin(), b.end());
+        std::vector<u32> actual(p->N(), 0);
+        p->Mult(a32.data(), b32.data(), actual.data(), &work);
+        ASSERT_EQ(std::vector<u32>(expected.begin(), expected.end()), actual);
+
+        p->Dft(a32.data());
+        p->Idft(a32.data());
+        ASSERT_EQ(std::vector<u32>(a.begin(), a.end()), a32);
+    }
+}
+
+/*
+ * 変換済みの数列との畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultSpectrum) {
+    NttMod19529729Deg131072 ntt;
+    NttMod19529729Deg131072M ntt_m;
+
+    for (const Ntt *p : { static_cast<const Ntt *>(&ntt), static_cast<const Ntt *>(&ntt_m) }) {
+        std::vector<ll> a = MakeSequence(p->N(), 16, 1, p->Mod());
+        Spectrum spectrum;
+        p->Prepare(a.data(), &spectrum);
+
+        for (ll seed = 2; seed < 4; seed++) {
+            std::vector<ll> x = MakeSequence(p->N(), 16, seed, p->Mod());
+            std::vector<ll> expected = NaiveCyclicConvolution(a, x, p->Mod());
+
+            p->Mult(spectrum, x.data(), x.data());
+            ASSERT_EQ(expected, x);
+        }
+    }
+
+    // 次数の異なる変換で作った変換済みの数列は受け付けない
+    NttGeneric ntt_small(19529729, 1024);
+    std::vector<ll> a = MakeSequence(1024, 16, 1, ntt_small.Mod());
+    Spectrum spectrum;
+    ntt_small.Prepare(a.data(), &spectrum);
+    std::vector<ll> x(ntt.N());
+    ASSERT_THROW(ntt.Mult(spectrum, x.data(), x.data()), std::invalid_argument);
+    ASSERT_THROW(ntt.MultTransformed(spectrum, x.data()), std::invalid_argument);
+
+    // 次数が同じでもモジュラスの異なる変換や，作成していない変換済みの数列は受け付けない
+    NttGeneric ntt_other(998244353, 1024);
+    std::vector<ll> y(1024);
+    ASSERT_THROW(ntt_other.Mult(spectrum, y.data(), y.data()), std::invalid_argument);
+    Spectrum empty;
+    empty.Resize(1024);
+    ASSERT_THROW(ntt_small.Mult(empty, y.data(), y.data()), std::invalid_argument);
+}
+
+/*
+ * Prepare の後にビット反転の並び替えを省くかどうかを切り替えると，要素の順序が
+ * 異なる変換済みの数列は受け付けず，作り直せば正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultSpectrumBitReversalToggle) {
+    NttHarvey ntt(998244353, 1 << 10);
+    NttMod19529729Deg131072M ntt_m;
+
+    for (NttBase *p : { static_cast<NttBase *>(&ntt), static_cast<NttBase *>(&ntt_m) }) {
+        std::vector<ll> a = MakeSequence(p->N(), 16, 1, p->Mod());
+        std::vector<ll> x = MakeSequence(p->N(), 16, 2, p->Mod());
+        std::vector<ll> expected = NaiveCyclicConvolution(a, x, p->Mod());
+
+        for (bool enabled : { true, false }) {
+            p->SetBitReversalFree(enabled);
+            Spectrum spectrum;
+            p->Prepare(a.data(), &spectrum);
+            ASSERT_EQ(enabled ? Spectrum::Order::kBitReversed : Spectrum::Order::kNatural,
+                      spectrum.Ordering());
+            ASSERT_EQ(p->Mod(), spectrum.Mod());
+
+            p->SetBitReversalFree(!enabled);
+            std::vector<ll> c = x;
+            ASSERT_THROW(p->Mult(spectrum, x.data(), c.data()), std::invalid_argument);
+            ASSERT_EQ(x, c);
+
+            p->SetBitReversalFree(enabled);
+            p->Mult(spectrum, x.data(), c.data());
+            ASSERT_EQ(expected, c);
+        }
+        p->SetBitReversalFree(true);
+    }
+}
+
+/*
+ * 入力の長さを指定した畳み込みが正しく計算できることを確認する．
+ */
+TEST_F(NttTest, MultTruncated) {
+    NttMod19529729Deg131072 ntt;
+    NttMod19529729Deg131072M ntt_m;
+    NttNaiveMod337Deg8 ntt_naive;
+
+    CheckMultTruncated(ntt, 4, 4);
+    CheckMultTruncated(ntt, 1, 1);
+    CheckMultTruncated(ntt, 100, 29);
+    CheckMultTruncated(ntt_m, 4, 4);
+    CheckMultTruncated(ntt_m, 1000, 513);
+    CheckMultTruncated(ntt_naive, 3, 4);
+    CheckMultTruncated(ntt_naive, 8, 8);
+
+    // 作業領域を超える長さの入力は受け付けない
+    std::vector<ll> a(ntt_naive.N() + 1, 1);
+    std::vector<ll> c(ntt_naive.N());
+    ASSERT_THROW(ntt_naive.Mult(a.data(), ntt_naive.N() + 1, a.data(), 1, c.data()),
+                 std::invalid_argument);
+    ASSERT_THROW(ntt_naive.Square(a.data(), ntt_naive.N() + 1, c.data()), std::invalid_argument);
+
+    NttHarvey ntt_harvey(998244353, 16);
+    a.resize(17, 1);
+    c.resize(16);
+    ASSERT_THROW(ntt_harvey.Mult(a.data(), 2, a.data(), 17, c.data()), std::invalid_argument);
+    ASSERT_THROW(ntt_harvey.Square(a.data(), 17, c.data()), std::invalid_argument);
+}
+
+/*
+ * 数列の 2 乗が畳み込みと同じ結果になることを確認する．
+ */
+TEST_F(NttTest, Square) {
+    NttMod19529729Deg131072 ntt_basic;
+    NttMod19529729Deg131072M ntt_montgomery;
+    NttMod19529729Deg131072M ntt_montgomery_scalar;
+    ntt_montgomery_scalar.SetSimdIsa(MontgomerySimd::Isa::kScalar);
+    NttStaticMod19529729Deg131072 ntt_static;
+    NttNaiveMod337Deg8 ntt_naive;
+    NttHarvey ntt_harvey(998244353, 1024);
+    NttMontgomery64 ntt_montgomery64(4179340454199820289LL, 1024);
+
+    for (const Ntt *p : { static_cast<const Ntt *>(&ntt_basic),
+                          static_cast<const Ntt *>(&ntt_harvey),
+                          static_cast<const Ntt *>(&ntt_montgomery),
+                          static_cast<const Ntt *>(&ntt_montgomery_scalar),
+                          static_cast<const Ntt *>(&ntt_static),
+                          static_cast<const Ntt *>(&ntt_naive),
+                          static_cast<const Ntt *>(&ntt_montgomery64) }) {
+        std::vector<ll> a = MakeSequence(p->N(), 8, 1, p->Mod());
+        std::vector<ll> expected = NaiveCyclicConvolution(a, a, p->Mod());
+        std::vector<ll> a_org = a;
+
+        std::vector<ll> actual(p->N(), 0);
+        p->Square(a.data(), actual.data());
+        ASSERT_EQ(expected, actual);
+        ASSERT_EQ(a_org, a);
+
+        p->Mult(a.data(), a.data(), actual.data(), nullptr);
+        ASSERT_EQ(expected, actual);
+
+        ll len_a = std::min<ll>(p->N(), 3);
+        ll len_c = std::min(2 * len_a - 1, p->N());
+        std::vector<ll> head(a.begin(), a.begin() + len_a);
+        head.resize(p->N(), 0);
+        std::vector<ll> expected_truncated = NaiveCyclicConvolution(head, head, p->Mod());
+        std::vector<ll> truncated(len_c, -1);
+        p->Square(a.data(), len_a, truncated.data());
+        expected_truncated.resize(len_c);
+        ASSERT_EQ(expected_truncated, truncated);
+
+        // 64 ビットのモジュラスは 32 ビットで格納できないため例外となる
+        std::vector<u32> a32(a.begin(), a.end());
+        if (p == &ntt_montgomery64) {
+            ASSERT_THROW(p->Square(a32.data(), a32.data()), std::invalid_argument);
+        } else {
+            p->Square(a32.data(), a32.data());
+            ASSERT_EQ(std::vector<u32>(expected.begin(), expected.end()), a32);
+        }
+
+        p->Mult(a.data(), a.data(), a.data());
+        ASSERT_EQ(expected, a);
+    }
+}
+
+/*
+ * スレッドプールを使った変換が逐次実行と同じ結果になることを確認する．
+ */
+TEST_F(NttTest, DftParallel) {
+    ThreadPool pool(4);
+
+    for (ll n : { 1LL << 12, 1LL << 15 }) {
+        NttGeneric ntt(998244353, n);
+        NttGeneric ntt_parallel(998244353, n);
+        ntt_parallel.SetThreadPool(&pool);
+
+        std::vector<ll> expected = MakeSequence(n, n, 1, ntt.Mod());
+        std::vector<ll> actual = expected;
+        ntt.Dft(expected.data());
+        ntt_parallel.Dft(actual.data());
+        ASSERT_EQ(expected, actual);
+
+        ntt.Idft(expected.data());
+        ntt_parallel.Idft(actual.data());
+        ASSERT_EQ(expected, actual);
+    }
+
+    NttMod19529729Deg131072M ntt_m;
+    ntt_m.SetThreadPool(&pool);
+    CheckMult(ntt_m, 64);
+}
+
+/*
+ * ブロック単位と基数 4 の順序で実行した変換が段ごとの実行と同じ結果になることを確認する．
+ */
+TEST_F(NttTest, DftBlocked) {
+    ThreadPool pool(4);
+    ThreadPool pool8(8);
+    NttMod19529729Deg131072 ntt_basic;
+    NttMod19529729Deg131072M ntt_montgomery;
+    NttGeneric ntt_generic(998244353, 1 << 15);
+    NttHarvey ntt_harvey(998244353, 1 << 15);
+    NttMontgomery64 ntt_montgomery64(4179340454199820289LL, 1 << 15);
+
+    for (NttBase *p : { static_cast<NttBase *>(&ntt_basic),
+                        static_cast<NttBase *>(&ntt_montgomery),
+                        static_cast<NttBase *>(&ntt_generic),
+                        static_cast<NttBase *>(&ntt_harvey),
+                        static_cast<NttBase *>(&ntt_montgomery64) }) {
+        std::vector<ll> a = MakeSequence(p->N(), p->N(), 1, p->Mod());
+        std::vector<ll> b = MakeSequence(p->N(), 64, 2, p->Mod());
+        std::vector<ll> expected = a;
+        p->SetSchedule(NttBase::Schedule::kBreadthFirst);
+        p->Dft(expected.data());
+        std::vector<ll> expected_mult(p->N());
+        p->Mult(a.data(), b.data(), expected_mult.data(), nullptr);
+        Spectrum expected_spectrum;
+        p->Prepare(a.data(), &expected_spectrum);
+
+        // 段数が奇数・偶数になるブロックの長さと，スレッドプールの有無を試す．
+        // 8 スレッドでは並列に実行する残りの段数が奇数となる
+        for (ll log_block : { 1LL, 4LL, 7LL, 30LL }) {
+            for (ThreadPool *q : { static_cast<ThreadPool *>(nullptr), &pool, &pool8 }) {
+                p->SetSchedule(NttBase::Schedule::kBlocked, log_block);
+                p->SetThreadPool(q);
+
+                std::vector<ll> actual = a;
+                p->Dft(actual.data());
+                ASSERT_EQ(expected, actual);
+                p->Idft(actual.data());
+                ASSERT_EQ(a, actual);
+
+                std::vector<ll> mult(p->N());
+                p->Mult(a.data(), b.data(), mult.data(), nullptr);
+                ASSERT_EQ(expected_mult, mult);
+
+                // 周波数間引きの変換も 2 段ずつの実行で同じスペクトルとなる
+                Spectrum spectrum;
+                p->Prepare(a.data(), &spectrum);
+                ASSERT_TRUE(std::equal(expected_spectrum.Data(),
+                                       expected_spectrum.Data() + p->N(), spectrum.Data()))
+                    << "log_block = " << log_block;
+
+                if (p->Mod() < (1LL << 31)) {
+                    std::vector<u32> a32(a.begin(), a.end());
+                    p->Dft(a32.data());
+                    ASSERT_EQ(std::vector<u32>(expected.begin(), expected.end()), a32);
+                }
+            }
+        }
+        p->SetThreadPool(nullptr);
+        p->SetSchedule(NttBase::Schedule::kBreadthFirst);
+    }
+
+    NttBase::ScheduleReport breadth = ntt_generic.Report(17);
+    ASSERT_EQ(17, breadth.stages);
+    ASSERT_EQ(17, breadth.passes);
+    ASSERT_FALSE(breadth.fused_pairs);
+    ASSERT_EQ(2 * 17 * (1LL << 17) * 8, breadth.bytes);
+
+    ntt_generic.SetSchedule(NttBase::Schedule::kBlocked, 14);
+    NttBase::ScheduleReport blocked = ntt_generic.Report(17, 4);
+    ASSERT_EQ(14, blocked.blocked_stages);
+    ASSERT_TRUE(blocked.fused_pairs);
+    ASSERT_EQ(3, blocked.passes);
+    ASSERT_EQ(2 * 3 * (1LL << 17) * 4, blocked.bytes);
+
+    // 2 段の組を段ごとに実行するエンジンでは，ブロック外の段ごとに走査する
+    for (NttBase *p : { static_cast<NttBase *>(&ntt_montgomery),
+                        static_cast<NttBase *>(&ntt_montgomery64) }) {
+        p->SetSchedule(NttBase::Schedule::kBlocked, 14);
+        NttBase::ScheduleReport split = p->Report(17);
+        ASSERT_FALSE(split.fused_pairs);
+        ASSERT_EQ(4, split.passes);
+        ASSERT_EQ(2 * 4 * (1LL << 17) * 8, split.bytes);
+    }
+    ntt_harvey.SetSchedule(NttBase::Schedule::kBlocked, 14);
+    ASSERT_EQ(3, ntt_harvey.Report(17).passes);
+}
+
+/*
+ * ビット反転の並び替えを省いた畳み込みが並び替える場合と同じ結果になることを確認する．
+ */
+TEST_F(NttTest, MultBitReversalFree) {
+    ThreadPool pool(4);
+    NttMod19529729Deg131072 ntt_basic;
+    NttMod19529729Deg131072M ntt_montgomery;
+    NttMod19529729Deg131072M ntt_montgomery_scalar;
+    ntt_montgomery_scalar.SetSimdIsa(MontgomerySimd::Isa::kScalar);
+    NttHarvey ntt_harvey(998244353, 1 << 14);
+    NttMontgomery64 ntt_montgomery64(4179340454199820289LL, 1 << 14);
+
+    for (NttBase *p : { static_cast<NttBase *>(&ntt_basic),
+                        static_cast<NttBase *>(&ntt_montgomery),
+                        static_cast<NttBase *>(&ntt_montgomery_scalar),
+                        static_cast<NttBase *>(&ntt_harvey),
+                        static_cast<NttBase *>(&ntt_montgomery64) }) {
+        const ll len = 16;
+        std::vector<ll> a = MakeSequence(p->N(), len, 1, p->Mod());
+        std::vector<ll> x = MakeSequence(p->N(), len, 2, p->Mod());
+        std::vector<ll> expected = NaiveCyclicConvolution(a, x, p->Mod());
+        std::vector<ll> expected_square = NaiveCyclicConvolution(a, a, p->Mod());
+
+        for (ThreadPool *q : { static_cast<ThreadPool *>(nullptr), &pool }) {
+            p->SetThreadPool(q);
+            for (bool enabled : { false, true }) {
+                p->SetBitReversalFree(enabled);
+
+                std::vector<ll> c(p->N());
+                p->Mult(a.data(), x.data(), c.data(), nullptr);
+                ASSERT_EQ(expected, c);
+
+                std::vector<ll> truncated(2 * len - 1);
+                p->Mult(a.data(), len, x.data(), len, truncated.data());
+                ASSERT_EQ(std::vector<ll>(expected.begin(), expected.begin() + 2 * len - 1),
+                          truncated);
+
+                Spectrum spectrum;
+                p->Prepare(a.data(), &spectrum);
+                p->Mult(spectrum, x.data(), c.data());
+                ASSERT_EQ(expected, c);
+
+                // Dft, Idft は自然な順序のまま
+                std::vector<ll> y = a;
+                p->Dft(y.data());
+                p->Idft(y.data());
+                ASSERT_EQ(a, y);
+
+                if (p->Mod() < (1LL << 31)) {
+                    std::vector<u32> a32(a.begin(), a.end());
+                    std::vector<u32> c32(p->N());
+                    p->Mult(a32.data(), a32.data(), c32.data(), nullptr);
+                    ASSERT_EQ(std::vector<u32>(expected_square.begin(), expected_square.end()),
+                              c32);
+                }
+            }
+        }
+        p->SetThreadPool(nullptr);
+    }
+}
+
+/*
+ * 複数の畳み込みをまとめて正しく計算でき，数列が重なる間隔では例外が送出されることを確認する．
+ */
+TEST_F(NttTest, MultBatch) {
+    ThreadPool pool(3);
+    NttGeneric ntt(19529729, 256);
+    ll n = ntt.N();
+    ll count = 10;
+
+    std::vector<ll> a(n * count);
+    std::vector<ll> b(n * count);
+    std::vector<ll> expected(n * count);
+    for (ll i = 0; i < count; i++) {
+        std::vector<ll> ai = MakeSequence(n, n, 2 * i + 1, ntt.Mod());
+        std::vector<ll> bi = MakeSequence(n, n, 2 * i + 2, ntt.Mod());
+        std::vector<ll> ci = NaiveCyclicConvolution(ai, bi, ntt.Mod());
+        std::copy(ai.begin(), ai.end(), a.begin() + i * n);
+        std::copy(bi.begin(), bi.end(), b.begin() + i * n);
+        std::copy(ci.begin(), ci.end(), expected.begin() + i * n);
+    }
+
+    std::vector<ll> actual(n * count);
+    ntt.MultBatch(a.data(), b.data(), actual.data(), count, n, &pool);
+    ASSERT_EQ(expected, actual);
+
+    std::vector<const ll *> pa;
+    std::vector<const ll *> pb;
+    std::vector<ll *> pc;
+    std::vector<ll> actual_ptr(n * count);
+    for (ll i = 0; i < count; i++) {
+        pa.push_back(a.data() + i * n);
+        pb.push_back(b.data() + i * n);
+        pc.push_back(actual_ptr.data() + i * n);
+    }
+    ntt.MultBatch(pa.data(), pb.data(), pc.data(), count, nullptr);
+    ASSERT_EQ(expected, actual_ptr);
+
+    ASSERT_THROW(ntt.MultBatch(a.data(), b.data(), actual.data(), count, n - 1, &pool),
+                 std::invalid_argument);
+}
+
+/*
+ * 不正なモジュラスと次数を与えると例外が送出されることを確認する．
+ */
+TEST_F(NttTest, GenericInvalidArgument) {
+    ASSERT_THROW(NttGeneric(19529729, 12), std::invalid_argument);
+    ASSERT_THROW(NttGeneric(337, 32), std::invalid_argument);
+
+    // 2^31 以上のモジュラスと素数でないモジュラス (97 * 193 - 1 は 16 で割り切れる)
+    ASSERT_THROW(NttGeneric(4179340454199820289LL, 16), std::invalid_argument);
+    ASSERT_THROW(NttGeneric(97 * 193, 16), std::invalid_argument);
+    ASSERT_THROW(NttMontgomery64(97 * 193, 16), std::invalid_argument);
+}
+
+/*
+ * 回転因子のテーブルから 1 の n 乗根のべき乗が正しく得られることを確認する．
+ */
+TEST_F(NttTest, PowOmega) {
+    NttMod19529729Deg131072 ntt;
+    NttMod19529729Deg131072M ntt_m;
+
+    for (ll k : { 0LL, 1LL, 2LL, 12345LL, 65535LL, 65536LL, 131071LL }) {
+        ASSERT_EQ(ntt.Pow(770, k), ntt.PowOmega(k));
+        ASSERT_EQ(ntt.Pow(770, k), ntt_m.PowOmega(k));
+        ASSERT_EQ(ntt.Pow(16765131, k), ntt.PowPhi(k));
+        ASSERT_EQ(ntt.Pow(16765131, k), ntt_m.PowPhi(k));
+    }
+}
+
+/*
+ * 先頭 len 個の要素のみが非零である数列を作成して返す．
+ *
+ * @param [in] n 次数
+ * @param [in] len 非零要素の個数
+ * @param [in] seed 係数を決める値
+ * @param [in] mod モジュラス
+ * @return std::vector<ll> 数列
+ */
+std::vector<ll> NttTest::MakeSequence(ll n, ll len, ll seed, ll mod) {
+    std::vector<ll> a(n, 0);
+    ll x = seed;
+    for (ll i = 0; i < len; i++) {
+        x = (x * 1103515245 + 12345) % 2147483648LL;
+        a[i] = x % mod;
+    }
+    return a;
+}
+
+/*
+ * 畳み込みが正しく計算できることを確認する．
+ *
+ * @param [in] ntt NTTオブジェクト
+ * @param [in] len 非零要素の個数
+ */
+void NttTest::CheckMult(const Ntt& ntt, ll len) {
+    std::vector<ll> a = MakeSequence(ntt.N(), len, 1, ntt.Mod());
+    std::vector<ll> b = MakeSequence(ntt.N(), len, 2, ntt.Mod());
+    std::vector<ll> expected = NaiveCyclicConvolution(a, b, ntt.Mod());
+
+    std::vector<ll> actual(ntt.N(), 0);
+    ntt.Mult(a.data(), b.data(), actual.data());
+
+    ASSERT_EQ(expected, actual);
+}
+
+/*
+ * 入力の長さを指定した畳み込みが正しく計算できることを確認する．
+ *
+ * @param [in] ntt NTTオブジェクト
+ * @param [in] len_a 数列 a の長さ
+ * @param [in] len_b 数列 b の長さ
+ */
+void NttTest::CheckMultTruncated(const Ntt& ntt, ll len_a, ll len_b) {
+    std::vector<ll> a = MakeSequence(ntt.N(), len_a, 1, ntt.Mod());
+    std::vector<ll> b = MakeSequence(ntt.N(), len_b, 2, ntt.Mod());
+    std::vector<ll> expected = NaiveCyclicConvolution(a, b, ntt.Mod());
+
+    ll len_c = std::min(len_a + len_b - 1, ntt.N());
+    std::vector<ll> actual(len_c, -1);
+    ntt.Mult(a.data(), len_a, b.data(), len_b, actual.data());
+
+    expected.resize(len_c);
+    ASSERT_EQ(expected, actual);
+}
+
+} // namespace ntt
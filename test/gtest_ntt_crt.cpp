@@ -0,0 +1,88 @@
+/**
+ * @file gtest_ntt_crt.cpp
+ * @brief 複数のモジュラスによる畳み込みのテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/ntt_crt.hpp"
+#include "include/thread_pool.hpp"
+#include "test/test_util.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * 複数のモジュラスによる畳み込みのテストクラス．
+ */
+class NttCrtTest : public ::testing::Test {
+protected:
+};
+
+/*
+ * 単一の素数の範囲を超える整数の畳み込みが正確に計算できることを確認する．
+ */
+TEST_F(NttCrtTest, Mult) {
+    NttCrt ntt(2048);
+    std::vector<ll> a = RandomSequence(1000, 1, 1LL << 24);
+    std::vector<ll> b = RandomSequence(1048, 2, 1LL << 24);
+
+    // 係数は 2^24 * 2^24 * 1000 < 2^58 であり，2^62 を法とすれば正確な値となる
+    std::vector<ll> expected = NaiveConvolution(a, b, 1LL << 62);
+    std::vector<ll> actual(a.size() + b.size() - 1);
+    ntt.Mult(a.data(), a.size(), b.data(), b.size(), actual.data());
+    ASSERT_EQ(expected, actual);
+
+    ThreadPool pool(3);
+    ntt.SetThreadPool(&pool);
+    std::vector<ll> parallel(actual.size());
+    ntt.Mult(a.data(), a.size(), b.data(), b.size(), parallel.data());
+    ASSERT_EQ(expected, parallel);
+
+    // 同じ数列を渡した場合は 2 乗として計算する
+    std::vector<ll> square(2 * a.size() - 1);
+    ntt.Mult(a.data(), a.size(), a.data(), a.size(), square.data());
+    ASSERT_EQ(NaiveConvolution(a, a, 1LL << 62), square);
+}
+
+/*
+ * 素数の積未満の係数を任意のモジュラスで正しく計算できることを確認する．
+ */
+TEST_F(NttCrtTest, MultMod) {
+    NttCrt ntt(1024);
+    ll mod = 1000000007;
+    std::vector<ll> a = RandomSequence(512, 3, mod);
+    std::vector<ll> b = RandomSequence(512, 4, mod);
+
+    std::vector<ll> expected = NaiveConvolution(a, b, mod);
+    std::vector<ll> actual(a.size() + b.size() - 1);
+    ntt.MultMod(a.data(), a.size(), b.data(), b.size(), actual.data(), mod);
+    ASSERT_EQ(expected, actual);
+
+    NttCrt ntt_two(1024, { 998244353, 469762049 });
+    std::vector<ll> small_a = RandomSequence(512, 5, 1 << 20);
+    std::vector<ll> small_b = RandomSequence(512, 6, 1 << 20);
+    expected = NaiveConvolution(small_a, small_b, mod);
+    ntt_two.MultMod(small_a.data(), small_a.size(), small_b.data(), small_b.size(),
+                    actual.data(), mod);
+    ASSERT_EQ(expected, actual);
+}
+
+/*
+ * 扱えない次数，素数，長さ，モジュラスを指定すると例外が送出されることを確認する．
+ */
+TEST_F(NttCrtTest, InvalidArgument) {
+    ASSERT_THROW(NttCrt(1LL << 24), std::invalid_argument);
+    ASSERT_THROW(NttCrt(16, {}), std::invalid_argument);
+    ASSERT_THROW(NttCrt(16, { 998244353, 469762049, 998244353 }), std::invalid_argument);
+
+    NttCrt ntt(16);
+    std::vector<ll> a(17, 1);
+    std::vector<ll> c(16);
+    ASSERT_THROW(ntt.Mult(a.data(), 17, a.data(), 1, c.data()), std::invalid_argument);
+    ASSERT_THROW(ntt.MultMod(a.data(), 1, a.data(), 1, c.data(), 0), std::invalid_argument);
+    ASSERT_THROW(ntt.MultMod(a.data(), 1, a.data(), 1, c.data(), -5), std::invalid_argument);
+    ASSERT_THROW(ntt.MultMod(a.data(), 1, a.data(), 1, c.data(), 1LL << 62), std::invalid_argument);
+}
+
+} // namespace ntt
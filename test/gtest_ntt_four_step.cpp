@@ -0,0 +1,92 @@
+/**
+ * @file gtest_ntt_four_step.cpp
+ * @brief 4 段階法による Number theoretic transform のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/ntt_four_step.hpp"
+#include "include/thread_pool.hpp"
+#include "test/test_util.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * 4 段階法による Number theoretic transform のテストクラス．
+ */
+class NttFourStepTest : public ::testing::Test {
+protected:
+};
+
+/*
+ * 行数と列数が等しい場合と異なる場合のいずれでも，
+ * 変換結果が NttGeneric と一致し，逆変換で元に戻ることを確認する．
+ */
+TEST_F(NttFourStepTest, Dft) {
+    const ll kMod = 998244353;
+    ThreadPool pool(3);
+
+    for (ll n : { 4LL, 8LL, 64LL, 2048LL, 4096LL }) {
+        NttFourStep ntt(kMod, n);
+        NttGeneric reference(kMod, n);
+        ASSERT_EQ(n, ntt.Rows() * ntt.Columns());
+
+        std::vector<ll> a = RandomSequence(n, n, kMod);
+        std::vector<ll> expected = a;
+        reference.Dft(expected.data());
+
+        for (ThreadPool *p : { static_cast<ThreadPool *>(nullptr), &pool }) {
+            ntt.SetThreadPool(p);
+            std::vector<ll> actual = a;
+            ntt.Dft(actual.data());
+            ASSERT_EQ(expected, actual) << "n = " << n;
+
+            ntt.Idft(actual.data());
+            ASSERT_EQ(a, actual) << "n = " << n;
+        }
+    }
+}
+
+/*
+ * 転置を省いた畳み込みが NttGeneric の畳み込みと一致することを確認する．
+ */
+TEST_F(NttFourStepTest, Mult) {
+    const ll kMod = 469762049;
+    ThreadPool pool(2);
+
+    for (ll n : { 16LL, 2048LL }) {
+        NttFourStep ntt(kMod, n);
+        NttGeneric reference(kMod, n);
+        std::vector<ll> a = RandomSequence(n, 1, kMod);
+        std::vector<ll> b = RandomSequence(n, 2, kMod);
+
+        std::vector<ll> expected(n);
+        reference.Mult(a.data(), b.data(), expected.data(), nullptr);
+
+        for (ThreadPool *p : { static_cast<ThreadPool *>(nullptr), &pool }) {
+            ntt.SetThreadPool(p);
+            std::vector<ll> actual(n);
+            ntt.Mult(a.data(), b.data(), actual.data(), nullptr);
+            ASSERT_EQ(expected, actual) << "n = " << n;
+
+            std::vector<ll> truncated(n - 1);
+            std::vector<ll> expected_truncated(n - 1);
+            ntt.Mult(a.data(), n / 2, b.data(), n / 2, truncated.data(), nullptr);
+            reference.Mult(a.data(), n / 2, b.data(), n / 2, expected_truncated.data(), nullptr);
+            ASSERT_EQ(expected_truncated, truncated) << "n = " << n;
+        }
+    }
+}
+
+/*
+ * 扱えないモジュラスや次数を指定すると例外が送出されることを確認する．
+ */
+TEST_F(NttFourStepTest, InvalidArgument) {
+    ASSERT_THROW(NttFourStep(998244353, 2), std::invalid_argument);
+    ASSERT_THROW(NttFourStep(998244353, 48), std::invalid_argument);
+    ASSERT_THROW(NttFourStep(998244353, 1LL << 24), std::invalid_argument);
+    ASSERT_THROW(NttFourStep(4179340454199820289LL, 1024), std::invalid_argument);
+}
+
+} // namespace ntt
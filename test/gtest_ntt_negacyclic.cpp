@@ -0,0 +1,146 @@
+/**
+ * @file gtest_ntt_negacyclic.cpp
+ * @brief x^n + 1 を法とする畳み込みのテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/ntt_negacyclic.hpp"
+#include "include/util.hpp"
+#include "test/test_util.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * x^n + 1 を法とする畳み込みのテストクラス．
+ */
+class NttNegacyclicTest : public ::testing::Test {
+protected:
+    /**
+     * x^n + 1 を法とする積を素朴に計算して返す．
+     *
+     * @param [in] a 数列 (長さ n)
+     * @param [in] b 数列 (長さ n)
+     * @param [in] mod モジュラス
+     * @return std::vector<ll> a と b の負巡回畳み込み
+     */
+    std::vector<ll> Negacyclic(const std::vector<ll>& a, const std::vector<ll>& b, ll mod);
+
+    /** モジュラス */
+    const ll kMod = 998244353;
+};
+
+/*
+ * 変換が ψ の奇数乗での評価と一致し，逆変換で元に戻ることを確認する．
+ */
+TEST_F(NttNegacyclicTest, Dft) {
+    for (ll n : { 2LL, 8LL, 64LL }) {
+        NttNegacyclic ntt(kMod, n);
+        ASSERT_EQ(kMod - 1, Utility::PowMod(ntt.Psi(), n, kMod));
+
+        std::vector<ll> a = RandomSequence(n, n, kMod);
+        std::vector<ll> expected(n, 0);
+        for (ll k = 0; k < n; k++) {
+            ll x = Utility::PowMod(ntt.Psi(), 2 * k + 1, kMod);
+            for (ll j = n - 1; j >= 0; j--) {
+                expected[k] = (expected[k] * x + a[j]) % kMod;
+            }
+        }
+
+        std::vector<ll> actual = a;
+        ntt.Dft(actual.data());
+        ASSERT_EQ(expected, actual) << "n = " << n;
+
+        ntt.Idft(actual.data());
+        ASSERT_EQ(a, actual) << "n = " << n;
+    }
+}
+
+/*
+ * Ntt の畳み込みが x^n + 1 を法とする積となることを確認する．
+ */
+TEST_F(NttNegacyclicTest, Mult) {
+    for (ll n : { 2LL, 16LL, 1024LL }) {
+        NttNegacyclic ntt(kMod, n);
+        std::vector<ll> a = RandomSequence(n, 1, kMod);
+        std::vector<ll> b = RandomSequence(n, 2, kMod);
+        std::vector<ll> expected = Negacyclic(a, b, kMod);
+
+        std::vector<ll> actual(n);
+        ntt.Mult(a.data(), b.data(), actual.data(), nullptr);
+        ASSERT_EQ(expected, actual) << "n = " << n;
+
+        // 同じ元を渡した場合は 2 乗となる
+        ntt.Mult(a.data(), a.data(), actual.data(), nullptr);
+        ASSERT_EQ(Negacyclic(a, a, kMod), actual) << "n = " << n;
+
+        // 変換済みの元との積
+        Spectrum spectrum;
+        ntt.Prepare(a.data(), &spectrum);
+        ntt.Mult(spectrum, b.data(), actual.data());
+        ASSERT_EQ(expected, actual) << "n = " << n;
+    }
+}
+
+/*
+ * 変換した表現のまま積を繰り返しても環の積と一致することを確認する．
+ */
+TEST_F(NttNegacyclicTest, Pointwise) {
+    const ll n = 256;
+    NttNegacyclic ntt(kMod, n);
+    std::vector<ll> a = RandomSequence(n, 3, kMod);
+    std::vector<ll> b = RandomSequence(n, 4, kMod);
+    std::vector<ll> c = RandomSequence(n, 5, kMod);
+    std::vector<ll> expected = Negacyclic(Negacyclic(a, b, kMod), c, kMod);
+
+    ntt.ToPointwise(a.data());
+    ntt.ToPointwise(b.data());
+    ntt.ToPointwise(c.data());
+    ntt.MultVec(a.data(), b.data(), a.data());
+    ntt.MultVec(a.data(), c.data(), a.data());
+    ntt.FromPointwise(a.data());
+    ASSERT_EQ(expected, a);
+}
+
+/*
+ * 扱えないモジュラスや次数を指定すると例外が送出されることを確認する．
+ */
+TEST_F(NttNegacyclicTest, InvalidArgument) {
+    ASSERT_THROW(NttNegacyclic(kMod, 1), std::invalid_argument);
+    ASSERT_THROW(NttNegacyclic(kMod, 12), std::invalid_argument);
+    ASSERT_THROW(NttNegacyclic(kMod, 1LL << 23), std::invalid_argument);
+    ASSERT_THROW(NttNegacyclic(4179340454199820289LL, 16), std::invalid_argument);
+    // 33 - 1 と 97 * 193 - 1 は 2n = 32 で割り切れるが，33 と 97 * 193 は合成数である
+    ASSERT_THROW(NttNegacyclic(33, 16), std::invalid_argument);
+    ASSERT_THROW(NttNegacyclic(97 * 193, 16), std::invalid_argument);
+    ASSERT_THROW(NttNegacyclic(1, 16), std::invalid_argument);
+}
+
+/*
+ * x^n + 1 を法とする積を素朴に計算して返す．
+ *
+ * @param [in] a 数列 (長さ n)
+ * @param [in] b 数列 (長さ n)
+ * @param [in] mod モジュラス
+ * @return std::vector<ll> a と b の負巡回畳み込み
+ */
+std::vector<ll> NttNegacyclicTest::Negacyclic(const std::vector<ll>& a,
+                                             const std::vector<ll>& b, ll mod) {
+    ll n = a.size();
+    std::vector<ll> c(n, 0);
+    for (ll i = 0; i < n; i++) {
+        for (ll j = 0; j < n; j++) {
+            ll x = (a[i] * b[j]) % mod;
+            ll k = i + j;
+            if (k < n) {
+                c[k] = (c[k] + x) % mod;
+            } else {
+                c[k - n] = (c[k - n] + mod - x) % mod;
+            }
+        }
+    }
+    return c;
+}
+
+} // namespace ntt
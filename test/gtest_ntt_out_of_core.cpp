@@ -0,0 +1,236 @@
+/**
+ * @file gtest_ntt_out_of_core.cpp
+ * @brief ファイルに置いた数列の Number theoretic transform のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/ntt_out_of_core.hpp"
+#include "include/thread_pool.hpp"
+#include "test/test_util.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * ファイルに置いた数列の Number theoretic transform のテストクラス．
+ */
+class NttOutOfCoreTest : public ::testing::Test {
+protected:
+    /**
+     * 数列をファイルに書き出す．
+     *
+     * @param [in] path ファイル
+     * @param [in] a 数列
+     */
+    void WriteFile(const std::string& path, const std::vector<ll>& a);
+
+    /**
+     * ファイルから長さ n の数列を読み込んで返す．
+     *
+     * @param [in] path ファイル
+     * @param [in] n 数列の長さ
+     * @return std::vector<ll> 数列
+     */
+    std::vector<ll> ReadFile(const std::string& path, ll n);
+
+    /** モジュラス */
+    const ll kMod = 998244353;
+};
+
+/*
+ * パネルの大きさとスレッドプールの有無によらず，変換がメモリ上の変換と一致し，
+ * 逆変換で元の数列に戻ることを確認する．
+ */
+TEST_F(NttOutOfCoreTest, DftIdft) {
+    std::string path = ::testing::TempDir() + "ntt_out_of_core_dft.bin";
+    ThreadPool pool(2);
+
+    for (ll n : { 4LL, 64LL, 2048LL }) {
+        NttOutOfCore out_of_core(kMod, n);
+        NttHarvey harvey(kMod, n);
+        ASSERT_EQ(n, out_of_core.Rows() * out_of_core.Columns());
+
+        std::vector<ll> a = RandomSequence(n, n, kMod);
+        std::vector<ll> expected = a;
+        harvey.Dft(expected.data());
+
+        for (ll columns : { 1LL, out_of_core.Columns() / 2, out_of_core.Columns() }) {
+            for (ThreadPool *p : { static_cast<ThreadPool *>(nullptr), &pool }) {
+                out_of_core.SetPanelSize(columns, out_of_core.Rows() / 2);
+                out_of_core.SetThreadPool(p);
+
+                WriteFile(path, a);
+                out_of_core.Dft(path);
+                ASSERT_EQ(expected, ReadFile(path, n)) << "n = " << n << ", columns = " << columns;
+                out_of_core.Idft(path);
+                ASSERT_EQ(a, ReadFile(path, n)) << "n = " << n << ", columns = " << columns;
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+/*
+ * 畳み込みがメモリ上の畳み込みと一致することを，2 乗と出力先が入力と同じ場合を含めて確認する．
+ */
+TEST_F(NttOutOfCoreTest, Mult) {
+    std::string dir = ::testing::TempDir();
+    std::string path_a = dir + "ntt_out_of_core_a.bin";
+    std::string path_b = dir + "ntt_out_of_core_b.bin";
+    std::string path_c = dir + "ntt_out_of_core_c.bin";
+    ll n = 1024;
+    NttOutOfCore out_of_core(kMod, n);
+    NttHarvey harvey(kMod, n);
+
+    std::vector<ll> a = RandomSequence(n, 1, kMod);
+    std::vector<ll> b = RandomSequence(n, 2, kMod);
+    std::vector<ll> expected(n);
+    harvey.Mult(a.data(), n, b.data(), n, expected.data());
+    std::vector<ll> square(n);
+    harvey.Mult(a.data(), n, a.data(), n, square.data());
+
+    WriteFile(path_a, a);
+    WriteFile(path_b, b);
+    out_of_core.Mult(path_a, path_b, path_c);
+    ASSERT_EQ(expected, ReadFile(path_c, n));
+    ASSERT_EQ(b, ReadFile(path_b, n));
+
+    out_of_core.Mult(path_a, path_a, path_c);
+    ASSERT_EQ(square, ReadFile(path_c, n));
+
+    out_of_core.Mult(path_a, path_b, path_a);
+    ASSERT_EQ(expected, ReadFile(path_a, n));
+
+    std::remove(path_a.c_str());
+    std::remove(path_b.c_str());
+    std::remove(path_c.c_str());
+}
+
+/*
+ * 変換と畳み込みが一時ファイルを残さず，例外が送出された場合も一時ファイルを削除することを確認する．
+ */
+TEST_F(NttOutOfCoreTest, TempFile) {
+    std::string dir = ::testing::TempDir() + "ntt_out_of_core.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(&dir[0]));
+    std::string path_a = dir + "/a.bin";
+    std::string path_b = dir + "/b.bin";
+    std::string path_c = dir + "/c.bin";
+    auto list = [&dir]() {
+        std::vector<std::string> names;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            names.push_back(entry.path().filename().string());
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    };
+
+    ll n = 256;
+    NttOutOfCore out_of_core(kMod, n);
+    WriteFile(path_a, RandomSequence(n, 1, kMod));
+    WriteFile(path_b, RandomSequence(n, 2, kMod));
+    out_of_core.Dft(path_a);
+    out_of_core.Idft(path_a);
+    out_of_core.Mult(path_a, path_b, path_c);
+    ASSERT_EQ(std::vector<std::string>({ "a.bin", "b.bin", "c.bin" }), list());
+
+    WriteFile(path_b, RandomSequence(n / 2, 2, kMod));
+    ASSERT_THROW(out_of_core.Mult(path_a, path_b, path_c), std::invalid_argument);
+    ASSERT_EQ(std::vector<std::string>({ "a.bin", "b.bin", "c.bin" }), list());
+
+    std::filesystem::remove_all(dir);
+}
+
+/*
+ * 62 ビットのモジュラスで変換と畳み込みがメモリ上の計算と一致し，2^30 点の変換を
+ * 構築できることを確認する．
+ */
+TEST_F(NttOutOfCoreTest, LargeModulus) {
+    // 4179340454199820289 = 29 * 2^57 + 1
+    const ll mod = 4179340454199820289LL;
+    std::string path = ::testing::TempDir() + "ntt_out_of_core_large.bin";
+    std::string path_b = ::testing::TempDir() + "ntt_out_of_core_large_b.bin";
+    ll n = 512;
+    NttOutOfCore out_of_core(mod, n);
+    NttMontgomery64 in_memory(mod, n);
+    out_of_core.SetPanelSize(4, 4);
+
+    std::vector<ll> a = RandomSequence(n, 3, mod);
+    std::vector<ll> b = RandomSequence(n, 4, mod);
+    a[0] = mod - 1;
+    b[n - 1] = mod - 1;
+    std::vector<ll> expected = a;
+    in_memory.Dft(expected.data());
+
+    WriteFile(path, a);
+    out_of_core.Dft(path);
+    ASSERT_EQ(expected, ReadFile(path, n));
+    out_of_core.Idft(path);
+    ASSERT_EQ(a, ReadFile(path, n));
+
+    std::vector<ll> product(n);
+    in_memory.Mult(a.data(), b.data(), product.data(), nullptr);
+    WriteFile(path_b, b);
+    out_of_core.Mult(path, path_b, path);
+    ASSERT_EQ(product, ReadFile(path, n));
+    std::remove(path.c_str());
+    std::remove(path_b.c_str());
+
+    // 2^30 点 (8 GiB) のファイルを扱う変換．部分変換の大きさは 2^15 点に収まる
+    NttOutOfCore huge(mod, 1LL << 30);
+    ASSERT_EQ(1LL << 30, huge.N());
+    ASSERT_EQ(1LL << 15, huge.Rows());
+    ASSERT_EQ(1LL << 15, huge.Columns());
+}
+
+/*
+ * 扱えないモジュラス，次数，パネルの大きさ，ファイルを指定すると例外が送出されることを確認する．
+ */
+TEST_F(NttOutOfCoreTest, InvalidArgument) {
+    ASSERT_THROW(NttOutOfCore(kMod, 2), std::invalid_argument);
+    ASSERT_THROW(NttOutOfCore(kMod, 48), std::invalid_argument);
+    ASSERT_THROW(NttOutOfCore(kMod * 7, 64), std::invalid_argument);
+    ASSERT_THROW(NttOutOfCore(kMod, 1LL << 24), std::invalid_argument);
+
+    NttOutOfCore out_of_core(kMod, 64);
+    ASSERT_THROW(out_of_core.SetPanelSize(3, 1), std::invalid_argument);
+    ASSERT_THROW(out_of_core.SetPanelSize(1, 2 * out_of_core.Rows()), std::invalid_argument);
+
+    std::string path = ::testing::TempDir() + "ntt_out_of_core_short.bin";
+    WriteFile(path, RandomSequence(32, 1, kMod));
+    ASSERT_THROW(out_of_core.Dft(path), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+/*
+ * 数列をファイルに書き出す．
+ *
+ * @param [in] path ファイル
+ * @param [in] a 数列
+ */
+void NttOutOfCoreTest::WriteFile(const std::string& path, const std::vector<ll>& a) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(a.data()), a.size() * sizeof(ll));
+}
+
+/*
+ * ファイルから長さ n の数列を読み込んで返す．
+ *
+ * @param [in] path ファイル
+ * @param [in] n 数列の長さ
+ * @return std::vector<ll> 数列
+ */
+std::vector<ll> NttOutOfCoreTest::ReadFile(const std::string& path, ll n) {
+    std::vector<ll> a(n);
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char *>(a.data()), n * sizeof(ll));
+    return a;
+}
+
+} // namespace ntt
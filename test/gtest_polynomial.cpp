@@ -0,0 +1,175 @@
+/**
+ * @file gtest_polynomial.cpp
+ * @brief 多項式演算のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/polynomial.hpp"
+#include "include/aligned_memory.hpp"
+#include "include/util.hpp"
+#include "test/test_util.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * 多項式演算のテストクラス．
+ */
+class PolynomialRingTest : public ::testing::Test {
+protected:
+    /** モジュラス */
+    const ll kMod = 998244353;
+};
+
+/*
+ * 積が素朴な計算と一致することを確認する．
+ */
+TEST_F(PolynomialRingTest, Mult) {
+    PolynomialRing ring(kMod, 1024);
+    for (ll n : { 1LL, 5LL, 33LL, 300LL }) {
+        std::vector<ll> a = RandomSequence(n, 1, kMod);
+        std::vector<ll> b = RandomSequence(n + 7, 2, kMod);
+        ASSERT_EQ(NaiveConvolution(a, b, kMod), ring.Mult(a, b)) << "n = " << n;
+        ASSERT_EQ(NaiveConvolution(a, a, kMod), ring.Mult(a, a)) << "n = " << n;
+    }
+    ASSERT_TRUE(ring.Mult({}, { 1, 2 }).empty());
+    ASSERT_THROW(ring.Mult(RandomSequence(600, 1, kMod), RandomSequence(600, 2, kMod)), std::length_error);
+}
+
+/*
+ * a a^-1 = 1 mod x^n となることを確認する．
+ */
+TEST_F(PolynomialRingTest, Inv) {
+    PolynomialRing ring(kMod, 2048);
+    for (ll n : { 1LL, 2LL, 7LL, 64LL, 1000LL }) {
+        std::vector<ll> a = RandomSequence(n + 3, n, kMod);
+        a[0] = 3;
+        std::vector<ll> inv = ring.Inv(a, n);
+        ASSERT_EQ(n, static_cast<ll>(inv.size()));
+
+        std::vector<ll> product = NaiveConvolution(a, inv, kMod);
+        for (ll i = 0; i < n; i++) {
+            ASSERT_EQ((i == 0) ? 1 : 0, product[i]) << "n = " << n << ", i = " << i;
+        }
+    }
+    ASSERT_THROW(ring.Inv({ 0, 1 }, 4), std::invalid_argument);
+}
+
+/*
+ * 商と余りが a = b q + r, deg r < deg b を満たすことを確認する．
+ */
+TEST_F(PolynomialRingTest, DivMod) {
+    PolynomialRing ring(kMod, 2048);
+    for (ll len_a : { 3LL, 40LL, 500LL }) {
+        for (ll len_b : { 1LL, 2LL, 35LL, 200LL }) {
+            std::vector<ll> a = RandomSequence(len_a, len_a, kMod);
+            std::vector<ll> b = RandomSequence(len_b, len_b + 1, kMod);
+            b.back() = 5;
+            std::vector<ll> q;
+            std::vector<ll> r;
+            ring.DivMod(a, b, &q, &r);
+            ASSERT_LT(r.size(), b.size());
+
+            std::vector<ll> expected = NaiveConvolution(b, q, kMod);
+            expected.resize(std::max(expected.size(), a.size()), 0);
+            for (size_t i = 0; i < r.size(); i++) {
+                expected[i] = (expected[i] + r[i]) % kMod;
+            }
+            while (!expected.empty() && expected.back() == 0) {
+                expected.pop_back();
+            }
+            ASSERT_EQ(a, expected) << "len_a = " << len_a << ", len_b = " << len_b;
+        }
+    }
+    ASSERT_THROW(ring.DivMod({ 1, 2 }, { 0, 0 }, nullptr, nullptr), std::invalid_argument);
+}
+
+/*
+ * 指数が係数の漸化式 n b_n = Σ k a_k b_(n-k) による計算と一致し，
+ * 対数で元に戻ることを確認する．
+ */
+TEST_F(PolynomialRingTest, ExpLog) {
+    PolynomialRing ring(kMod, 1024);
+    for (ll n : { 1LL, 2LL, 3LL, 17LL, 512LL }) {
+        std::vector<ll> a = RandomSequence(n, n + 5, kMod);
+        a[0] = 0;
+
+        std::vector<ll> expected(n, 0);
+        expected[0] = 1;
+        for (ll i = 1; i < n; i++) {
+            ll s = 0;
+            for (ll k = 1; k <= i; k++) {
+                s = (s + a[k] * k % kMod * expected[i - k]) % kMod;
+            }
+            expected[i] = s * Utility::InvMod(i, kMod) % kMod;
+        }
+
+        std::vector<ll> b = ring.Exp(a, n);
+        ASSERT_EQ(expected, b) << "n = " << n;
+        ASSERT_EQ(a, ring.Log(b, n)) << "n = " << n;
+    }
+    ASSERT_THROW(ring.Exp({ 1, 2 }, 4), std::invalid_argument);
+    ASSERT_THROW(ring.Log({ 2, 1 }, 4), std::invalid_argument);
+}
+
+/*
+ * ニュートン法の作業領域をスレッドのアリーナから切り出し，2 回目以降の呼び出しでは
+ * 新たにチャンクを確保しないことを確認する．
+ */
+TEST_F(PolynomialRingTest, ArenaReuse) {
+    PolynomialRing ring(kMod, 1 << 16);
+    std::vector<ll> a = RandomSequence(1 << 14, 3, kMod);
+    a[0] = 0;
+    Arena& arena = Arena::ThreadLocal();
+
+    std::vector<ll> exp = ring.Exp(a, a.size());
+    std::vector<ll> inv = ring.Inv(exp, a.size());
+    size_t capacity = arena.Capacity();
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(exp, ring.Exp(a, a.size()));
+        ASSERT_EQ(inv, ring.Inv(exp, a.size()));
+        ASSERT_EQ(capacity, arena.Capacity());
+    }
+}
+
+/*
+ * 多点評価が Horner 法と一致し，補間で元の多項式に戻ることを確認する．
+ */
+TEST_F(PolynomialRingTest, EvaluateInterpolate) {
+    PolynomialRing ring(kMod, 2048);
+    for (ll n : { 1LL, 20LL, 64LL, 100LL, 700LL }) {
+        std::vector<ll> a = RandomSequence(n, n, kMod);
+        std::vector<ll> xs(n);
+        for (ll i = 0; i < n; i++) {
+            xs[i] = (i * i * 7 + i + 3) % kMod;
+        }
+
+        std::vector<ll> values = ring.Evaluate(a, xs);
+        for (ll i = 0; i < n; i++) {
+            ll v = 0;
+            for (ll j = n - 1; j >= 0; j--) {
+                v = (v * xs[i] + a[j]) % kMod;
+            }
+            ASSERT_EQ(v, values[i]) << "n = " << n << ", i = " << i;
+        }
+
+        ASSERT_EQ(a, ring.Interpolate(xs, values)) << "n = " << n;
+    }
+
+    // 次数が点の数より大きい多項式
+    std::vector<ll> a = RandomSequence(300, 9, kMod);
+    std::vector<ll> xs { 0, 1, 2, kMod - 1 };
+    std::vector<ll> values = ring.Evaluate(a, xs);
+    ASSERT_EQ(a[0], values[0]);
+    ll sum = 0;
+    for (ll c : a) {
+        sum = (sum + c) % kMod;
+    }
+    ASSERT_EQ(sum, values[1]);
+
+    ASSERT_THROW(ring.Interpolate({ 1, 2, 1 }, { 1, 2, 3 }), std::invalid_argument);
+    ASSERT_THROW(ring.Interpolate({ 1, 2 }, { 1 }), std::invalid_argument);
+}
+
+} // namespace ntt
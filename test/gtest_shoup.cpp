@@ -0,0 +1,34 @@
+/**
+ * @file gtest_shoup.cpp
+ * @brief Shoup の方法による剰余乗算のテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/shoup.hpp"
+#include "include/util.hpp"
+#include "test/test_util.hpp"
+
+namespace ntt {
+
+/*
+ * 結果が w y mod p と合同で，それぞれの関数の値域 [0, 2p), [0, p) に収まることを確認する．
+ */
+TEST(ShoupTest, MultShoup) {
+    for (ll p : { 337LL, 998244353LL, 2013265921LL }) {
+        TestRandom random(p);
+        for (int i = 0; i < 1000; i++) {
+            ll w = random.Next() % p;
+            ll y = random.Next() % (1LL << 32);
+            std::uint64_t w_shoup = ShoupQuotient(w, p);
+            ll expected = Utility::MulMod(w, y % p, p);
+
+            std::uint64_t lazy = MultShoupLazy(y, w, w_shoup, p);
+            ASSERT_LT(lazy, static_cast<std::uint64_t>(2 * p));
+            ASSERT_EQ(expected, static_cast<ll>(lazy % p));
+            ASSERT_EQ(expected, static_cast<ll>(MultShoupReduced(y, w, w_shoup, p)));
+        }
+        ASSERT_EQ(1, static_cast<ll>(MultShoupReduced(p - 1, p - 1, ShoupQuotient(p - 1, p), p)));
+    }
+}
+
+} // namespace ntt
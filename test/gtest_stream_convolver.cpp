@@ -0,0 +1,97 @@
+/**
+ * @file gtest_stream_convolver.cpp
+ * @brief 区切った数列の畳み込みのテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/stream_convolver.hpp"
+#include "include/thread_pool.hpp"
+#include "test/test_util.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace ntt {
+
+/**
+ * 区切った数列の畳み込みのテストクラス．
+ */
+class StreamConvolverTest : public ::testing::Test {
+protected:
+    /** モジュラス */
+    const ll kMod = 998244353;
+};
+
+/*
+ * 入力を不揃いな長さで与えても，出力が入力全体とカーネルの畳み込みに一致することを
+ * overlap-add と overlap-save のそれぞれで確認する．
+ */
+TEST_F(StreamConvolverTest, Convolution) {
+    using Method = StreamConvolver::Method;
+    NttHarvey ntt(kMod, 64);
+    ThreadPool pool(2);
+
+    for (Method method : { Method::kOverlapAdd, Method::kOverlapSave }) {
+        for (ll len_kernel : { 1LL, 5LL, 33LL, 64LL }) {
+            std::vector<ll> kernel = RandomSequence(len_kernel, len_kernel, kMod);
+            StreamConvolver convolver(ntt, kernel.data(), len_kernel, method);
+            ASSERT_EQ(64 - len_kernel + 1, convolver.BlockSize());
+
+            for (ThreadPool *p : { static_cast<ThreadPool *>(nullptr), &pool }) {
+                convolver.SetThreadPool(p);
+                for (ll len : { 1LL, 31LL, 200LL, 1000LL }) {
+                    std::vector<ll> x = RandomSequence(len, len + 1, kMod);
+                    std::vector<ll> out;
+                    ll pushed = 0;
+                    ll written = 0;
+                    for (ll chunk = 1; pushed < len; chunk = chunk * 3 + 1) {
+                        ll take = std::min(chunk, len - pushed);
+                        written += convolver.Push(x.data() + pushed, take, &out);
+                        pushed += take;
+                        ASSERT_LE(static_cast<ll>(out.size()), pushed);
+                    }
+                    written += convolver.Flush(&out);
+
+                    ASSERT_EQ(static_cast<ll>(out.size()), written);
+                    ASSERT_EQ(NaiveConvolution(x, kernel, kMod), out)
+                        << "len_kernel = " << len_kernel << ", len = " << len;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Reset で途中の入力が捨てられ，空の入力列では何も出力しないことを確認する．
+ */
+TEST_F(StreamConvolverTest, Reset) {
+    NttHarvey ntt(kMod, 32);
+    std::vector<ll> kernel = RandomSequence(8, 1, kMod);
+    StreamConvolver convolver(ntt, kernel.data(), 8);
+
+    std::vector<ll> out;
+    ASSERT_EQ(0, convolver.Flush(&out));
+    ASSERT_TRUE(out.empty());
+
+    std::vector<ll> garbage = RandomSequence(100, 2, kMod);
+    convolver.Push(garbage.data(), 100, &out);
+    convolver.Reset();
+    out.clear();
+
+    std::vector<ll> x = RandomSequence(50, 3, kMod);
+    convolver.Push(x.data(), 50, &out);
+    convolver.Flush(&out);
+    ASSERT_EQ(NaiveConvolution(x, kernel, kMod), out);
+}
+
+/*
+ * 扱えないカーネルの長さを指定すると例外が送出されることを確認する．
+ */
+TEST_F(StreamConvolverTest, InvalidArgument) {
+    NttHarvey ntt(kMod, 16);
+    std::vector<ll> kernel(17, 1);
+    ASSERT_THROW(StreamConvolver(ntt, kernel.data(), 0), std::invalid_argument);
+    ASSERT_THROW(StreamConvolver(ntt, kernel.data(), 17), std::invalid_argument);
+}
+
+} // namespace ntt
@@ -0,0 +1,74 @@
+/**
+ * @file gtest_util.cpp
+ * @brief ユーティリティクラスのテストファイル．
+ */
+
+#include "gtest/gtest.h"
+#include "include/util.hpp"
+
+namespace ntt {
+
+/*
+ * 逆数が正しく計算できることを確認する．
+ */
+TEST(UtilityTest, InvMod) {
+    for (ll n : { 337LL, 19529729LL, 998244353LL }) {
+        for (ll x = 1; x < 1000 && x < n; x++) {
+            ASSERT_EQ(1, (x * Utility::InvMod(x, n)) % n);
+        }
+    }
+
+    ll n = 4179340454199820289LL;
+    for (ll x : { 2LL, 3LL, 123456789012345LL, n - 1 }) {
+        ASSERT_EQ(1, Utility::MulMod(x, Utility::InvMod(x, n), n));
+    }
+}
+
+/*
+ * 64 ビットのモジュラスに対する積とべき乗が正しく計算できることを確認する．
+ */
+TEST(UtilityTest, MulMod) {
+    ll n = 4179340454199820289LL;
+    ASSERT_EQ(1, Utility::MulMod(n - 1, n - 1, n));
+    ASSERT_EQ(n - 2, Utility::MulMod(n - 1, 2, n));
+    ASSERT_EQ(1, Utility::PowMod(3, n - 1, n));
+    ASSERT_EQ(3, Utility::PrimitiveRoot(n));
+}
+
+/*
+ * 素数の判定が正しく行えることを確認する．
+ */
+TEST(UtilityTest, IsPrime) {
+    ASSERT_FALSE(Utility::IsPrime(0));
+    ASSERT_FALSE(Utility::IsPrime(1));
+    ASSERT_TRUE(Utility::IsPrime(2));
+    ASSERT_TRUE(Utility::IsPrime(37));
+    ASSERT_FALSE(Utility::IsPrime(561));
+    ASSERT_TRUE(Utility::IsPrime(998244353));
+    ASSERT_FALSE(Utility::IsPrime(998244353LL * 3));
+    ASSERT_TRUE(Utility::IsPrime(4179340454199820289LL));
+    ASSERT_FALSE(Utility::IsPrime(3215031751LL));
+    ASSERT_FALSE(Utility::IsPrime(4611686018427387905LL));
+}
+
+/*
+ * 原始根が正しく計算できることを確認する．
+ */
+TEST(UtilityTest, PrimitiveRoot) {
+    ASSERT_EQ(10, Utility::PrimitiveRoot(337));
+    ASSERT_EQ(3, Utility::PrimitiveRoot(998244353));
+    ASSERT_EQ(3, Utility::PrimitiveRoot(167772161));
+    ASSERT_EQ(3, Utility::PrimitiveRoot(469762049));
+}
+
+/*
+ * 2 の何乗以下かが正しく計算できることを確認する．
+ */
+TEST(UtilityTest, Log2) {
+    ASSERT_EQ(0, Utility::Log2(1));
+    ASSERT_EQ(3, Utility::Log2(8));
+    ASSERT_EQ(3, Utility::Log2(15));
+    ASSERT_EQ(17, Utility::Log2(131072));
+}
+
+} // namespace ntt
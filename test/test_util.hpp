@@ -0,0 +1,132 @@
+/**
+ * @file test_util.hpp
+ * @brief テストで共通に用いる関数を定義するヘッダファイル．
+ */
+
+#ifndef FFT_TEST_TEST_UTIL_HPP_
+#define FFT_TEST_TEST_UTIL_HPP_
+
+#include "include/util.hpp"
+#include <cstdint>
+#include <vector>
+
+/*
+ * Number theoretic transform 向け名前空間
+ */
+namespace ntt {
+
+/** 64ビット整数型 */
+using ll = long long int;
+
+/** 32ビット符号なし整数型 */
+using u32 = std::uint32_t;
+
+/**
+ * テスト用の擬似乱数列を生成するクラス (64 ビットの線形合同法)．
+ */
+class TestRandom {
+
+public:
+    /**
+     * コンストラクタ．
+     *
+     * @param [in] seed 系列を決める値
+     */
+    explicit TestRandom(ll seed) : x_(static_cast<std::uint64_t>(seed)) {}
+
+    /**
+     * 次の値を返す．
+     *
+     * @return std::uint64_t 値
+     */
+    std::uint64_t Next() {
+        x_ = x_ * 6364136223846793005ULL + 1442695040888963407ULL;
+        return x_;
+    }
+
+private:
+    /** 状態 */
+    std::uint64_t x_;
+};
+
+/**
+ * [0, max) の値をもつ長さ n の数列を作成して返す．
+ *
+ * @param [in] n 数列の長さ
+ * @param [in] seed 係数を決める値
+ * @param [in] max 係数の上限 (モジュラスなど)
+ * @return std::vector<ll> 数列
+ */
+inline std::vector<ll> RandomSequence(ll n, ll seed, ll max) {
+    TestRandom random(seed);
+    std::vector<ll> a(n);
+    for (ll i = 0; i < n; i++) {
+        a[i] = static_cast<ll>(random.Next() >> 20) % max;
+    }
+    return a;
+}
+
+/**
+ * 32 ビットの値をもつ長さ n の数列を作成して返す．
+ *
+ * @param [in] n 数列の長さ
+ * @param [in] seed 値を決める値
+ * @return std::vector<u32> 数列
+ */
+inline std::vector<u32> RandomLimbs(ll n, ll seed) {
+    TestRandom random(seed);
+    std::vector<u32> a(n);
+    for (ll i = 0; i < n; i++) {
+        a[i] = static_cast<u32>(random.Next() >> 32);
+    }
+    return a;
+}
+
+/**
+ * 数列の畳み込みを mod で素朴に計算して返す．
+ *
+ * @param [in] a 数列
+ * @param [in] b 数列
+ * @param [in] mod モジュラス
+ * @return std::vector<ll> 数列 a と b の畳み込み (長さ a.size() + b.size() - 1．いずれかが空なら空)
+ */
+inline std::vector<ll> NaiveConvolution(const std::vector<ll>& a, const std::vector<ll>& b,
+                                        ll mod) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    std::vector<ll> c(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); i++) {
+        ll x = a[i] % mod;
+        if (x == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < b.size(); j++) {
+            c[i + j] = (c[i + j] + Utility::MulMod(x, b[j] % mod, mod)) % mod;
+        }
+    }
+    return c;
+}
+
+/**
+ * 同じ長さ n の数列の巡回畳み込みを mod で素朴に計算して返す．
+ *
+ * @param [in] a 数列
+ * @param [in] b 数列
+ * @param [in] mod モジュラス
+ * @return std::vector<ll> 数列 a と b の巡回畳み込み (長さ n)
+ */
+inline std::vector<ll> NaiveCyclicConvolution(const std::vector<ll>& a, const std::vector<ll>& b,
+                                              ll mod) {
+    std::vector<ll> linear = NaiveConvolution(a, b, mod);
+    std::vector<ll> c(a.size(), 0);
+    for (size_t k = 0; k < linear.size(); k++) {
+        size_t i = k % c.size();
+        c[i] = (c[i] + linear[k]) % mod;
+    }
+    return c;
+}
+
+} // namespace ntt
+
+#endif // #ifndef FFT_TEST_TEST_UTIL_HPP_